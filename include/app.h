@@ -9,11 +9,12 @@ bool app_init(const Params *params);
 // Initializes platform first, then render. Returns false if initialization fails.
 
 void app_frame(void);
-// Executes one iteration of the main loop: pump input, run fixed-step sim,
-// render, and swap buffers.
+// Executes one iteration of the main loop: pump input, send commands to the
+// sim thread, render its latest published frame, and swap buffers.
 
 void app_shutdown(void);
-// Shuts down render before platform; safe to call once after app_init.
+// Stops the sim thread, then shuts down render before platform; safe to call
+// once after app_init.
 
 bool app_should_quit(void);
 // Returns true after the user has requested exit via input.
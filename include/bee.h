@@ -99,7 +99,23 @@ typedef struct BeeDecisionOutput {
     int32_t target_id;
 } BeeDecisionOutput;
 
-BeeRole bee_pick_role(float age_days, uint64_t *rng_state);
+// Decision thresholds shared by bee_decide_next_action and the sim's per-mode
+// fast paths.
+#define BEE_ENERGY_LOW 0.28f
+#define BEE_ENERGY_HIGH 0.82f
+#define BEE_LOAD_FULL_RATIO 0.95f
+#define BEE_LOAD_EMPTY_RATIO 0.05f
+#define BEE_MIN_REST_SEC 2.0f
+#define BEE_MIN_FORAGE_SEC 2.0f
+#define BEE_MAX_FORAGE_SEC 30.0f
+
+BeeRole bee_pick_role(float age_days, float roll01);
+
+bool bee_keeps_resting(uint8_t role, float energy, float state_time, bool patch_valid);
+// True when an empty bee resting inside the hive stays at rest this tick.
+
+bool bee_keeps_harvesting(float energy, float load_ratio, float patch_stock, float patch_capacity, float state_time);
+// True when a bee harvesting outside the hive keeps harvesting this tick.
 
 void bee_decide_next_action(const BeeDecisionContext *ctx, BeeDecisionOutput *out);
 
@@ -7,20 +7,19 @@
 
 #include "params.h"
 #include "tile_core.h"
+#include "tile_types.h"
 
 typedef TileTerrain HexTerrain;
 
 struct FlowerSystem;
 struct HiveSystem;
+struct SnapshotWriter;
+struct SnapshotReader;
 
+// Cold per-tile configuration. The nectar and flower fields read every tick
+// live in HexWorld's column arrays; hex_world_tile_debug_info gathers both.
 typedef struct HexTile {
     HexTerrain terrain;
-    float nectar_stock;
-    float nectar_capacity;
-    float nectar_recharge_rate;
-    float nectar_recharge_multiplier;
-    float flower_quality;
-    float flower_viscosity;
     int16_t patch_id;
     float flow_capacity;
     uint16_t flower_archetype_id;
@@ -56,6 +55,23 @@ typedef struct HexTileDebugInfo {
     bool hive_allows_deposit;
 } HexTileDebugInfo;
 
+// One bee's claim on a tile for the current tick. Request lists passed to the
+// *_resolve functions must be grouped so equal tile_index values are adjacent.
+typedef struct HexTileRequest {
+    uint32_t tile_index;
+    float amount_uL;
+} HexTileRequest;
+
+// Per-tile predicate bits, one byte per tile in HexWorld.tile_flags, so hot
+// loops test terrain without touching the HexTile records.
+#define HEX_TILE_FLAG_PASSABLE 0x01u
+#define HEX_TILE_FLAG_HIVE 0x02u     // hive interior, storage or entrance
+#define HEX_TILE_FLAG_FLORAL 0x04u   // flowers with nectar capacity
+#define HEX_TILE_FLAG_DEPOSIT 0x08u  // accepts nectar deposits
+
+// Stock above which a floral tile counts as available to foragers.
+#define HEX_FLORAL_AVAILABLE_UL 0.5f
+
 typedef struct HexWorld {
     float origin_x;
     float origin_y;
@@ -70,18 +86,37 @@ typedef struct HexWorld {
     int height;
     size_t tile_count;
     HexTile *tiles;
+    // Hot per-tile columns, indexed like tiles[]. Views of the FlowerSystem
+    // columns, which own the storage.
+    float *nectar_stock;
+    float *nectar_capacity;
+    float *nectar_recharge_rate;
+    float *nectar_recharge_multiplier;
+    float *flower_quality;
+    float *flower_viscosity;
     float *centers_world_xy;
     uint32_t *fill_rgba;
+    uint8_t *tile_flags;  // HEX_TILE_FLAG_* per tile, derived from tiles[]
     uint32_t palette[HEX_TERRAIN_COUNT];
     TileRegistry tile_registry;
     struct FlowerSystem *flower_system;
     struct HiveSystem *hive_system;
+    size_t floral_available_count;
+    size_t floral_available_by_archetype[TILE_FLOWER_ARCHETYPE_COUNT];
 } HexWorld;
 
 bool hex_world_init(HexWorld *world, const Params *params);
 bool hex_world_rebuild(HexWorld *world, const Params *params);
 void hex_world_shutdown(HexWorld *world);
 
+bool hex_world_snapshot_write(const HexWorld *world, struct SnapshotWriter *writer);
+// Writes the grid, tile records and columns, flower system and hive storage
+// as checkpoint columns.
+bool hex_world_snapshot_read(HexWorld *world, const struct SnapshotReader *reader);
+// Counterpart of hex_world_init for a checkpoint: fills an uninitialized world
+// with copies of the hex_world_snapshot_write columns. Returns false, leaving
+// *world untouched, if the checkpoint holds no valid world.
+
 float hex_world_cell_radius(const HexWorld *world);
 size_t hex_world_tile_count(const HexWorld *world);
 const float *hex_world_centers_xy(const HexWorld *world);
@@ -91,6 +126,8 @@ bool hex_world_in_bounds(const HexWorld *world, int q, int r);
 size_t hex_world_index(const HexWorld *world, int q, int r);
 bool hex_world_index_to_axial(const HexWorld *world, size_t index, int *out_q, int *out_r);
 bool hex_world_tile_debug_info(const HexWorld *world, size_t index, HexTileDebugInfo *out_info);
+// Gathers a tile's cold record and hot columns into one struct for debug and UI
+// code.
 
 void hex_world_axial_to_world(const HexWorld *world, int q, int r, float *out_x, float *out_y);
 void hex_world_world_to_axial(const HexWorld *world, float world_x, float world_y, float *out_q,
@@ -102,6 +139,13 @@ void hex_world_tile_corners(const HexWorld *world, int q, int r, float (*out_xy)
 bool hex_world_tile_from_world(const HexWorld *world, float world_x, float world_y, size_t *out_index);
 bool hex_world_tile_is_floral(const HexWorld *world, size_t index);
 float hex_world_tile_harvest(HexWorld *world, size_t index, float request_uL, float *quality_out);
+// Resolves grouped harvest requests with one stock update per tile. When a
+// tile cannot cover every claim, its stock is split in proportion to the
+// requests. out_granted_uL[k] receives the amount granted to requests[k].
+void hex_world_tile_harvest_resolve(HexWorld *world,
+                                    const HexTileRequest *requests,
+                                    size_t request_count,
+                                    float *out_granted_uL);
 void hex_world_tile_set_floral(HexWorld *world,
                                size_t index,
                                float capacity,
@@ -111,15 +155,54 @@ void hex_world_tile_set_floral(HexWorld *world,
                                float viscosity);
 void hex_world_apply_palette(HexWorld *world, bool nectar_heatmap_enabled);
 
+float hex_world_tile_nectar_stock(const HexWorld *world, size_t index);
+// Current nectar stock. Read stock through this rather than nectar_stock[],
+// which under lazy recharge holds the stock as of the tile's last update.
+
+bool hex_world_nectar_lazy(const HexWorld *world);
+// True while the flower system recharges lazily (tile_flower_set_lazy).
+
+bool hex_world_tile_floral_available(const HexWorld *world, size_t index);
+// True for flower tiles with capacity whose stock exceeds
+// HEX_FLORAL_AVAILABLE_UL.
+
+void hex_world_floral_note_update(HexWorld *world, size_t index, bool was_available);
+// Keeps the availability counters in step with a tile written outside the
+// hex_world_tile_* functions. Pass the tile's availability from before the
+// write; the counters change only when it crossed the threshold.
+
+size_t hex_world_floral_available_count(const HexWorld *world);
+// Number of available floral tiles; O(1).
+
+size_t hex_world_floral_available_count_archetype(const HexWorld *world, uint16_t archetype_id);
+// Available floral tiles of one flower archetype; 0 for unknown ids.
+
+uint8_t hex_world_tile_flags(const HexWorld *world, size_t index);
+// HEX_TILE_FLAG_* bits of the tile; 0 out of range.
+
+void hex_world_tile_refresh_flags(HexWorld *world, size_t index);
+// Re-derives the tile's flag byte. Call after changing its terrain, nectar
+// capacity, passability or deposit setting outside the hex_world_* functions.
+
+bool hex_world_tile_in_hive(const HexWorld *world, size_t index);
 bool hex_world_tile_passable(const HexWorld *world, size_t index);
 bool hex_world_tile_allows_deposit(const HexWorld *world, size_t index);
 float hex_world_hive_deposit_at_tile(HexWorld *world, size_t index, float request_uL);
 float hex_world_hive_deposit_world(HexWorld *world, float world_x, float world_y, float request_uL);
+// Deposit counterpart of hex_world_tile_harvest_resolve: free storage space is
+// shared proportionally, and each storage payload and the hive honey total
+// are written once. Returns the total accepted.
+float hex_world_hive_deposit_resolve(HexWorld *world,
+                                     const HexTileRequest *requests,
+                                     size_t request_count,
+                                     float *out_accepted_uL);
 float hex_world_hive_total_honey(const HexWorld *world);
 float hex_world_hive_total_pollen(const HexWorld *world);
 bool hex_world_hive_exists(const HexWorld *world);
 bool hex_world_hive_enabled(const HexWorld *world);
 bool hex_world_hive_center(const HexWorld *world, float *out_x, float *out_y);
+bool hex_world_hive_bounds(const HexWorld *world, float *out_x, float *out_y, float *out_radius);
+// Circle containing every hive tile, walls included. False without a hive.
 bool hex_world_hive_preferred_unload(const HexWorld *world, float *out_x, float *out_y);
 bool hex_world_hive_preferred_entrance(const HexWorld *world, float *out_x, float *out_y);
 
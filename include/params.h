@@ -28,6 +28,8 @@ typedef struct Params {
     float world_width_px;
     float world_height_px;
     float sim_fixed_dt;
+    size_t sim_worker_count;  // threads used by sim_tick, including the caller (>= 1)
+    bool sim_compact_state;   // 16-bit energy/load, derived heading/radius/color, no capacity columns
     float motion_min_speed;
     float motion_max_speed;
     float motion_jitter_deg_per_sec;
@@ -27,6 +27,11 @@ typedef struct Input {
     bool key_s_down;
     bool key_d_down;
     bool key_reset_pressed;
+    bool key_save_pressed;  // F5: write the quicksave checkpoint
+    bool key_load_pressed;  // F9: restore it
+    bool key_comma_pressed;  // step one tick back while paused
+    bool key_slower_pressed;  // '[': lower the fast-forward multiple
+    bool key_faster_pressed;  // ']': raise it
     float mouse_x_px;
     float mouse_y_px;
     float mouse_dx_px;
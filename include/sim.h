@@ -11,6 +11,14 @@
 #include "render.h"
 
 typedef struct SimState SimState;
+struct SimJournal;
+
+typedef enum SimKinematicsKernel {
+    SIM_KINEMATICS_AUTO = 0,  // widest kernel the CPU supports
+    SIM_KINEMATICS_SCALAR,    // reference implementation
+    SIM_KINEMATICS_SSE2,
+    SIM_KINEMATICS_AVX2,
+} SimKinematicsKernel;
 
 typedef struct SimInit {
     const Params *params;      // Optional external params pointer.
@@ -25,7 +33,149 @@ void sim_bind_hex_world(SimState *state, HexWorld *world);
 // Binds the current hex world to the simulation and rebuilds floral indices.
 
 void sim_tick(SimState *state, float dt_sec);
-// Advances the simulation by dt_sec seconds. No allocations occur here.
+// Advances the simulation by dt_sec seconds. No allocations occur here. Bees
+// are processed in fixed-size chunks across the worker pool; results are
+// bit-identical for a given seed regardless of the worker count.
+
+bool sim_set_worker_count(SimState *state, size_t worker_count);
+// Resizes the tick worker pool (1 = run on the calling thread only). Returns
+// false and keeps the current pool if the new threads cannot be started.
+
+bool sim_set_kinematics_kernel(SimState *state, SimKinematicsKernel kernel);
+// Selects the kinematics kernel used by sim_tick. Returns false (and falls back
+// to the scalar reference) when the CPU cannot run the requested kernel. All
+// kernels produce bit-identical results.
+
+void sim_set_mode_buckets(SimState *state, bool enabled);
+// Enables (default) or disables the per-mode fast paths of sim_tick. Bees in a
+// steady IDLE, FORAGING or UNLOADING state skip the generic decision and path
+// code; results are bit-identical either way. Disabling also wakes every
+// hibernating bee.
+
+void sim_set_hibernation(SimState *state, bool enabled);
+// Enables (default) or disables hibernation: a bee that settles into REST in
+// the hive is parked and costs nothing per tick. Its energy recovery, state
+// time and age advance in closed form, and a timer wheel wakes it at the
+// earliest tick its decision could change (never, for roles that do not
+// forage, until params or the world change). The closed form rounds
+// differently from per-tick accumulation, so hashes differ from a run with
+// hibernation disabled, but stay identical across thread counts and kernels.
+
+void sim_set_lazy_recharge(SimState *state, bool enabled);
+// Enables or disables (default) lazy nectar recharge. Instead of recharging
+// every floral tile each tick, a tile's stock is evaluated when read from its
+// last update time and the closed-form integral of the day/night multiplier,
+// so a tick costs O(touched tiles). Integrating the exact day/night steps
+// rounds differently from per-tick accumulation, so hashes differ from an
+// eager run. Applies to the bound world and to worlds bound later.
+
+void sim_set_multi_rate(SimState *state, bool enabled);
+// Enables or disables (default) multi-rate integration. Flight stays per
+// tick, but a motionless FORAGING or UNLOADING bee is advanced every 4th tick
+// and a motionless IDLE one every 8th, in one step covering the time skipped
+// since its last update, so harvest and deposit requests and energy, state
+// time and age keep their totals. Phases are staggered by bee index so each
+// tick advances an even share. Such a bee reacts up to 7 ticks late and its
+// values trail sim time by as much between updates. Needs the mode fast
+// paths; hashes differ from a single-rate run.
+
+void sim_set_detail_region(SimState *state, float min_x, float min_y, float max_x, float max_y);
+// Sets the world rectangle that keeps full fidelity, typically the camera
+// view; level of detail is off (everything full fidelity) until it is set.
+// A flying bee more than three hex cell radii outside it steers
+// straight at its target, with no path planning and no heading jitter,
+// whenever that leg provably misses the hive walls. Coarse flight is slowed
+// to the mean forward progress of jittered flight and charged the energy of
+// full speed, so flight times, harvests and energy use stay unbiased. Bees
+// keep one representation at both levels, so moving the region promotes and
+// demotes them seamlessly. Hashes then depend on the region.
+
+void sim_clear_detail_region(SimState *state);
+// Turns level of detail off again.
+
+void sim_set_caste_pools(SimState *state, bool enabled);
+// Enables or disables (default) caste pools. A nurse, housekeeper or storage
+// bee that parks for good in the hive leaves its slot and is counted in a
+// pool per role and age in whole days, so tick cost follows the bees that can
+// still act rather than the colony size. Cohorts age a day at a time and take
+// up the in-hive role of their new age; at 18 days a bee draws its outside
+// role (bee_pick_role) and is materialized resting at the unload point, as is
+// one taken out by sim_unpool_bee. Bees stored in slots keep the role they
+// were given. Pooled bees have no position, energy or timers of their own and
+// their ages are rounded to whole days. Bees only enter a pool by parking, so
+// pooling needs hibernation. Disabling materializes every pooled bee. Hashes
+// differ from a run without pools.
+
+size_t sim_unpool_bee(SimState *state);
+// Materializes one pooled bee, drawn at random in proportion to the cohorts,
+// resting at the unload point. Returns its index, or SIZE_MAX when the pools
+// are empty or capacity could not grow.
+
+bool sim_set_inspection(SimState *state, bool enabled);
+// Enables (default) or disables the debug-only per-bee columns (the current
+// path waypoint reported by sim_get_bee_info). Without them the waypoint is
+// reported as the path target. Returns false if the columns cannot be
+// allocated. Does not affect the simulation or its hash.
+
+size_t sim_bee_state_bytes(const SimState *state);
+// Returns the bytes allocated per bee of capacity: every bee column including
+// per-tick scratch, the spatial grid, the wake timer entry and, once built,
+// the compact render view. Params.sim_compact_state selects the compact
+// layout: energy and load in 16-bit fixed point with stochastic rounding, no
+// per-bee capacity or harvest-rate columns, and no heading, radius or color
+// columns (heading follows velocity; radius and color are derived from role
+// and mode when the render view is built). Compact runs are
+// deterministic but hash differently from full-precision runs.
+
+// Population: bees live in slots [0, count). A despawned bee leaves a dead
+// slot that the tick skips and the next spawn reuses; every
+// SIM_COMPACT_INTERVAL_TICKS ticks (and on sim_compact) the live bees are moved
+// down, in order, to close the gaps. Capacity doubles when a spawn finds no
+// free slot, keeping every column.
+
+size_t sim_spawn_bee(SimState *state, BeeRole role, float x, float y);
+// Adds a newborn (age 0) bee resting at (x, y). Returns its index, or SIZE_MAX
+// if capacity could not grow. Neighbour queries see it after the next tick.
+
+bool sim_despawn_bee(SimState *state, size_t index);
+// Removes a live bee; false if index is out of range or already dead.
+
+bool sim_set_population(SimState *state, size_t live_count);
+// Spawns newborns at the unload point or despawns the newest bees (never the
+// queen in slot 0) until live_count bees are alive, then compacts after a
+// shrink. Pooled bees count as alive and are removed first, youngest cohort
+// first. Returns false on invalid arguments or allocation failure.
+
+size_t sim_compact(SimState *state);
+// Closes the gaps left by dead slots now and returns how many were reclaimed.
+// Bee indices change; see sim_compacted_index.
+
+size_t sim_live_count(const SimState *state);
+// Returns the number of bees in slots; pooled bees are not included.
+
+size_t sim_pooled_count(const SimState *state);
+// Returns the number of bees held in caste pools.
+
+uint64_t sim_compaction_epoch(const SimState *state);
+// Number of compactions so far; indices held across a change must be remapped.
+
+size_t sim_compacted_index(const SimState *state, size_t index, uint64_t epoch);
+// Maps an index taken at the given epoch to the current one. Returns SIZE_MAX
+// if the bee has died or more than one compaction has happened since.
+
+size_t sim_parked_count(const SimState *state);
+// Returns the number of bees currently hibernating.
+
+uint64_t sim_tick_index(const SimState *state);
+// Returns the number of ticks simulated since sim_init (or the checkpoint's
+// count after sim_snapshot_load).
+
+SimKinematicsKernel sim_get_kinematics_kernel(const SimState *state);
+const char *sim_kinematics_kernel_name(SimKinematicsKernel kernel);
+
+uint64_t sim_state_hash(const SimState *state);
+// Returns a 64-bit FNV-1a digest of the per-bee state, the hive honey total
+// and every tile's nectar stock, for determinism checks.
 
 RenderView sim_build_view(SimState *state);
 // Builds a renderable view over the simulation buffers. Updates cached
@@ -39,11 +189,72 @@ void sim_apply_runtime_params(SimState *state, const Params *params);
 // Updates motion-related tunables in-place without reallocating or
 // reseeding. Positions and velocities are clamped to remain valid.
 
+void sim_set_journal(SimState *state, struct SimJournal *journal);
+// Attaches a journal (see sim_journal.h) that records every call that changes
+// the simulation from outside, and the ticks between them; null detaches. The
+// state does not own it.
+
 void sim_shutdown(SimState *state);
 // Frees all simulation resources; safe to call on null.
 
+bool sim_snapshot_save(const SimState *state, const char *path);
+// Writes a versioned binary checkpoint of every persistent bee column, the
+// simulation clocks and counters, and the bound hex world (tiles, flower
+// system, hive storage). Returns false on I/O failure or when no world is
+// bound; a partial file is removed.
+
+bool sim_snapshot_load(SimState **out_state, HexWorld *out_world, const Params *params, const char *path);
+// Restores a checkpoint into a new state and an uninitialized world, bound to
+// each other. The bee columns are mapped from the file copy-on-write rather
+// than read, so loading costs little beyond the world and is paged in as the
+// tick touches it. Ticking the restored state produces the same hashes as the
+// saved one would have. Only params->sim_worker_count is used; every
+// simulation setting comes from the checkpoint. Returns false, leaving both
+// outputs untouched, on I/O failure or a version mismatch.
+
 size_t sim_find_bee_near(const SimState *state, float world_x, float world_y, float radius_world);
 // Returns the index of the closest bee within radius_world (inclusive), or SIZE_MAX when none.
+// Equal distances go to the lower index.
+
+size_t sim_pick_bee(SimState *state, float world_x, float world_y, float radius_world);
+// sim_find_bee_near for inspection: when no bee is in reach of a point inside
+// the hive, a pooled bee is materialized (sim_unpool_bee) and returned.
+
+// Neighbour queries run over a uniform grid of bee positions, so their cost
+// follows local density rather than the bee count. The tick does not maintain
+// the grid: the first query after the bees moved rebuilds it, which is also
+// why queries on one state must not run concurrently. Indices stay valid
+// until the next sim_tick or sim_reset.
+
+size_t sim_query_radius(const SimState *state,
+                        float world_x,
+                        float world_y,
+                        float radius_world,
+                        size_t *out_indices,
+                        size_t max_out);
+// Finds the bees whose center lies within radius_world (inclusive). Returns
+// the number found; only the first max_out indices are written.
+
+size_t sim_query_rect(const SimState *state,
+                      float min_x,
+                      float min_y,
+                      float max_x,
+                      float max_y,
+                      size_t *out_indices,
+                      size_t max_out);
+// Finds the bees whose center lies inside the closed rectangle. Returns the
+// number found; only the first max_out indices are written.
+
+size_t sim_query_nearest(const SimState *state,
+                         float world_x,
+                         float world_y,
+                         float max_radius_world,
+                         size_t k,
+                         size_t *out_indices,
+                         float *out_dist_sq);
+// Writes the up to k bees closest to the point within max_radius_world (pass
+// INFINITY for no limit), nearest first, with their squared distances to
+// out_dist_sq. Returns the number written.
 
 bool sim_get_bee_info(const SimState *state, size_t index, BeeDebugInfo *out_info);
 // Populates BeeDebugInfo for the given index; returns false if out of range.
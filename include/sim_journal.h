@@ -0,0 +1,136 @@
+#ifndef SIM_JOURNAL_H
+#define SIM_JOURNAL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bee.h"
+#include "params.h"
+#include "sim.h"
+
+// Append-only log of everything applied to a simulation from outside: the
+// params or checkpoint it started from, runtime param changes, resets,
+// population and option changes, hex rebuilds and the ticks between them
+// (run-length coded), each stamped with the state's tick count when it
+// happened. Since sim_tick is deterministic, replaying the journal reproduces
+// the run exactly; a state hash written every hash_interval ticks locates the
+// first tick where a replay diverges.
+//
+// Calls on a state with a journal attached (sim_set_journal) are recorded by
+// the simulation itself. Events the simulation cannot see (the initial params,
+// a loaded checkpoint, a reinit, a hex rebuild, pause/step, rewinds) are
+// recorded by the caller with the sim_journal_note_* functions.
+//
+// A rewind is recorded as the ring's configuration, whenever the caller
+// (re)starts its ring, and the target tick of each seek. Replay keeps a ring
+// of its own with that configuration, captured after every replayed tick, so
+// it holds the same keyframes and a seek re-simulates from the same one.
+
+typedef struct SimJournal SimJournal;
+
+typedef enum SimJournalEvent {
+    SIM_JOURNAL_INIT = 1,        // Params: hex_world_init + sim_init + bind
+    SIM_JOURNAL_LOAD,            // absolute checkpoint path: sim_snapshot_load, then a HASH
+    SIM_JOURNAL_TICKS,           // tick count and dt
+    SIM_JOURNAL_HASH,            // sim_state_hash at the stamped tick
+    SIM_JOURNAL_APPLY_PARAMS,    // Params: sim_apply_runtime_params
+    SIM_JOURNAL_SET_POPULATION,  // live count
+    SIM_JOURNAL_RESET,           // seed
+    SIM_JOURNAL_REINIT,          // Params: fresh sim_init bound to the current world
+    SIM_JOURNAL_HEX_REBUILD,     // Params: hex_world_rebuild + bind
+    SIM_JOURNAL_SET_OPTION,      // SimJournalOption and its new value
+    SIM_JOURNAL_SPAWN,           // role and position
+    SIM_JOURNAL_DESPAWN,         // bee index
+    SIM_JOURNAL_COMPACT,
+    SIM_JOURNAL_PAUSE,           // informational: no effect on replay
+    SIM_JOURNAL_RESUME,
+    SIM_JOURNAL_STEP,
+    SIM_JOURNAL_END,
+    SIM_JOURNAL_SET_DETAIL_REGION,  // enabled flag and world rectangle
+    SIM_JOURNAL_UNPOOL,             // sim_unpool_bee
+    SIM_JOURNAL_REWIND_RESTART,     // ring configuration: sim_rewind_create/clear + capture
+    SIM_JOURNAL_REWIND_SEEK,        // target tick and dt: sim_rewind_seek
+} SimJournalEvent;
+
+typedef enum SimJournalOption {
+    SIM_JOURNAL_OPTION_MODE_BUCKETS = 0,
+    SIM_JOURNAL_OPTION_HIBERNATION,
+    SIM_JOURNAL_OPTION_LAZY_RECHARGE,
+    SIM_JOURNAL_OPTION_MULTI_RATE,
+    SIM_JOURNAL_OPTION_CASTE_POOLS,
+} SimJournalOption;
+
+#define SIM_JOURNAL_DEFAULT_HASH_INTERVAL 1024u
+
+typedef struct SimReplayReport {
+    uint64_t events;
+    uint64_t ticks;
+    uint64_t hashes_checked;
+    uint64_t hashes_mismatched;
+    uint64_t first_divergence_tick;  // UINT64_MAX when the replay matched
+    uint64_t final_hash;
+} SimReplayReport;
+
+bool sim_journal_open(SimJournal **out_journal, const char *path, uint64_t hash_interval);
+// Creates (truncating) a journal file. hash_interval 0 selects
+// SIM_JOURNAL_DEFAULT_HASH_INTERVAL. Returns false on I/O or allocation
+// failure, leaving *out_journal untouched.
+
+bool sim_journal_close(SimJournal *journal, const SimState *state);
+// Writes the pending tick run, a final hash of state (if given) and an END
+// record, then closes the file and frees the journal; safe to call on null.
+// Returns false if any write failed.
+
+void sim_journal_note(SimJournal *journal, const SimState *state, SimJournalEvent event);
+// Records an event without payload (PAUSE, RESUME, STEP, COMPACT, UNPOOL).
+
+void sim_journal_note_params(SimJournal *journal, const SimState *state, SimJournalEvent event, const Params *params);
+// Records INIT, REINIT, HEX_REBUILD or APPLY_PARAMS with a copy of params.
+// INIT and REINIT are stamped with the new state's tick.
+
+void sim_journal_note_value(SimJournal *journal, const SimState *state, SimJournalEvent event, uint64_t value);
+// Records SET_POPULATION, RESET or DESPAWN.
+
+void sim_journal_note_option(SimJournal *journal, const SimState *state, SimJournalOption option, bool enabled);
+
+void sim_journal_note_spawn(SimJournal *journal, const SimState *state, BeeRole role, float x, float y);
+
+void sim_journal_note_detail_region(SimJournal *journal,
+                                    const SimState *state,
+                                    bool enabled,
+                                    float min_x,
+                                    float min_y,
+                                    float max_x,
+                                    float max_y);
+
+void sim_journal_note_rewind_restart(SimJournal *journal,
+                                    const SimState *state,
+                                    uint64_t interval_ticks,
+                                    size_t max_keyframes,
+                                    size_t max_bytes);
+// Records that the caller's rewind ring, created with these arguments, was
+// cleared and captured state. Call it at the ring's creation and every clear.
+
+void sim_journal_note_rewind_seek(SimJournal *journal, const SimState *state, uint64_t tick, float dt_sec);
+// Records a sim_rewind_seek to tick; call it with the state before the seek,
+// whether or not the seek then succeeds.
+
+void sim_journal_note_load(SimJournal *journal, const SimState *state, const char *path);
+// Records that state was just restored from the checkpoint at path, as an
+// absolute path, followed by the hash of the loaded state. Replay loads the
+// same file and stops if it no longer hashes the same, so callers should give
+// every checkpoint they may load a name of its own rather than overwrite one.
+
+void sim_journal_note_tick(SimJournal *journal, const SimState *state, float dt_sec);
+// Called by sim_tick after each tick; extends the current run and writes a
+// hash every hash_interval ticks.
+
+bool sim_journal_replay(const char *path, size_t worker_count, SimReplayReport *out_report);
+// Re-executes a journal from its INIT or LOAD record as fast as possible,
+// comparing every recorded hash (and event tick) against the replayed state.
+// worker_count 0 keeps the recorded sim_worker_count; results do not depend on
+// it. Returns false if the file cannot be read or is malformed; a divergence
+// is reported through out_report, not the return value.
+
+#endif  // SIM_JOURNAL_H
@@ -0,0 +1,66 @@
+#ifndef SIM_REWIND_H
+#define SIM_REWIND_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "hex.h"
+#include "sim.h"
+
+// Bounded ring of in-memory keyframes for stepping backwards. A keyframe is
+// the same set of columns a checkpoint holds (every persistent bee column,
+// the clocks, the tiles and flower state), taken every interval_ticks ticks.
+// A column that is byte-identical to the one in the previous keyframe is
+// shared instead of copied, so static data (roles, tile layout, palette) is
+// stored once and only what changed costs memory. The oldest keyframes are
+// dropped when the count or byte budget is exceeded.
+//
+// Seeking restores the newest keyframe at or before the target tick and
+// re-simulates forward; since sim_tick is deterministic, the result equals
+// the state the run had at that tick. Anything applied from outside (params,
+// population, reset, a rebuilt world, a loaded checkpoint) is not replayed,
+// so the ring must be cleared when that happens.
+
+typedef struct SimRewind SimRewind;
+
+typedef struct SimRewindStats {
+    size_t keyframes;
+    size_t bytes;          // unique column bytes held
+    size_t shared_bytes;   // bytes saved by sharing unchanged columns
+    uint64_t oldest_tick;  // UINT64_MAX when empty
+    uint64_t newest_tick;
+} SimRewindStats;
+
+bool sim_rewind_create(SimRewind **out_rewind, uint64_t interval_ticks, size_t max_keyframes, size_t max_bytes);
+// Returns false on invalid arguments (interval_ticks or max_keyframes 0) or
+// allocation failure, leaving *out_rewind untouched. max_bytes 0 means no
+// byte budget.
+
+void sim_rewind_destroy(SimRewind *rewind);
+// Frees every keyframe; safe to call on null.
+
+void sim_rewind_clear(SimRewind *rewind);
+// Drops every keyframe. The next capture takes one regardless of the tick.
+
+bool sim_rewind_capture(SimRewind *rewind, const SimState *state);
+// Call after every tick: takes a keyframe when the ring is empty or the tick
+// count is a multiple of interval_ticks (and newer than the last keyframe).
+// Returns false only if a keyframe was due and could not be stored.
+
+bool sim_rewind_seek(SimRewind *rewind,
+                     SimState **state,
+                     HexWorld *world,
+                     uint64_t tick,
+                     float dt_sec,
+                     size_t worker_count);
+// Replaces *state and *world (which must be bound to each other) with the run
+// as it was at tick, re-simulating from the nearest earlier keyframe with
+// ticks of dt_sec. Keyframes after the one used are dropped. Returns false,
+// leaving both untouched, when tick is older than the oldest keyframe or
+// newer than *state, or on allocation failure. The restored state has no
+// journal attached.
+
+void sim_rewind_get_stats(const SimRewind *rewind, SimRewindStats *out_stats);
+
+#endif  // SIM_REWIND_H
@@ -8,6 +8,9 @@
 extern "C" {
 #endif
 
+// Number of built-in flower archetypes; archetype ids run [0, count).
+#define TILE_FLOWER_ARCHETYPE_COUNT 4u
+
 typedef struct FlowerArchetype {
     const char *name;
     float capacity;
@@ -20,16 +23,6 @@ typedef struct FlowerArchetype {
     uint32_t color_rgba;
 } FlowerArchetype;
 
-typedef struct FlowerPayload {
-    uint16_t archetype_id;
-    float capacity;
-    float stock;
-    float recharge_rate;
-    float recharge_multiplier;
-    float quality;
-    float viscosity;
-} FlowerPayload;
-
 #ifdef __cplusplus
 }
 #endif
@@ -16,6 +16,8 @@ typedef struct UiActions {
     bool reset;
     bool reinit_required;
     bool focus_queen;
+    bool speed_down;
+    bool speed_up;
 } UiActions;
 
 void ui_init(void);
@@ -29,6 +31,7 @@ void ui_set_viewport(const RenderCamera *camera, int framebuffer_width, int fram
 void ui_enable_hive_overlay(bool enabled);
 void ui_set_selected_bee(const BeeDebugInfo *info, bool valid);
 void ui_set_selected_hex(const HexTileDebugInfo *info, bool valid);
+void ui_set_sim_speed(float target_multiple, float achieved_multiple, float ticks_per_frame);
 bool ui_hex_grid_enabled(void);
 bool ui_hex_overlay_on_top(void);
 bool ui_hex_heatmap_enabled(void);
@@ -0,0 +1,27 @@
+#ifndef UTIL_JOB_POOL_H
+#define UTIL_JOB_POOL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+typedef struct JobPool JobPool;
+
+typedef void (*JobPoolFn)(void *user_data, size_t job_index);
+
+bool job_pool_create(JobPool **out_pool, size_t worker_count);
+// Creates a pool with worker_count participants (the calling thread counts as
+// one, so worker_count - 1 background threads are started). Returns false on
+// failure, leaving *out_pool untouched.
+
+void job_pool_destroy(JobPool *pool);
+// Joins all background threads and frees the pool; safe to call on null.
+
+size_t job_pool_worker_count(const JobPool *pool);
+// Returns the number of participants, including the calling thread.
+
+void job_pool_run(JobPool *pool, size_t job_count, JobPoolFn fn, void *user_data);
+// Runs fn(user_data, i) for every i in [0, job_count) and blocks until all jobs
+// finish. Jobs are handed out in index order to whichever worker is free; the
+// calling thread participates. A null pool runs every job inline.
+
+#endif  // UTIL_JOB_POOL_H
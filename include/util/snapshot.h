@@ -0,0 +1,78 @@
+#ifndef UTIL_SNAPSHOT_H
+#define UTIL_SNAPSHOT_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Binary checkpoint container: a fixed header, then named columns (each
+// starting on a 64-byte boundary), then a column table. The header records
+// the caller's format version and the byte order; every table entry records
+// the element size and count, so a reader can bind a column in place only
+// when its layout matches exactly.
+//
+// Readers map the file copy-on-write (mmap MAP_PRIVATE, or a FILE_MAP_COPY
+// view on Windows). Columns returned by snapshot_column stay valid and
+// writable until snapshot_reader_close, and pages are only read from disk
+// when first touched. A memory writer builds the same image on the heap and
+// hands it to a reader without touching the disk.
+
+typedef struct SnapshotWriter SnapshotWriter;
+typedef struct SnapshotReader SnapshotReader;
+
+#define SNAPSHOT_NAME_MAX 32u
+#define SNAPSHOT_ALIGN 64u
+
+bool snapshot_writer_open(SnapshotWriter **out_writer, const char *path, uint32_t version);
+// Creates (truncating) path and writes a placeholder header. Returns false on
+// I/O or allocation failure, leaving *out_writer untouched.
+
+bool snapshot_writer_open_memory(SnapshotWriter **out_writer, uint32_t version);
+// Like snapshot_writer_open, but collects the checkpoint in memory; finish it
+// with snapshot_writer_finish_reader.
+
+bool snapshot_write(SnapshotWriter *writer, const char *name, const void *data, size_t elem_size, size_t count);
+// Appends a column of count elements. Names must be unique and shorter than
+// SNAPSHOT_NAME_MAX. A failure is sticky and reported by snapshot_writer_finish.
+
+bool snapshot_writer_finish(SnapshotWriter *writer);
+// Writes the column table and the final header, closes the file and frees the
+// writer. Returns false (and removes the file) if any write failed. A memory
+// writer is discarded and false returned.
+
+bool snapshot_writer_finish_reader(SnapshotWriter *writer, SnapshotReader **out_reader);
+// Completes a memory writer and moves its image into a new reader, which owns
+// it. Frees the writer either way; returns false if any write failed or the
+// writer writes to a file.
+
+bool snapshot_reader_open(SnapshotReader **out_reader, const char *path, uint32_t version);
+// Maps path and validates the header and column table. Returns false on I/O
+// failure, a version or byte order mismatch, or a truncated file.
+
+void *snapshot_column(const SnapshotReader *reader, const char *name, size_t elem_size, size_t *out_count);
+// Returns the column's data inside the mapping and its element count, or NULL
+// when it is missing or was written with a different element size. An empty
+// column returns NULL with *out_count == 0.
+
+size_t snapshot_column_count(const SnapshotReader *reader);
+
+void *snapshot_column_at(const SnapshotReader *reader,
+                         size_t index,
+                         const char **out_name,
+                         size_t *out_elem_size,
+                         size_t *out_count);
+// Enumerates the columns in the order they were written. The name stays valid
+// until snapshot_reader_close.
+
+bool snapshot_read(const SnapshotReader *reader, const char *name, void *out, size_t elem_size, size_t count);
+// Copies a column that must hold exactly count elements of elem_size bytes.
+
+bool snapshot_reader_owns(const SnapshotReader *reader, const void *ptr);
+// True if ptr points into the mapping or image, i.e. must not be passed to
+// free().
+
+void snapshot_reader_close(SnapshotReader *reader);
+// Unmaps the file (or frees the image); safe to call on null. Bound columns
+// become invalid.
+
+#endif  // UTIL_SNAPSHOT_H
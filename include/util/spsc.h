@@ -0,0 +1,49 @@
+#ifndef UTIL_SPSC_H
+#define UTIL_SPSC_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// Lock-free handoffs between exactly one producer thread and one consumer
+// thread. Neither side ever blocks or allocates after creation.
+
+typedef struct SpscQueue SpscQueue;
+typedef struct SpscTripleBuffer SpscTripleBuffer;
+
+bool spsc_queue_create(SpscQueue **out_queue, size_t elem_size, size_t capacity);
+// Creates a FIFO of fixed-size elements; capacity is rounded up to a power of
+// two. Returns false on invalid arguments or allocation failure, leaving
+// *out_queue untouched.
+
+void spsc_queue_destroy(SpscQueue *queue);
+// Frees the queue; safe to call on null. Neither thread may still use it.
+
+bool spsc_queue_push(SpscQueue *queue, const void *elem);
+// Producer only: copies elem in. Returns false when the queue is full.
+
+bool spsc_queue_pop(SpscQueue *queue, void *out_elem);
+// Consumer only: copies the oldest element out. Returns false when empty.
+
+bool spsc_triple_buffer_create(SpscTripleBuffer **out_buffer);
+// Three slots, indexed 0..2, that the caller allocates alongside: the producer
+// fills one while the consumer reads another, and the third holds the latest
+// published one. Publishing never waits for the consumer and the consumer
+// always gets the newest complete slot; intermediate ones are skipped.
+
+void spsc_triple_buffer_destroy(SpscTripleBuffer *buffer);
+
+unsigned spsc_triple_buffer_write_slot(const SpscTripleBuffer *buffer);
+// Producer only: the slot to fill next.
+
+void spsc_triple_buffer_publish(SpscTripleBuffer *buffer);
+// Producer only: makes the filled slot the latest and takes a free one; the
+// writes to the slot happen-before the consumer's acquire that returns it.
+
+bool spsc_triple_buffer_acquire(SpscTripleBuffer *buffer);
+// Consumer only: switches to the latest published slot. Returns false (and
+// keeps the current slot) when nothing was published since the last call.
+
+unsigned spsc_triple_buffer_read_slot(const SpscTripleBuffer *buffer);
+// Consumer only: the slot to read, stable until the next acquire.
+
+#endif  // UTIL_SPSC_H
@@ -0,0 +1,53 @@
+#ifndef UTIL_TIMER_WHEEL_H
+#define UTIL_TIMER_WHEEL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Hierarchical timer wheel over integer ticks for a fixed set of entry ids
+// [0, capacity). Four levels of 64 slots cover 2^24 ticks ahead; scheduling,
+// cancelling and firing are O(1) per entry, and an advance with nothing due
+// costs one slot check.
+
+typedef struct TimerWheel TimerWheel;
+
+typedef void (*TimerWheelFn)(void *user_data, uint32_t id);
+
+#define TIMER_WHEEL_SPAN (UINT64_C(1) << 24)
+
+bool timer_wheel_create(TimerWheel **out_wheel, size_t capacity, uint64_t now);
+// Creates an empty wheel whose current tick is now. Returns false on
+// allocation failure, leaving *out_wheel untouched.
+
+void timer_wheel_destroy(TimerWheel *wheel);
+// Frees the wheel; safe to call on null.
+
+void timer_wheel_reset(TimerWheel *wheel, uint64_t now);
+// Cancels every entry and moves the current tick to now.
+
+void timer_wheel_schedule(TimerWheel *wheel, uint32_t id, uint64_t due_tick);
+// (Re)schedules id to fire at due_tick. Due ticks at or before the current
+// tick fire on the next advance; ticks beyond TIMER_WHEEL_SPAN are clamped to
+// the end of the span, so the owner must re-check and re-arm when it fires.
+
+void timer_wheel_cancel(TimerWheel *wheel, uint32_t id);
+// Removes id if scheduled.
+
+size_t timer_wheel_capacity(const TimerWheel *wheel);
+
+size_t timer_wheel_bytes_per_entry(void);
+// Bytes the wheel allocates per entry id.
+
+bool timer_wheel_scheduled(const TimerWheel *wheel, uint32_t id);
+
+uint64_t timer_wheel_due(const TimerWheel *wheel, uint32_t id);
+// Tick at which id fires, or UINT64_MAX if it is not scheduled. Scheduling
+// the returned tick on a wheel at the same current tick recreates the entry.
+
+size_t timer_wheel_advance(TimerWheel *wheel, uint64_t now, TimerWheelFn fn, void *user_data);
+// Moves the current tick forward to now and calls fn(user_data, id) for every
+// entry due at or before it; each fired entry is unscheduled before its call.
+// Returns the number of entries fired.
+
+#endif  // UTIL_TIMER_WHEEL_H
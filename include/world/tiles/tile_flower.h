@@ -4,6 +4,7 @@
 #include "tile_core.h"
 #include "tile_types.h"
 
+#include <stdbool.h>
 #include <stddef.h>
 #include <stdint.h>
 
@@ -11,20 +12,48 @@
 extern "C" {
 #endif
 
+struct SnapshotWriter;
+struct SnapshotReader;
+
+// The flower system is the only owner of nectar state. Every column below is
+// indexed by world tile and spans the whole world; HexWorld's nectar and
+// flower columns point into these arrays rather than holding copies. Tiles
+// that are not flowers keep capacity 0, so dynamics loops can run over the
+// full range without a membership lookup.
 typedef struct FlowerSystem {
-    FlowerPayload *payloads;
-    size_t payload_count;
-    size_t payload_capacity;
-    size_t *tile_indices;
+    float *stock;
+    float *capacity;
+    float *recharge_rate;
+    float *recharge_multiplier;
+    float *quality;
+    float *viscosity;
+    uint16_t *archetype_id;
+    uint8_t *is_flower;        // 1 for tiles generated as flowers
+    uint64_t *stock_changed;   // one bit per tile, written by tile_flower_recharge
+    size_t tile_capacity;
+    size_t *tile_indices;      // flower tiles in generation order
     size_t tile_index_count;
     size_t tile_index_capacity;
-    uint32_t *tile_to_payload;
-    size_t tile_to_payload_capacity;
+
+    // Lazy recharge (tile_flower_set_lazy): stock[] holds each tile's stock as
+    // of stock_time[], and readers add the recharge since then in closed form.
+    bool lazy;
+    double clock_sec;
+    double clock_integral;  // integral of the diurnal multiplier over [0, clock_sec]
+    float day_period_sec;
+    float night_scale;
+    double *stock_time;
+    struct TimerWheel *crossings;  // tiles due to rise above the availability threshold
+    uint64_t step;
+    float step_sec;
 } FlowerSystem;
 
 void tile_flower_system_init(FlowerSystem *system);
 void tile_flower_system_shutdown(FlowerSystem *system);
-void tile_flower_system_reset(FlowerSystem *system, size_t tile_capacity);
+bool tile_flower_system_reset(FlowerSystem *system, size_t tile_capacity);
+// Reallocates the columns for tile_capacity tiles and fills them with the
+// non-flower defaults. Returns false (leaving the columns NULL) on
+// allocation failure.
 
 void tile_flower_register(TileRegistry *registry, FlowerSystem *system);
 
@@ -35,6 +64,12 @@ float tile_flower_harvest(FlowerSystem *system,
                           float request_uL,
                           float *quality_out);
 void tile_flower_tick(FlowerSystem *system, struct HexWorld *world, float dt_sec);
+// Recharges every flower at its own stored multiplier.
+void tile_flower_recharge(FlowerSystem *system, struct HexWorld *world, float multiplier, float dt_sec);
+// Sets the recharge multiplier of every tile with capacity and recharges the
+// ones with a positive rate, in one pass over the columns. Marks the tiles
+// whose stock moved in stock_changed and keeps the world's availability
+// counters in step.
 uint32_t tile_flower_color(const FlowerSystem *system, size_t tile_index, uint32_t fallback_rgba);
 const char *tile_flower_archetype_name(const FlowerSystem *system, size_t tile_index);
 bool tile_flower_override_payload(FlowerSystem *system,
@@ -46,6 +81,47 @@ bool tile_flower_override_payload(FlowerSystem *system,
                                   float recharge_multiplier,
                                   float quality,
                                   float viscosity);
+// Replaces the nectar parameters of an existing flower tile.
+
+bool tile_flower_set_lazy(FlowerSystem *system,
+                          struct HexWorld *world,
+                          bool enabled,
+                          float day_period_sec,
+                          float night_scale,
+                          double clock_sec);
+// Switches between per-tick recharge (tile_flower_recharge) and lazy
+// recharge. In lazy mode the recharge multiplier follows the step diurnal
+// cycle (1 for the first half of each period, night_scale for the second) on
+// a clock starting at clock_sec and moved by tile_flower_advance; stock is
+// only evaluated when read. Disabling writes every current stock back.
+// Returns false (staying eager) on allocation failure.
+
+void tile_flower_advance(FlowerSystem *system, struct HexWorld *world, float dt_sec);
+// Lazy mode: moves the clock forward. Costs O(1) plus the tiles that rise
+// above the availability threshold during the step.
+
+float tile_flower_stock(const FlowerSystem *system, size_t tile_index);
+// Current stock of the tile in either mode.
+
+float tile_flower_recharge_multiplier(const FlowerSystem *system, size_t tile_index);
+// Current recharge multiplier of the tile in either mode.
+
+void tile_flower_settle(FlowerSystem *system, struct HexWorld *world, size_t tile_index);
+// Lazy mode: writes the tile's current stock into stock[] before a
+// read-modify-write, and settles a pending availability crossing.
+
+void tile_flower_touch(FlowerSystem *system, size_t tile_index);
+// Lazy mode: call after writing a settled tile's columns; restarts its
+// recharge from the current clock.
+
+bool tile_flower_snapshot_write(const FlowerSystem *system, struct SnapshotWriter *writer);
+// Writes every nectar column, the flower list and the lazy recharge clock and
+// pending crossings as "flower.*" checkpoint columns.
+
+bool tile_flower_snapshot_read(FlowerSystem *system, const struct SnapshotReader *reader);
+// Restores an initialized, empty system from tile_flower_snapshot_write
+// columns (copying them). Returns false, leaving the system empty, if a
+// column is missing or malformed.
 
 #ifdef __cplusplus
 }
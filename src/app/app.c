@@ -1,20 +1,21 @@
 #include "app.h"
 #include <math.h>
 #include <stddef.h>
-#include "hex.h"
+#include <stdio.h>
+#include "app_sim.h"
 #include "params.h"
 #include "platform.h"
 #include "render.h"
-#include "sim.h"
 #include "ui.h"
 
 #include "util/log.h"
 
+// Render/UI thread. The simulation runs on its own thread (app_sim.h); this
+// side only sends it commands and draws the frames it publishes.
 static Platform g_platform = {0};
 static Render g_render = {0};
 static Params g_params = {0};
 static Params g_params_runtime = {0};
-static SimState *g_sim = NULL;
 static bool g_app_initialized = false;
 static bool g_app_should_quit = false;
 static RenderCamera g_camera = {{0.0f, 0.0f}, 1.0f};
@@ -22,11 +23,20 @@ static float g_default_zoom = 1.0f;
 static float g_default_center_world[2] = {0.0f, 0.0f};
 static int g_fb_width = 0;
 static int g_fb_height = 0;
-static float g_sim_fixed_dt = 1.0f / 120.0f;
-static const double g_sim_max_accumulator = 0.25;
-static size_t g_selected_bee_index = SIZE_MAX;
-static HexWorld g_hex_world = {0};
-static size_t g_selected_hex_index = SIZE_MAX;
+// Commands whose effect the render side waits for: 0 when none is pending,
+// else the app_sim_commands_sent value right after the send.
+static uint64_t g_pending_apply = 0;
+static bool g_pending_apply_reinit = false;
+static uint64_t g_pending_focus = 0;
+static bool g_heatmap_sent = false;
+// Detail region last sent to the sim: the view grown by a quarter of its size
+// on each side, so panning and zooming only resend it occasionally.
+static bool g_detail_sent = false;
+static float g_detail_sent_rect[4];
+// Fast-forward ladder stepped with '[' and ']'; the last entry (0) runs the
+// sim flat out.
+static const float g_speed_steps[] = {1.0f, 2.0f, 5.0f, 10.0f, 20.0f, 50.0f, 100.0f, 200.0f, 500.0f, 1000.0f, 0.0f};
+static size_t g_speed_step = 0;
 static float clampf(float v, float lo, float hi) {
     if (v < lo) {
         return lo;
@@ -44,7 +54,6 @@ static void app_reset_camera(void) {
 }
 
 static void app_recompute_world_defaults(void);
-static bool app_apply_runtime_params(bool reinit_required);
 
 static void app_update_camera(const Input *input, float dt_sec) {
     if (!input || g_fb_width <= 0 || g_fb_height <= 0) {
@@ -111,6 +120,43 @@ static void app_update_camera(const Input *input, float dt_sec) {
     }
 }
 
+// Keys the sim's level of detail to the visible world rectangle.
+static void app_update_detail_region(void) {
+    if (g_fb_width <= 0 || g_fb_height <= 0) {
+        return;
+    }
+    float zoom = g_camera.zoom > 0.0f ? g_camera.zoom : 1.0f;
+    float half_w = 0.5f * (float)g_fb_width / zoom;
+    float half_h = 0.5f * (float)g_fb_height / zoom;
+    float view[4] = {
+        g_camera.center_world[0] - half_w,
+        g_camera.center_world[1] - half_h,
+        g_camera.center_world[0] + half_w,
+        g_camera.center_world[1] + half_h,
+    };
+    if (g_detail_sent) {
+        const float *sent = g_detail_sent_rect;
+        bool inside = view[0] >= sent[0] && view[1] >= sent[1] && view[2] <= sent[2] && view[3] <= sent[3];
+        bool zoomed_in = (view[2] - view[0]) < 0.5f * (sent[2] - sent[0]);
+        if (inside && !zoomed_in) {
+            return;
+        }
+    }
+    AppSimCommand command = {0};
+    command.type = APP_SIM_CMD_SET_DETAIL_REGION;
+    command.u.region.min_x = view[0] - 0.5f * half_w;
+    command.u.region.min_y = view[1] - 0.5f * half_h;
+    command.u.region.max_x = view[2] + 0.5f * half_w;
+    command.u.region.max_y = view[3] + 0.5f * half_h;
+    if (app_sim_send(&command)) {
+        g_detail_sent = true;
+        g_detail_sent_rect[0] = command.u.region.min_x;
+        g_detail_sent_rect[1] = command.u.region.min_y;
+        g_detail_sent_rect[2] = command.u.region.max_x;
+        g_detail_sent_rect[3] = command.u.region.max_y;
+    }
+}
+
 static void app_recompute_world_defaults(void) {
     float world_w = g_params.world_width_px > 0.0f ? g_params.world_width_px : (float)g_fb_width;
     float world_h = g_params.world_height_px > 0.0f ? g_params.world_height_px : (float)g_fb_height;
@@ -136,11 +182,10 @@ static void app_recompute_world_defaults(void) {
     }
 }
 
-static double g_sim_accumulator_sec = 0.0;
-static bool g_sim_paused = false;
 static double g_log_accumulator_sec = 0.0;
 static unsigned g_log_frame_counter = 0;
-static unsigned g_log_tick_counter = 0;
+static uint64_t g_log_ticks_total = 0;
+static double g_log_sim_seconds_total = 0.0;
 
 bool app_init(const Params *params) {
     if (g_app_initialized) {
@@ -158,11 +203,6 @@ bool app_init(const Params *params) {
 
     g_params = *params;
     g_params_runtime = g_params;
-    if (g_params.sim_fixed_dt > 0.0f) {
-        g_sim_fixed_dt = g_params.sim_fixed_dt;
-    } else {
-        g_sim_fixed_dt = 1.0f / 120.0f;
-    }
     char err[256];
     if (!params_validate(&g_params, err, sizeof err)) {
         LOG_ERROR("Params validation failed: %s", err);
@@ -204,26 +244,16 @@ bool app_init(const Params *params) {
         return false;
     }
 
-    if (!hex_world_init(&g_hex_world, &g_params)) {
-        LOG_ERROR("Hex world initialization failed");
-        render_shutdown(&g_render);
-        plat_shutdown(&g_platform);
-        return false;
-    }
-
     ui_init();
     ui_sync_to_params(&g_params, &g_params_runtime);
+    ui_set_sim_speed(g_speed_steps[0], 0.0f, 0.0f);
 
-    if (!sim_init(&g_sim, &g_params)) {
-        LOG_ERROR("Simulation initialization failed");
+    if (!app_sim_start(&g_params)) {
         ui_shutdown();
-        hex_world_shutdown(&g_hex_world);
         render_shutdown(&g_render);
         plat_shutdown(&g_platform);
         return false;
     }
-    sim_bind_hex_world(g_sim, &g_hex_world);
-    LOG_INFO("app_init: sim ready");
 
     int init_fb_w = g_params.window_width_px;
     int init_fb_h = g_params.window_height_px;
@@ -243,78 +273,86 @@ bool app_init(const Params *params) {
     app_recompute_world_defaults();
     app_reset_camera();
 
-    g_sim_accumulator_sec = 0.0;
-    g_sim_paused = false;
+    g_pending_apply = 0;
+    g_pending_apply_reinit = false;
+    g_pending_focus = 0;
+    g_heatmap_sent = false;
+    g_detail_sent = false;
+    g_speed_step = 0;
     g_log_accumulator_sec = 0.0;
     g_log_frame_counter = 0;
-    g_log_tick_counter = 0;
+    g_log_ticks_total = 0;
+    g_log_sim_seconds_total = 0.0;
 
     g_app_initialized = true;
     g_app_should_quit = false;
-    LOG_INFO("fixed_dt=%.5f vsync=%d", g_sim_fixed_dt, g_params.vsync_on ? 1 : 0);
+    LOG_INFO("fixed_dt=%.5f vsync=%d",
+             g_params.sim_fixed_dt > 0.0f ? g_params.sim_fixed_dt : 1.0f / 120.0f,
+             g_params.vsync_on ? 1 : 0);
     LOG_INFO("Boot ok");
     return true;
 }
 
-static bool app_apply_runtime_params(bool reinit_required) {
-    Params new_params = g_params_runtime;
+static void app_send(AppSimCommandType type) {
+    AppSimCommand command = {0};
+    command.type = type;
+    app_sim_send(&command);
+}
+
+// Validates the edited params here and hands them to the sim thread; the UI
+// and camera follow once a frame shows them applied (app_finish_apply).
+static void app_apply_runtime_params(bool reinit_required) {
+    AppSimCommand command = {0};
+    command.type = APP_SIM_CMD_APPLY_PARAMS;
+    command.u.apply.params = g_params_runtime;
+    command.u.apply.reinit = reinit_required;
     char err[256];
-    if (!params_validate(&new_params, err, sizeof err)) {
+    if (!params_validate(&command.u.apply.params, err, sizeof err)) {
         LOG_WARN("runtime params invalid: %s", err);
         g_params_runtime = g_params;
         ui_sync_to_params(&g_params, &g_params_runtime);
-        return false;
-    }
-
-    bool world_changed =
-        fabsf(new_params.world_width_px - g_params.world_width_px) > 0.0001f ||
-        fabsf(new_params.world_height_px - g_params.world_height_px) > 0.0001f;
-
-    if (reinit_required) {
-        SimState *fresh = NULL;
-        if (!sim_init(&fresh, &new_params)) {
-            LOG_ERROR("sim reinit failed; keeping previous simulation");
-            g_params_runtime = g_params;
-            ui_sync_to_params(&g_params, &g_params_runtime);
-            return false;
-        }
-        sim_shutdown(g_sim);
-        g_sim = fresh;
-        sim_bind_hex_world(g_sim, &g_hex_world);
-        g_sim_accumulator_sec = 0.0;
-    } else if (g_sim) {
-        sim_apply_runtime_params(g_sim, &new_params);
+        return;
     }
-
-    render_set_clear_color(&g_render, new_params.clear_color_rgba);
-
-    g_params = new_params;
-    if (g_params.sim_fixed_dt > 0.0f) {
-        g_sim_fixed_dt = g_params.sim_fixed_dt;
+    if (!app_sim_send(&command)) {
+        g_params_runtime = g_params;
+        ui_sync_to_params(&g_params, &g_params_runtime);
+        return;
     }
+    g_pending_apply = app_sim_commands_sent();
+    g_pending_apply_reinit = g_pending_apply_reinit || reinit_required;
+}
 
-    if (!hex_world_rebuild(&g_hex_world, &g_params)) {
-        LOG_ERROR("hex: rebuild failed; retaining previous grid");
-    } else {
-        size_t tile_count = hex_world_tile_count(&g_hex_world);
-        if (g_selected_hex_index >= tile_count) {
-            g_selected_hex_index = SIZE_MAX;
-            ui_set_selected_hex(NULL, false);
-        }
-        if (g_sim) {
-            sim_bind_hex_world(g_sim, &g_hex_world);
-        }
-    }
+static void app_finish_apply(const AppSimFrame *frame) {
+    const Params *applied = &frame->params;
+    bool world_changed =
+        fabsf(applied->world_width_px - g_params.world_width_px) > 0.0001f ||
+        fabsf(applied->world_height_px - g_params.world_height_px) > 0.0001f;
 
-    if (reinit_required || world_changed) {
+    render_set_clear_color(&g_render, applied->clear_color_rgba);
+    g_params = *applied;
+    if (g_pending_apply_reinit || world_changed) {
         app_recompute_world_defaults();
         app_reset_camera();
     }
-
     g_params_runtime = g_params;
     ui_sync_to_params(&g_params, &g_params_runtime);
-    LOG_INFO("ui: applied params (reinit=%d)", reinit_required ? 1 : 0);
-    return true;
+    g_pending_apply = 0;
+    g_pending_apply_reinit = false;
+}
+
+static void app_focus_camera(float world_x, float world_y) {
+    g_camera.center_world[0] = world_x;
+    g_camera.center_world[1] = world_y;
+    const float zoom_min = 0.05f;
+    const float zoom_max = 20.0f;
+    float focus_zoom = g_default_zoom > 0.0f ? g_default_zoom * 2.5f : 2.0f;
+    if (focus_zoom < 1.5f) {
+        focus_zoom = 1.5f;
+    }
+    if (focus_zoom > 8.0f) {
+        focus_zoom = 8.0f;
+    }
+    g_camera.zoom = clampf(focus_zoom, zoom_min, zoom_max);
 }
 
 void app_frame(void) {
@@ -326,9 +364,20 @@ void app_frame(void) {
     Timing timing = (Timing){0};
     plat_pump(&g_platform, &input, &timing);
 
+    const AppSimFrame *frame = app_sim_acquire_frame();
+    if (g_pending_apply != 0 && frame->commands_done >= g_pending_apply) {
+        app_finish_apply(frame);
+    }
+    if (g_pending_focus != 0 && frame->commands_done >= g_pending_focus) {
+        if (frame->selected_bee == 0) {
+            app_focus_camera(frame->bee_info.pos_x, frame->bee_info.pos_y);
+        }
+        g_pending_focus = 0;
+    }
+
     ui_set_viewport(&g_camera, g_fb_width, g_fb_height);
 
-    UiActions ui_actions = ui_update(&input, g_sim_paused, timing.dt_sec);
+    UiActions ui_actions = ui_update(&input, frame->paused, timing.dt_sec);
     bool ui_mouse = ui_wants_mouse();
     bool ui_keyboard = ui_wants_keyboard();
 
@@ -343,33 +392,27 @@ void app_frame(void) {
         LOG_INFO("ui: runtime params reset to baseline");
     }
 
-    if (ui_actions.focus_queen && g_sim) {
-        BeeDebugInfo queen_info;
-        if (sim_get_bee_info(g_sim, 0, &queen_info)) {
-            g_camera.center_world[0] = queen_info.pos_x;
-            g_camera.center_world[1] = queen_info.pos_y;
-            const float zoom_min = 0.05f;
-            const float zoom_max = 20.0f;
-            float focus_zoom = g_default_zoom > 0.0f ? g_default_zoom * 2.5f : 2.0f;
-            if (focus_zoom < 1.5f) {
-                focus_zoom = 1.5f;
-            }
-            if (focus_zoom > 8.0f) {
-                focus_zoom = 8.0f;
-            }
-            g_camera.zoom = clampf(focus_zoom, zoom_min, zoom_max);
-            g_selected_bee_index = 0;
-            ui_set_selected_bee(&queen_info, true);
+    if (ui_actions.focus_queen) {
+        AppSimCommand command = {0};
+        command.type = APP_SIM_CMD_FOCUS_QUEEN;
+        if (app_sim_send(&command)) {
+            g_pending_focus = app_sim_commands_sent();
         }
     }
 
+    if (!ui_keyboard && input.key_save_pressed) {
+        app_send(APP_SIM_CMD_SAVE);
+    }
+    if (!ui_keyboard && input.key_load_pressed) {
+        app_send(APP_SIM_CMD_LOAD);
+    }
+
     bool toggle_pause = ui_actions.toggle_pause;
     if (!ui_keyboard && input.key_space_pressed) {
         toggle_pause = true;
     }
     if (toggle_pause) {
-        g_sim_paused = !g_sim_paused;
-        LOG_INFO("pause=%d", g_sim_paused ? 1 : 0);
+        app_send(APP_SIM_CMD_TOGGLE_PAUSE);
     }
 
     bool step_requested = false;
@@ -379,61 +422,55 @@ void app_frame(void) {
     if (!ui_keyboard && input.key_period_pressed) {
         step_requested = true;
     }
-    step_requested = step_requested && g_sim_paused;
+    if (step_requested && frame->paused) {
+        app_send(APP_SIM_CMD_STEP);
+    }
+    if (!ui_keyboard && input.key_comma_pressed && frame->paused) {
+        app_send(APP_SIM_CMD_STEP_BACK);
+    }
+
+    size_t speed_step = g_speed_step;
+    const size_t speed_step_count = sizeof(g_speed_steps) / sizeof(g_speed_steps[0]);
+    if ((ui_actions.speed_down || (!ui_keyboard && input.key_slower_pressed)) && speed_step > 0) {
+        --speed_step;
+    }
+    if ((ui_actions.speed_up || (!ui_keyboard && input.key_faster_pressed)) && speed_step + 1u < speed_step_count) {
+        ++speed_step;
+    }
+    if (speed_step != g_speed_step) {
+        AppSimCommand command = {0};
+        command.type = APP_SIM_CMD_SET_SPEED;
+        command.u.speed_multiple = g_speed_steps[speed_step];
+        if (app_sim_send(&command)) {
+            g_speed_step = speed_step;
+            if (g_speed_steps[speed_step] > 0.0f) {
+                LOG_INFO("speed: %gx real time", g_speed_steps[speed_step]);
+            } else {
+                LOG_INFO("speed: flat out");
+            }
+        }
+    }
 
     if (!ui_mouse && input.mouse_left_pressed) {
         float zoom = g_camera.zoom > 0.0f ? g_camera.zoom : 1.0f;
         float half_w = 0.5f * (float)g_fb_width;
         float half_h = 0.5f * (float)g_fb_height;
-        float world_x = (input.mouse_x_px - half_w) / zoom + g_camera.center_world[0];
-        float world_y = (input.mouse_y_px - half_h) / zoom + g_camera.center_world[1];
         float pick_radius_px = 18.0f;
-        float pick_radius_world = pick_radius_px / zoom;
-        if (g_sim) {
-            size_t bee_index = sim_find_bee_near(g_sim, world_x, world_y, pick_radius_world);
-            if (bee_index != SIZE_MAX) {
-                BeeDebugInfo info;
-                if (sim_get_bee_info(g_sim, bee_index, &info)) {
-                    g_selected_bee_index = bee_index;
-                    ui_set_selected_bee(&info, true);
-                } else {
-                    g_selected_bee_index = SIZE_MAX;
-                    ui_set_selected_bee(NULL, false);
-                }
-            } else {
-                g_selected_bee_index = SIZE_MAX;
-                ui_set_selected_bee(NULL, false);
-            }
-        } else {
-            g_selected_bee_index = SIZE_MAX;
-            ui_set_selected_bee(NULL, false);
-        }
-
-        size_t hex_tile_count = hex_world_tile_count(&g_hex_world);
-        if (hex_tile_count > 0) {
-            int pick_q = 0;
-            int pick_r = 0;
-            if (hex_world_pick(&g_hex_world, world_x, world_y, &pick_q, &pick_r)) {
-                size_t tile_index = hex_world_index(&g_hex_world, pick_q, pick_r);
-                if (tile_index != SIZE_MAX) {
-                    g_selected_hex_index = tile_index;
-                    HexTileDebugInfo info;
-                    if (hex_world_tile_debug_info(&g_hex_world, tile_index, &info)) {
-                        ui_set_selected_hex(&info, true);
-                    } else {
-                        ui_set_selected_hex(NULL, false);
-                    }
-                } else {
-                    g_selected_hex_index = SIZE_MAX;
-                    ui_set_selected_hex(NULL, false);
-                }
-            } else {
-                g_selected_hex_index = SIZE_MAX;
-                ui_set_selected_hex(NULL, false);
-            }
-        } else if (g_selected_hex_index != SIZE_MAX) {
-            g_selected_hex_index = SIZE_MAX;
-            ui_set_selected_hex(NULL, false);
+        AppSimCommand command = {0};
+        command.type = APP_SIM_CMD_PICK;
+        command.u.pick.world_x = (input.mouse_x_px - half_w) / zoom + g_camera.center_world[0];
+        command.u.pick.world_y = (input.mouse_y_px - half_h) / zoom + g_camera.center_world[1];
+        command.u.pick.radius_world = pick_radius_px / zoom;
+        app_sim_send(&command);
+    }
+
+    bool heatmap = ui_hex_heatmap_enabled();
+    if (heatmap != g_heatmap_sent) {
+        AppSimCommand command = {0};
+        command.type = APP_SIM_CMD_SET_HEATMAP;
+        command.u.enabled = heatmap;
+        if (app_sim_send(&command)) {
+            g_heatmap_sent = heatmap;
         }
     }
 
@@ -458,57 +495,42 @@ void app_frame(void) {
     }
 
     app_update_camera(&camera_input, timing.dt_sec);
-
-    if (!g_sim_paused) {
-        g_sim_accumulator_sec += timing.dt_sec;
-        if (g_sim_accumulator_sec > g_sim_max_accumulator) {
-            g_sim_accumulator_sec = g_sim_max_accumulator;
-        }
-    }
-
-    unsigned ticks_this_frame = 0;
-    if (g_sim) {
-        if (g_sim_paused) {
-            if (step_requested) {
-                sim_tick(g_sim, g_sim_fixed_dt);
-                ticks_this_frame = 1;
-                LOG_INFO("step one tick (%.3fms)", g_sim_fixed_dt * 1000.0f);
-            }
-        } else {
-            while (g_sim_accumulator_sec >= (double)g_sim_fixed_dt) {
-                sim_tick(g_sim, g_sim_fixed_dt);
-                g_sim_accumulator_sec -= (double)g_sim_fixed_dt;
-                ++ticks_this_frame;
-            }
-            if (g_sim_accumulator_sec < 0.0) {
-                g_sim_accumulator_sec = 0.0;
-            }
-        }
-    }
+    app_update_detail_region();
 
     g_log_accumulator_sec += timing.dt_sec;
     g_log_frame_counter += 1;
-    g_log_tick_counter += ticks_this_frame;
 
     if (g_log_accumulator_sec >= 1.0) {
-        if (g_sim_paused) {
-            LOG_INFO("paused (press '.' to step)");
+        uint64_t ticks = frame->ticks_total - g_log_ticks_total;
+        double speed_achieved = (frame->sim_seconds_total - g_log_sim_seconds_total) / g_log_accumulator_sec;
+        double ticks_per_frame = g_log_frame_counter > 0 ? (double)ticks / (double)g_log_frame_counter : 0.0;
+        ui_set_sim_speed(frame->speed_multiple, (float)speed_achieved, (float)ticks_per_frame);
+        if (frame->paused) {
+            LOG_INFO("paused (press '.' to step, ',' to step back)");
         } else {
             double dt_ms = timing.dt_sec * 1000.0;
-            double acc_ms = g_sim_accumulator_sec * 1000.0;
+            double acc_ms = frame->accumulator_sec * 1000.0;
             double fps_f = g_log_accumulator_sec > 0.0
                                ? (double)g_log_frame_counter / g_log_accumulator_sec
                                : 0.0;
             int fps_est = (int)(fps_f + 0.5);
-            LOG_INFO("dt=%.3fms acc=%.2fms ticks=%u fps~%d",
+            char target[32] = "flat out";
+            if (frame->speed_multiple > 0.0f) {
+                snprintf(target, sizeof target, "target %gx", frame->speed_multiple);
+            }
+            LOG_INFO("dt=%.3fms acc=%.2fms ticks=%llu (%.1f/frame) speed=%.1fx (%s) fps~%d",
                      dt_ms,
                      acc_ms,
-                     g_log_tick_counter,
+                     (unsigned long long)ticks,
+                     ticks_per_frame,
+                     speed_achieved,
+                     target,
                      fps_est);
         }
         g_log_accumulator_sec = 0.0;
         g_log_frame_counter = 0;
-        g_log_tick_counter = 0;
+        g_log_ticks_total = frame->ticks_total;
+        g_log_sim_seconds_total = frame->sim_seconds_total;
     }
 
     int fb_w = 0;
@@ -531,94 +553,78 @@ void app_frame(void) {
 
     RenderHexView hex_view = (RenderHexView){0};
     RenderHexView *hex_view_ptr = NULL;
-    size_t hex_tile_count = hex_world_tile_count(&g_hex_world);
-    if (hex_tile_count == 0 && g_selected_hex_index != SIZE_MAX) {
-        g_selected_hex_index = SIZE_MAX;
-        ui_set_selected_hex(NULL, false);
-    }
+    size_t hex_tile_count = frame->hex_count;
     if (hex_tile_count > 0) {
-        hex_world_apply_palette(&g_hex_world, ui_hex_heatmap_enabled());
-        hex_view.centers_world_xy = hex_world_centers_xy(&g_hex_world);
+        hex_view.centers_world_xy = frame->hex_centers_xy;
         hex_view.scale_world = NULL;
-        hex_view.fill_rgba = hex_world_colors_rgba(&g_hex_world);
+        hex_view.fill_rgba = frame->hex_fill_rgba;
         hex_view.count = hex_tile_count;
-        hex_view.uniform_scale_world = hex_world_cell_radius(&g_hex_world);
+        hex_view.uniform_scale_world = frame->hex_cell_radius;
         hex_view.visible = ui_hex_grid_enabled();
         hex_view.draw_on_top = ui_hex_overlay_on_top();
-        bool highlight_valid = (g_selected_hex_index != SIZE_MAX) &&
-                               (g_selected_hex_index < hex_tile_count);
+        bool highlight_valid = (frame->selected_hex != SIZE_MAX) &&
+                               (frame->selected_hex < hex_tile_count);
         hex_view.highlight_enabled = highlight_valid;
-        hex_view.highlight_index = highlight_valid ? g_selected_hex_index : (size_t)0;
+        hex_view.highlight_index = highlight_valid ? frame->selected_hex : (size_t)0;
         hex_view.highlight_fill_rgba = 0xFFFF33FFu;
         hex_view_ptr = &hex_view;
     }
 
     RenderView view = (RenderView){0};
-    if (g_sim) {
-        view = sim_build_view(g_sim);
-        if (g_selected_bee_index != SIZE_MAX) {
-            BeeDebugInfo info;
-            if (sim_get_bee_info(g_sim, g_selected_bee_index, &info)) {
-                ui_set_selected_bee(&info, true);
-                if (info.path_valid) {
-                    const uint32_t debug_color = 0xFF0000FFu;
-                    const float eps = 1e-3f;
-                    bool distinct_waypoint = info.path_has_waypoint &&
-                                             (fabsf(info.path_waypoint_x - info.path_final_x) > eps ||
-                                              fabsf(info.path_waypoint_y - info.path_final_y) > eps);
-                    if (debug_line_count < 8) {
-                        size_t base = debug_line_count * 4;
-                        debug_line_points[base + 0] = info.pos_x;
-                        debug_line_points[base + 1] = info.pos_y;
-                        debug_line_points[base + 2] =
-                            distinct_waypoint ? info.path_waypoint_x : info.path_final_x;
-                        debug_line_points[base + 3] =
-                            distinct_waypoint ? info.path_waypoint_y : info.path_final_y;
-                        debug_line_colors[debug_line_count] = debug_color;
-                        ++debug_line_count;
-                    }
-                    if (distinct_waypoint && debug_line_count < 8) {
-                        size_t base = debug_line_count * 4;
-                        debug_line_points[base + 0] = info.path_waypoint_x;
-                        debug_line_points[base + 1] = info.path_waypoint_y;
-                        debug_line_points[base + 2] = info.path_final_x;
-                        debug_line_points[base + 3] = info.path_final_y;
-                        debug_line_colors[debug_line_count] = debug_color;
-                        ++debug_line_count;
-                    }
-                }
-            } else {
-                g_selected_bee_index = SIZE_MAX;
-                ui_set_selected_bee(NULL, false);
+    view.positions_xy = frame->positions_xy;
+    view.radii_px = frame->radii_px;
+    view.color_rgba = frame->color_rgba;
+    view.count = frame->bee_count;
+    if (frame->selected_bee != SIZE_MAX) {
+        const BeeDebugInfo *info = &frame->bee_info;
+        ui_set_selected_bee(info, true);
+        if (info->path_valid) {
+            const uint32_t debug_color = 0xFF0000FFu;
+            const float eps = 1e-3f;
+            bool distinct_waypoint = info->path_has_waypoint &&
+                                     (fabsf(info->path_waypoint_x - info->path_final_x) > eps ||
+                                      fabsf(info->path_waypoint_y - info->path_final_y) > eps);
+            if (debug_line_count < 8) {
+                size_t base = debug_line_count * 4;
+                debug_line_points[base + 0] = info->pos_x;
+                debug_line_points[base + 1] = info->pos_y;
+                debug_line_points[base + 2] =
+                    distinct_waypoint ? info->path_waypoint_x : info->path_final_x;
+                debug_line_points[base + 3] =
+                    distinct_waypoint ? info->path_waypoint_y : info->path_final_y;
+                debug_line_colors[debug_line_count] = debug_color;
+                ++debug_line_count;
+            }
+            if (distinct_waypoint && debug_line_count < 8) {
+                size_t base = debug_line_count * 4;
+                debug_line_points[base + 0] = info->path_waypoint_x;
+                debug_line_points[base + 1] = info->path_waypoint_y;
+                debug_line_points[base + 2] = info->path_final_x;
+                debug_line_points[base + 3] = info->path_final_y;
+                debug_line_colors[debug_line_count] = debug_color;
+                ++debug_line_count;
             }
         }
-    } else if (g_selected_bee_index != SIZE_MAX) {
-        g_selected_bee_index = SIZE_MAX;
+    } else {
         ui_set_selected_bee(NULL, false);
     }
-    if (g_selected_hex_index != SIZE_MAX) {
-        HexTileDebugInfo hex_info;
-        if (hex_world_tile_debug_info(&g_hex_world, g_selected_hex_index, &hex_info)) {
-            ui_set_selected_hex(&hex_info, true);
-            if (hex_tile_count > 0 && debug_line_count < 8) {
-                float corners[6][2];
-                hex_world_tile_corners(&g_hex_world, hex_info.q, hex_info.r, corners);
-                const uint32_t hex_line_color = 0xFFD780FFu;
-                for (int i = 0; i < 6 && debug_line_count < 8; ++i) {
-                    int next = (i + 1) % 6;
-                    size_t base = debug_line_count * 4;
-                    debug_line_points[base + 0] = corners[i][0];
-                    debug_line_points[base + 1] = corners[i][1];
-                    debug_line_points[base + 2] = corners[next][0];
-                    debug_line_points[base + 3] = corners[next][1];
-                    debug_line_colors[debug_line_count] = hex_line_color;
-                    ++debug_line_count;
-                }
+    if (frame->selected_hex != SIZE_MAX) {
+        ui_set_selected_hex(&frame->hex_info, true);
+        if (hex_tile_count > 0 && debug_line_count < 8) {
+            const uint32_t hex_line_color = 0xFFD780FFu;
+            for (int i = 0; i < 6 && debug_line_count < 8; ++i) {
+                int next = (i + 1) % 6;
+                size_t base = debug_line_count * 4;
+                debug_line_points[base + 0] = frame->hex_corners[i][0];
+                debug_line_points[base + 1] = frame->hex_corners[i][1];
+                debug_line_points[base + 2] = frame->hex_corners[next][0];
+                debug_line_points[base + 3] = frame->hex_corners[next][1];
+                debug_line_colors[debug_line_count] = hex_line_color;
+                ++debug_line_count;
             }
-        } else {
-            g_selected_hex_index = SIZE_MAX;
-            ui_set_selected_hex(NULL, false);
         }
+    } else {
+        ui_set_selected_hex(NULL, false);
     }
     if (debug_line_count > 0) {
         view.debug_lines_xy = debug_line_points;
@@ -639,21 +645,22 @@ void app_shutdown(void) {
         return;
     }
 
-    sim_shutdown(g_sim);
-    g_sim = NULL;
+    app_sim_stop();
     ui_shutdown();
-    hex_world_shutdown(&g_hex_world);
     render_shutdown(&g_render);
     plat_shutdown(&g_platform);
     log_shutdown();
 
     g_app_should_quit = false;
     g_app_initialized = false;
-    g_sim_paused = false;
-    g_sim_accumulator_sec = 0.0;
+    g_pending_apply = 0;
+    g_pending_apply_reinit = false;
+    g_pending_focus = 0;
     g_log_accumulator_sec = 0.0;
     g_log_frame_counter = 0;
-    g_log_tick_counter = 0;
+    g_log_ticks_total = 0;
+    g_log_sim_seconds_total = 0.0;
+    g_speed_step = 0;
     app_reset_camera();
 }
 
@@ -0,0 +1,655 @@
+#include "app_sim.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+#include "render.h"
+#include "sim.h"
+#include "sim_journal.h"
+#include "sim_rewind.h"
+#include "util/log.h"
+#include "util/spsc.h"
+
+#ifdef _WIN32
+typedef HANDLE AppSimThread;
+#else
+typedef pthread_t AppSimThread;
+#endif
+
+// Each save gets a file of its own, so a journal that recorded loading one
+// still finds it unchanged; the latest file holds the newest one's name.
+static const char *const g_checkpoint_latest_path = "colony.latest";
+static const char *const g_journal_path = "session.beejournal";
+// Rewind keyframes: one per second of sim time at the default step, up to ten
+// minutes or 256 MiB.
+static const uint64_t g_rewind_interval_ticks = 120u;
+static const size_t g_rewind_max_keyframes = 600u;
+static const size_t g_rewind_max_bytes = (size_t)256u << 20;
+static const double g_sim_max_accumulator = 0.25;  // wall seconds of backlog
+// Longest run of ticks between two published frames.
+static const double g_sim_batch_budget_sec = 0.012;
+static const size_t g_command_capacity = 64u;
+
+// Owned by the sim thread once it is started.
+static Params g_params = {0};
+static SimState *g_sim = NULL;
+static HexWorld g_hex_world = {0};
+static SimJournal *g_journal = NULL;
+static SimRewind *g_rewind = NULL;
+static float g_sim_fixed_dt = 1.0f / 120.0f;
+static double g_sim_accumulator_sec = 0.0;
+static bool g_sim_paused = false;
+static float g_speed_multiple = 1.0f;
+static bool g_heatmap = false;
+static bool g_detail_region = false;
+static float g_detail_rect[4];  // min x, min y, max x, max y
+static size_t g_selected_bee_index = SIZE_MAX;
+static uint64_t g_selected_bee_epoch = 0;  // sim compaction epoch the index belongs to
+static size_t g_selected_hex_index = SIZE_MAX;
+static uint64_t g_commands_done = 0;
+static uint64_t g_ticks_total = 0;
+static double g_sim_seconds_total = 0.0;
+
+// Shared between the two threads only through the queue and triple buffer.
+static SpscQueue *g_commands = NULL;
+static SpscTripleBuffer *g_frames = NULL;
+static AppSimFrame g_frame_slots[3];
+static AppSimThread g_thread;
+static bool g_started = false;
+
+// Render thread side.
+static uint64_t g_commands_sent = 0;
+
+static double app_sim_now_sec(void) {
+#ifdef _WIN32
+    LARGE_INTEGER freq;
+    LARGE_INTEGER counter;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart / (double)freq.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+#endif
+}
+
+static void app_sim_sleep_ms(unsigned ms) {
+#ifdef _WIN32
+    Sleep(ms);
+#else
+    struct timespec ts;
+    ts.tv_sec = (time_t)(ms / 1000u);
+    ts.tv_nsec = (long)(ms % 1000u) * 1000000L;
+    nanosleep(&ts, NULL);
+#endif
+}
+
+// Keyframes cannot be re-simulated across a change made from outside the
+// tick, so the ring restarts from the changed state. The journal records the
+// restart so a replay can keep an identical ring.
+static void app_sim_rewind_restart(void) {
+    if (!g_rewind) {
+        return;
+    }
+    sim_rewind_clear(g_rewind);
+    if (g_sim) {
+        sim_rewind_capture(g_rewind, g_sim);
+        sim_journal_note_rewind_restart(g_journal, g_sim, g_rewind_interval_ticks, g_rewind_max_keyframes,
+                                        g_rewind_max_bytes);
+    }
+}
+
+// Keeps the selected bee index pointing at the same bee after the sim
+// compacts its slots. Called after anything that may compact.
+static void app_sim_follow_selected_bee(void) {
+    if (!g_sim) {
+        return;
+    }
+    uint64_t epoch = sim_compaction_epoch(g_sim);
+    if (epoch == g_selected_bee_epoch) {
+        return;
+    }
+    if (g_selected_bee_index != SIZE_MAX) {
+        g_selected_bee_index = sim_compacted_index(g_sim, g_selected_bee_index, g_selected_bee_epoch);
+    }
+    g_selected_bee_epoch = epoch;
+}
+
+// Re-applies the renderer's detail region to a sim that was replaced or
+// restored with another one.
+static void app_sim_apply_detail_region(void) {
+    if (g_sim && g_detail_region) {
+        sim_set_detail_region(g_sim, g_detail_rect[0], g_detail_rect[1], g_detail_rect[2], g_detail_rect[3]);
+    }
+}
+
+static void app_sim_tick(void) {
+    sim_tick(g_sim, g_sim_fixed_dt);
+    sim_rewind_capture(g_rewind, g_sim);
+    app_sim_follow_selected_bee();
+    ++g_ticks_total;
+    g_sim_seconds_total += (double)g_sim_fixed_dt;
+}
+
+static void app_sim_apply_params(const Params *new_params, bool reinit_required) {
+    if (reinit_required) {
+        SimState *fresh = NULL;
+        if (!sim_init(&fresh, new_params)) {
+            LOG_ERROR("sim reinit failed; keeping previous simulation");
+            return;
+        }
+        sim_shutdown(g_sim);
+        g_sim = fresh;
+        sim_bind_hex_world(g_sim, &g_hex_world);
+        sim_journal_note_params(g_journal, g_sim, SIM_JOURNAL_REINIT, new_params);
+        sim_set_journal(g_sim, g_journal);
+        app_sim_apply_detail_region();
+        g_sim_accumulator_sec = 0.0;
+        g_selected_bee_index = SIZE_MAX;
+        g_selected_bee_epoch = sim_compaction_epoch(g_sim);
+    } else if (g_sim) {
+        if (new_params->bee_count != g_params.bee_count &&
+            !sim_set_population(g_sim, new_params->bee_count)) {
+            LOG_WARN("sim: could not resize population to %zu", new_params->bee_count);
+        }
+        sim_apply_runtime_params(g_sim, new_params);
+        app_sim_follow_selected_bee();
+    }
+
+    g_params = *new_params;
+    if (g_params.sim_fixed_dt > 0.0f) {
+        g_sim_fixed_dt = g_params.sim_fixed_dt;
+    }
+
+    if (!hex_world_rebuild(&g_hex_world, &g_params)) {
+        LOG_ERROR("hex: rebuild failed; retaining previous grid");
+    } else {
+        if (g_selected_hex_index >= hex_world_tile_count(&g_hex_world)) {
+            g_selected_hex_index = SIZE_MAX;
+        }
+        if (g_sim) {
+            sim_bind_hex_world(g_sim, &g_hex_world);
+            sim_journal_note_params(g_journal, g_sim, SIM_JOURNAL_HEX_REBUILD, &g_params);
+        }
+    }
+
+    app_sim_rewind_restart();
+    LOG_INFO("ui: applied params (reinit=%d)", reinit_required ? 1 : 0);
+}
+
+static bool app_sim_file_exists(const char *path) {
+    FILE *file = fopen(path, "rb");
+    if (!file) {
+        return false;
+    }
+    fclose(file);
+    return true;
+}
+
+// Saves to colony-<tick>.beesnap, with a counter appended if that name is
+// taken, and makes it the latest checkpoint.
+static void app_sim_save_checkpoint(void) {
+    if (!g_sim) {
+        return;
+    }
+    char path[64];
+    unsigned long long tick = (unsigned long long)sim_tick_index(g_sim);
+    snprintf(path, sizeof path, "colony-%llu.beesnap", tick);
+    for (unsigned copy = 1u; app_sim_file_exists(path); ++copy) {
+        snprintf(path, sizeof path, "colony-%llu-%u.beesnap", tick, copy);
+    }
+    if (!sim_snapshot_save(g_sim, path)) {
+        return;
+    }
+    FILE *latest = fopen(g_checkpoint_latest_path, "w");
+    if (!latest || fputs(path, latest) < 0 || fclose(latest) != 0) {
+        LOG_WARN("app: could not update '%s'", g_checkpoint_latest_path);
+    }
+    LOG_INFO("app: saved checkpoint '%s'", path);
+}
+
+// Replaces the simulation and world with the latest checkpoint. The
+// checkpoint binds the restored sim to g_hex_world, so the current world is
+// moved aside and put back if the load fails.
+static void app_sim_load_checkpoint(void) {
+    char path[64] = {0};
+    FILE *latest = fopen(g_checkpoint_latest_path, "r");
+    if (latest) {
+        if (!fgets(path, sizeof path, latest)) {
+            path[0] = '\0';
+        }
+        fclose(latest);
+    }
+    path[strcspn(path, "\r\n")] = '\0';
+    if (path[0] == '\0') {
+        LOG_WARN("app: no checkpoint saved yet");
+        return;
+    }
+    HexWorld previous_world = g_hex_world;
+    memset(&g_hex_world, 0, sizeof(g_hex_world));
+    SimState *loaded = NULL;
+    if (!sim_snapshot_load(&loaded, &g_hex_world, &g_params, path)) {
+        LOG_WARN("app: could not load checkpoint '%s'", path);
+        g_hex_world = previous_world;
+        return;
+    }
+    sim_shutdown(g_sim);
+    hex_world_shutdown(&previous_world);
+    g_sim = loaded;
+    sim_journal_note_load(g_journal, g_sim, path);
+    sim_set_journal(g_sim, g_journal);
+    app_sim_apply_detail_region();
+    g_sim_accumulator_sec = 0.0;
+    g_selected_bee_index = SIZE_MAX;
+    g_selected_bee_epoch = sim_compaction_epoch(g_sim);
+    g_selected_hex_index = SIZE_MAX;
+    app_sim_rewind_restart();
+    LOG_INFO("app: loaded checkpoint '%s'", path);
+}
+
+// Rewinds to an earlier tick. The journal records only the target tick; a
+// replay seeks its own copy of the ring. Ticks after the keyframe are re-run
+// with the detail region the keyframe holds, so a camera move in between can
+// leave off-screen bees slightly off what was shown.
+static void app_sim_rewind_to(uint64_t tick) {
+    if (!g_sim || !g_rewind) {
+        return;
+    }
+    uint64_t epoch = sim_compaction_epoch(g_sim);
+    sim_journal_note_rewind_seek(g_journal, g_sim, tick, g_sim_fixed_dt);
+    if (!sim_rewind_seek(g_rewind, &g_sim, &g_hex_world, tick, g_sim_fixed_dt, g_params.sim_worker_count)) {
+        LOG_INFO("rewind: tick %llu is no longer available", (unsigned long long)tick);
+        return;
+    }
+    sim_set_journal(g_sim, g_journal);
+    app_sim_apply_detail_region();
+    // Slots only move on compaction; a selection across one is dropped.
+    if (sim_compaction_epoch(g_sim) != epoch) {
+        g_selected_bee_index = SIZE_MAX;
+    }
+    g_selected_bee_epoch = sim_compaction_epoch(g_sim);
+    LOG_INFO("rewind: tick %llu", (unsigned long long)tick);
+}
+
+static void app_sim_pick(float world_x, float world_y, float radius_world) {
+    size_t pooled = sim_pooled_count(g_sim);
+    g_selected_bee_index = g_sim ? sim_pick_bee(g_sim, world_x, world_y, radius_world) : SIZE_MAX;
+    if (sim_pooled_count(g_sim) != pooled) {
+        // A pooled bee was materialized for inspection; the keyframes predate it.
+        app_sim_rewind_restart();
+    }
+    g_selected_hex_index = SIZE_MAX;
+    int pick_q = 0;
+    int pick_r = 0;
+    if (hex_world_tile_count(&g_hex_world) > 0 &&
+        hex_world_pick(&g_hex_world, world_x, world_y, &pick_q, &pick_r)) {
+        g_selected_hex_index = hex_world_index(&g_hex_world, pick_q, pick_r);
+    }
+}
+
+// Returns false on QUIT.
+static bool app_sim_execute(const AppSimCommand *command) {
+    switch (command->type) {
+        case APP_SIM_CMD_TOGGLE_PAUSE:
+            g_sim_paused = !g_sim_paused;
+            sim_journal_note(g_journal, g_sim, g_sim_paused ? SIM_JOURNAL_PAUSE : SIM_JOURNAL_RESUME);
+            LOG_INFO("pause=%d", g_sim_paused ? 1 : 0);
+            break;
+        case APP_SIM_CMD_STEP:
+            if (g_sim && g_sim_paused) {
+                sim_journal_note(g_journal, g_sim, SIM_JOURNAL_STEP);
+                app_sim_tick();
+                LOG_INFO("step one tick (%.3fms)", g_sim_fixed_dt * 1000.0f);
+            }
+            break;
+        case APP_SIM_CMD_STEP_BACK:
+            if (g_sim && g_sim_paused && sim_tick_index(g_sim) > 0) {
+                app_sim_rewind_to(sim_tick_index(g_sim) - 1u);
+            }
+            break;
+        case APP_SIM_CMD_APPLY_PARAMS:
+            app_sim_apply_params(&command->u.apply.params, command->u.apply.reinit);
+            break;
+        case APP_SIM_CMD_PICK:
+            app_sim_pick(command->u.pick.world_x, command->u.pick.world_y, command->u.pick.radius_world);
+            break;
+        case APP_SIM_CMD_FOCUS_QUEEN:
+            if (g_sim && sim_live_count(g_sim) > 0) {
+                g_selected_bee_index = 0;
+            }
+            break;
+        case APP_SIM_CMD_SET_HEATMAP:
+            g_heatmap = command->u.enabled;
+            break;
+        case APP_SIM_CMD_SET_SPEED:
+            g_speed_multiple = command->u.speed_multiple > 0.0f ? command->u.speed_multiple : 0.0f;
+            g_sim_accumulator_sec = 0.0;
+            break;
+        case APP_SIM_CMD_SET_DETAIL_REGION:
+            g_detail_region = true;
+            g_detail_rect[0] = command->u.region.min_x;
+            g_detail_rect[1] = command->u.region.min_y;
+            g_detail_rect[2] = command->u.region.max_x;
+            g_detail_rect[3] = command->u.region.max_y;
+            app_sim_apply_detail_region();
+            break;
+        case APP_SIM_CMD_SAVE:
+            app_sim_save_checkpoint();
+            break;
+        case APP_SIM_CMD_LOAD:
+            app_sim_load_checkpoint();
+            break;
+        case APP_SIM_CMD_QUIT:
+            return false;
+    }
+    return true;
+}
+
+// Grows a frame array to hold count elements; only the producer calls this,
+// and only on its own write slot.
+static bool app_sim_reserve(void **array, size_t *capacity, size_t count, size_t elem_size) {
+    if (count <= *capacity) {
+        return true;
+    }
+    size_t grown = *capacity ? *capacity : 1024u;
+    while (grown < count) {
+        grown *= 2u;
+    }
+    void *resized = realloc(*array, grown * elem_size);
+    if (!resized) {
+        return false;
+    }
+    *array = resized;
+    *capacity = grown;
+    return true;
+}
+
+static bool app_sim_reserve_bees(AppSimFrame *frame, size_t count) {
+    size_t capacity = frame->bee_capacity;
+    bool ok = app_sim_reserve((void **)&frame->positions_xy, &capacity, count, 2u * sizeof(float));
+    capacity = frame->bee_capacity;
+    ok = ok && app_sim_reserve((void **)&frame->radii_px, &capacity, count, sizeof(float));
+    capacity = frame->bee_capacity;
+    ok = ok && app_sim_reserve((void **)&frame->color_rgba, &capacity, count, sizeof(uint32_t));
+    if (ok) {
+        frame->bee_capacity = capacity;
+    }
+    return ok;
+}
+
+static bool app_sim_reserve_hexes(AppSimFrame *frame, size_t count) {
+    size_t capacity = frame->hex_capacity;
+    bool ok = app_sim_reserve((void **)&frame->hex_centers_xy, &capacity, count, 2u * sizeof(float));
+    capacity = frame->hex_capacity;
+    ok = ok && app_sim_reserve((void **)&frame->hex_fill_rgba, &capacity, count, sizeof(uint32_t));
+    if (ok) {
+        frame->hex_capacity = capacity;
+    }
+    return ok;
+}
+
+// Copies everything the render thread draws or inspects into the write slot
+// and publishes it.
+static void app_sim_publish(void) {
+    AppSimFrame *frame = &g_frame_slots[spsc_triple_buffer_write_slot(g_frames)];
+    frame->commands_done = g_commands_done;
+    frame->tick = g_sim ? sim_tick_index(g_sim) : 0;
+    frame->ticks_total = g_ticks_total;
+    frame->sim_seconds_total = g_sim_seconds_total;
+    frame->accumulator_sec = g_sim_accumulator_sec;
+    frame->speed_multiple = g_speed_multiple;
+    frame->paused = g_sim_paused;
+    frame->params = g_params;
+
+    frame->bee_count = 0;
+    if (g_sim) {
+        RenderView view = sim_build_view(g_sim);
+        if (app_sim_reserve_bees(frame, view.count)) {
+            memcpy(frame->positions_xy, view.positions_xy, view.count * 2u * sizeof(float));
+            memcpy(frame->radii_px, view.radii_px, view.count * sizeof(float));
+            memcpy(frame->color_rgba, view.color_rgba, view.count * sizeof(uint32_t));
+            frame->bee_count = view.count;
+        } else {
+            LOG_WARN("app: frame allocation failed; bees not drawn");
+        }
+    }
+
+    frame->hex_count = 0;
+    size_t hex_count = hex_world_tile_count(&g_hex_world);
+    if (hex_count > 0) {
+        hex_world_apply_palette(&g_hex_world, g_heatmap);
+        if (app_sim_reserve_hexes(frame, hex_count)) {
+            memcpy(frame->hex_centers_xy, hex_world_centers_xy(&g_hex_world), hex_count * 2u * sizeof(float));
+            memcpy(frame->hex_fill_rgba, hex_world_colors_rgba(&g_hex_world), hex_count * sizeof(uint32_t));
+            frame->hex_count = hex_count;
+        } else {
+            LOG_WARN("app: frame allocation failed; hex grid not drawn");
+        }
+    }
+    frame->hex_cell_radius = hex_world_cell_radius(&g_hex_world);
+
+    if (g_selected_bee_index != SIZE_MAX &&
+        (!g_sim || !sim_get_bee_info(g_sim, g_selected_bee_index, &frame->bee_info))) {
+        g_selected_bee_index = SIZE_MAX;
+    }
+    frame->selected_bee = g_selected_bee_index;
+
+    if (g_selected_hex_index != SIZE_MAX) {
+        if (hex_world_tile_debug_info(&g_hex_world, g_selected_hex_index, &frame->hex_info)) {
+            hex_world_tile_corners(&g_hex_world, frame->hex_info.q, frame->hex_info.r, frame->hex_corners);
+        } else {
+            g_selected_hex_index = SIZE_MAX;
+        }
+    }
+    frame->selected_hex = g_selected_hex_index;
+
+    spsc_triple_buffer_publish(g_frames);
+}
+
+#ifdef _WIN32
+static DWORD WINAPI app_sim_thread_main(LPVOID arg)
+#else
+static void *app_sim_thread_main(void *arg)
+#endif
+{
+    (void)arg;
+    double last_sec = app_sim_now_sec();
+    bool running = true;
+    while (running) {
+        bool changed = false;
+        AppSimCommand command;
+        while (spsc_queue_pop(g_commands, &command)) {
+            ++g_commands_done;
+            changed = true;
+            if (!app_sim_execute(&command)) {
+                running = false;
+                break;
+            }
+        }
+        if (!running) {
+            break;
+        }
+
+        double now_sec = app_sim_now_sec();
+        double elapsed_sec = now_sec - last_sec;
+        last_sec = now_sec;
+        unsigned ticks = 0;
+        if (!g_sim_paused && g_sim) {
+            bool flat_out = g_speed_multiple <= 0.0f;
+            if (!flat_out) {
+                double speed = (double)g_speed_multiple;
+                g_sim_accumulator_sec += elapsed_sec * speed;
+                if (g_sim_accumulator_sec > g_sim_max_accumulator * speed) {
+                    g_sim_accumulator_sec = g_sim_max_accumulator * speed;
+                }
+            }
+            while (flat_out || g_sim_accumulator_sec >= (double)g_sim_fixed_dt) {
+                app_sim_tick();
+                ++ticks;
+                if (!flat_out) {
+                    g_sim_accumulator_sec -= (double)g_sim_fixed_dt;
+                }
+                if (app_sim_now_sec() - now_sec >= g_sim_batch_budget_sec) {
+                    break;
+                }
+            }
+        }
+
+        if (ticks > 0 || changed) {
+            app_sim_publish();
+        } else {
+            app_sim_sleep_ms(1u);
+        }
+    }
+#ifdef _WIN32
+    return 0;
+#else
+    return NULL;
+#endif
+}
+
+static void app_sim_release(void) {
+    sim_set_journal(g_sim, NULL);
+    if (!sim_journal_close(g_journal, g_sim)) {
+        LOG_WARN("app: session journal '%s' is incomplete", g_journal_path);
+    }
+    g_journal = NULL;
+    sim_rewind_destroy(g_rewind);
+    g_rewind = NULL;
+    sim_shutdown(g_sim);
+    g_sim = NULL;
+    hex_world_shutdown(&g_hex_world);
+    memset(&g_hex_world, 0, sizeof(g_hex_world));
+    for (size_t i = 0; i < 3u; ++i) {
+        AppSimFrame *frame = &g_frame_slots[i];
+        free(frame->positions_xy);
+        free(frame->radii_px);
+        free(frame->color_rgba);
+        free(frame->hex_centers_xy);
+        free(frame->hex_fill_rgba);
+        memset(frame, 0, sizeof(*frame));
+    }
+    spsc_triple_buffer_destroy(g_frames);
+    g_frames = NULL;
+    spsc_queue_destroy(g_commands);
+    g_commands = NULL;
+}
+
+bool app_sim_start(const Params *params) {
+    if (g_started || !params) {
+        return false;
+    }
+    g_params = *params;
+    g_sim_fixed_dt = g_params.sim_fixed_dt > 0.0f ? g_params.sim_fixed_dt : 1.0f / 120.0f;
+    g_sim_accumulator_sec = 0.0;
+    g_sim_paused = false;
+    g_speed_multiple = 1.0f;
+    g_heatmap = false;
+    g_selected_bee_index = SIZE_MAX;
+    g_selected_hex_index = SIZE_MAX;
+    g_commands_done = 0;
+    g_commands_sent = 0;
+    g_ticks_total = 0;
+    g_sim_seconds_total = 0.0;
+
+    if (!spsc_queue_create(&g_commands, sizeof(AppSimCommand), g_command_capacity) ||
+        !spsc_triple_buffer_create(&g_frames)) {
+        LOG_ERROR("app: sim thread handoff allocation failed");
+        app_sim_release();
+        return false;
+    }
+    if (!hex_world_init(&g_hex_world, &g_params)) {
+        LOG_ERROR("Hex world initialization failed");
+        app_sim_release();
+        return false;
+    }
+    if (!sim_init(&g_sim, &g_params)) {
+        LOG_ERROR("Simulation initialization failed");
+        app_sim_release();
+        return false;
+    }
+    sim_bind_hex_world(g_sim, &g_hex_world);
+    g_selected_bee_epoch = sim_compaction_epoch(g_sim);
+    if (sim_journal_open(&g_journal, g_journal_path, 0)) {
+        sim_journal_note_params(g_journal, g_sim, SIM_JOURNAL_INIT, &g_params);
+        sim_set_journal(g_sim, g_journal);
+    } else {
+        LOG_WARN("app: session journal '%s' unavailable; not recording", g_journal_path);
+    }
+    if (sim_rewind_create(&g_rewind, g_rewind_interval_ticks, g_rewind_max_keyframes, g_rewind_max_bytes)) {
+        app_sim_rewind_restart();
+    } else {
+        LOG_WARN("app: rewind unavailable");
+    }
+    // Published before the thread exists, so the first acquire always has a
+    // frame.
+    app_sim_publish();
+
+#ifdef _WIN32
+    g_thread = CreateThread(NULL, 0, app_sim_thread_main, NULL, 0, NULL);
+    bool thread_ok = g_thread != NULL;
+#else
+    bool thread_ok = pthread_create(&g_thread, NULL, app_sim_thread_main, NULL) == 0;
+#endif
+    if (!thread_ok) {
+        LOG_ERROR("app: failed to start sim thread");
+        app_sim_release();
+        return false;
+    }
+    g_started = true;
+    LOG_INFO("app_init: sim ready");
+    return true;
+}
+
+void app_sim_stop(void) {
+    if (!g_started) {
+        return;
+    }
+    AppSimCommand quit = {0};
+    quit.type = APP_SIM_CMD_QUIT;
+    while (!spsc_queue_push(g_commands, &quit)) {
+        app_sim_sleep_ms(1u);
+    }
+#ifdef _WIN32
+    WaitForSingleObject(g_thread, INFINITE);
+    CloseHandle(g_thread);
+#else
+    pthread_join(g_thread, NULL);
+#endif
+    g_started = false;
+    app_sim_release();
+}
+
+bool app_sim_send(const AppSimCommand *command) {
+    if (!g_started || !command) {
+        return false;
+    }
+    if (!spsc_queue_push(g_commands, command)) {
+        LOG_WARN("app: sim command queue full; dropped command %d", (int)command->type);
+        return false;
+    }
+    ++g_commands_sent;
+    return true;
+}
+
+const AppSimFrame *app_sim_acquire_frame(void) {
+    if (!g_started) {
+        return NULL;
+    }
+    spsc_triple_buffer_acquire(g_frames);
+    return &g_frame_slots[spsc_triple_buffer_read_slot(g_frames)];
+}
+
+uint64_t app_sim_commands_sent(void) {
+    return g_commands_sent;
+}
@@ -0,0 +1,118 @@
+#ifndef APP_SIM_H
+#define APP_SIM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "bee.h"
+#include "hex.h"
+#include "params.h"
+
+// The simulation thread of the windowed app. It owns the SimState, HexWorld,
+// session journal and rewind ring; nothing else touches them while it runs.
+// The render thread talks to it only through an SPSC command queue and reads
+// it only through frames published over a triple buffer, so a slow tick never
+// stalls input or presentation and a slow frame never starves the sim.
+//
+// Ticks are paced to speed_multiple times wall-clock time, or run flat out
+// when it is 0, but each batch stops after a fixed CPU budget so a frame is
+// published (and commands are read) several times per second however slow
+// the ticks get. Only the state at the end of a batch is published; the
+// renderer never sees the ticks in between.
+//
+// The renderer keys the simulation's level of detail to the camera: flight
+// outside the detail region it sends is simulated coarsely. The thread keeps
+// applying the last region across reinit, checkpoint loads and rewinds.
+
+typedef enum AppSimCommandType {
+    APP_SIM_CMD_TOGGLE_PAUSE = 0,
+    APP_SIM_CMD_STEP,          // one tick; ignored unless paused
+    APP_SIM_CMD_STEP_BACK,     // rewind one tick; ignored unless paused
+    APP_SIM_CMD_APPLY_PARAMS,  // apply.params, apply.reinit
+    APP_SIM_CMD_PICK,          // select the bee and hex tile under pick
+    APP_SIM_CMD_FOCUS_QUEEN,   // select bee 0
+    APP_SIM_CMD_SET_HEATMAP,   // hex fill shows nectar stock
+    APP_SIM_CMD_SET_SPEED,     // speed_multiple
+    APP_SIM_CMD_SET_DETAIL_REGION,  // region: world rectangle kept at full fidelity
+    APP_SIM_CMD_SAVE,
+    APP_SIM_CMD_LOAD,
+    APP_SIM_CMD_QUIT,
+} AppSimCommandType;
+
+typedef struct AppSimCommand {
+    AppSimCommandType type;
+    union {
+        struct {
+            Params params;  // already validated
+            bool reinit;
+        } apply;
+        struct {
+            float world_x;
+            float world_y;
+            float radius_world;
+        } pick;
+        bool enabled;
+        float speed_multiple;  // sim seconds per wall second; 0 runs flat out
+        struct {
+            float min_x;
+            float min_y;
+            float max_x;
+            float max_y;
+        } region;
+    } u;
+} AppSimCommand;
+
+// One published view of the simulation. Arrays belong to the frame and stay
+// valid until the next app_sim_acquire_frame.
+typedef struct AppSimFrame {
+    uint64_t commands_done;    // commands processed before this frame
+    uint64_t tick;             // sim_tick_index
+    uint64_t ticks_total;      // ticks run by the thread, never rewound
+    double sim_seconds_total;  // sim time of ticks_total
+    double accumulator_sec;
+    float speed_multiple;
+    bool paused;
+    Params params;  // as last applied
+
+    size_t bee_count;
+    size_t bee_capacity;
+    float *positions_xy;
+    float *radii_px;
+    uint32_t *color_rgba;
+
+    size_t hex_count;
+    size_t hex_capacity;
+    float *hex_centers_xy;
+    uint32_t *hex_fill_rgba;
+    float hex_cell_radius;
+
+    size_t selected_bee;  // SIZE_MAX when none
+    BeeDebugInfo bee_info;
+    size_t selected_hex;  // SIZE_MAX when none
+    HexTileDebugInfo hex_info;
+    float hex_corners[6][2];
+} AppSimFrame;
+
+bool app_sim_start(const Params *params);
+// Creates the world, simulation, journal and rewind ring from params,
+// publishes a first frame and starts the thread. Returns false, with nothing
+// left running, if the world, simulation or thread cannot be created.
+
+void app_sim_stop(void);
+// Sends QUIT, joins the thread and frees everything it owned; safe to call
+// when not started.
+
+bool app_sim_send(const AppSimCommand *command);
+// Queues a command. Returns false when the queue is full and the command was
+// dropped. Render thread only.
+
+const AppSimFrame *app_sim_acquire_frame(void);
+// Returns the newest published frame, or the previous one when nothing new
+// was published. Render thread only.
+
+uint64_t app_sim_commands_sent(void);
+// Number of commands queued so far; a frame with commands_done at or above a
+// value taken after a send reflects that command.
+
+#endif  // APP_SIM_H
@@ -42,6 +42,8 @@ void params_init_defaults(Params *params) {
     params->world_width_px = (float)params->window_width_px;
     params->world_height_px = (float)params->window_height_px;
     params->sim_fixed_dt = 1.0f / 120.0f;
+    params->sim_worker_count = 1;
+    params->sim_compact_state = false;
     params->motion_min_speed = 10.0f;
     params->motion_max_speed = 80.0f;
     params->motion_jitter_deg_per_sec = 15.0f;
@@ -182,6 +184,13 @@ bool params_validate(const Params *params, char *err_buf, size_t err_cap) {
         }
         return false;
     }
+    if (params->sim_worker_count == 0 || params->sim_worker_count > 64) {
+        if (err_buf && err_cap > 0) {
+            snprintf(err_buf, err_cap,
+                     "sim_worker_count (%zu) must be within [1, 64]", params->sim_worker_count);
+        }
+        return false;
+    }
     if (params->motion_min_speed <= 0.0f) {
         if (err_buf && err_cap > 0) {
             snprintf(err_buf, err_cap, "motion_min_speed (%f) must be > 0", params->motion_min_speed);
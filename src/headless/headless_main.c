@@ -0,0 +1,476 @@
+#include <errno.h>
+#include <inttypes.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#endif
+
+#include "hex.h"
+#include "params.h"
+#include "sim.h"
+#include "sim_journal.h"
+#include "sim_rewind.h"
+#include "util/log.h"
+
+typedef struct HeadlessOptions {
+    size_t bee_count;
+    uint64_t tick_count;
+    uint64_t seed;
+    size_t thread_count;
+    SimKinematicsKernel kernel;
+    bool mode_buckets;
+    bool hibernation;
+    bool lazy_recharge;
+    bool multi_rate;
+    bool caste_pools;
+    bool detail_region;
+    float detail_rect[4];  // min x, min y, max x, max y
+    bool compact;
+    float dt_sec;
+    bool verbose;
+    const char *load_path;
+    const char *save_path;
+    const char *record_path;
+    const char *replay_path;
+    uint64_t rewind_interval;
+    uint64_t seek_tick;  // UINT64_MAX: no seek
+} HeadlessOptions;
+
+static double headless_now_sec(void) {
+#ifdef _WIN32
+    LARGE_INTEGER freq;
+    LARGE_INTEGER counter;
+    QueryPerformanceFrequency(&freq);
+    QueryPerformanceCounter(&counter);
+    return (double)counter.QuadPart / (double)freq.QuadPart;
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
+#endif
+}
+
+static void headless_usage(const char *argv0) {
+    fprintf(stderr,
+            "usage: %s [--bees N] [--ticks T] [--seed S] [--threads N] [--kernel K] [--no-buckets]\n"
+            "          [--no-hibernate] [--lazy-recharge] [--multi-rate] [--caste-pools]\n"
+            "          [--compact] [--roi X0,Y0,X1,Y1] [--dt SEC] [--verbose]\n"
+            "          [--load PATH] [--save PATH] [--record PATH] [--replay PATH]\n"
+            "          [--rewind K] [--seek T]\n"
+            "  --bees N     number of bees to simulate (default from params)\n"
+            "  --ticks T    number of fixed-step ticks to run (default 1200)\n"
+            "  --seed S     RNG seed, decimal or 0x-prefixed hex (default from params)\n"
+            "  --threads N  sim_tick worker threads including the main one (default 1)\n"
+            "  --kernel K   kinematics kernel: auto, scalar, sse2 or avx2 (default auto)\n"
+            "  --no-buckets run every bee through the generic path (reference for the\n"
+            "               per-mode fast paths; implies --no-hibernate)\n"
+            "  --no-hibernate keep resting in-hive bees ticking instead of parking them\n"
+            "  --lazy-recharge evaluate nectar recharge when a tile is read instead of\n"
+            "               recharging every floral tile each tick\n"
+            "  --multi-rate advance held foraging/unloading bees every 4th tick and idle\n"
+            "               bees every 8th, each covering the skipped time\n"
+            "  --caste-pools hold settled in-hive nurses, housekeepers and storage bees\n"
+            "               as counts per role and age day instead of as agents\n"
+            "  --compact    store bee energy and load in 16-bit fixed point and derive\n"
+            "               heading, radius and color instead of storing them\n"
+            "  --roi X0,Y0,X1,Y1 keep full fidelity in this world rectangle only; flight\n"
+            "               elsewhere flies straight legs without path planning\n"
+            "  --dt SEC     fixed tick length in seconds (default from params)\n"
+            "  --verbose    keep sim INFO logging enabled while running\n"
+            "  --load PATH  start from a checkpoint instead of a fresh colony (the\n"
+            "               bee, seed and mode options are taken from the checkpoint)\n"
+            "  --save PATH  write a checkpoint after the last tick\n"
+            "  --record PATH journal the run for exact replay\n"
+            "  --replay PATH re-run a journal (only --threads applies) and check its\n"
+            "               state hashes; exits with 3 on divergence\n"
+            "  --rewind K   keep a rewind keyframe every K ticks (default 120 with --seek)\n"
+            "  --seek T     after the run, rewind to tick T and print its state hash\n",
+            argv0 ? argv0 : "bee_sim_headless");
+}
+
+static bool headless_parse_u64(const char *text, uint64_t *out_value) {
+    if (!text || !*text || !out_value) {
+        return false;
+    }
+    errno = 0;
+    char *end = NULL;
+    unsigned long long value = strtoull(text, &end, 0);
+    if (errno != 0 || !end || *end != '\0') {
+        return false;
+    }
+    *out_value = (uint64_t)value;
+    return true;
+}
+
+static bool headless_parse_float(const char *text, float *out_value) {
+    if (!text || !*text || !out_value) {
+        return false;
+    }
+    errno = 0;
+    char *end = NULL;
+    float value = strtof(text, &end);
+    if (errno != 0 || !end || *end != '\0') {
+        return false;
+    }
+    *out_value = value;
+    return true;
+}
+
+static bool headless_parse_rect(const char *text, float out_rect[4]) {
+    if (!text || !*text || !out_rect) {
+        return false;
+    }
+    const char *cursor = text;
+    for (int k = 0; k < 4; ++k) {
+        errno = 0;
+        char *end = NULL;
+        out_rect[k] = strtof(cursor, &end);
+        if (errno != 0 || !end || end == cursor || *end != (k < 3 ? ',' : '\0')) {
+            return false;
+        }
+        cursor = end + 1;
+    }
+    return out_rect[0] <= out_rect[2] && out_rect[1] <= out_rect[3];
+}
+
+static bool headless_parse_kernel(const char *text, SimKinematicsKernel *out_kernel) {
+    static const SimKinematicsKernel kernels[] = {
+        SIM_KINEMATICS_AUTO, SIM_KINEMATICS_SCALAR, SIM_KINEMATICS_SSE2, SIM_KINEMATICS_AVX2,
+    };
+    if (!text || !out_kernel) {
+        return false;
+    }
+    for (size_t i = 0; i < sizeof kernels / sizeof kernels[0]; ++i) {
+        if (strcmp(text, sim_kinematics_kernel_name(kernels[i])) == 0) {
+            *out_kernel = kernels[i];
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool headless_parse_args(int argc, char **argv, const Params *defaults, HeadlessOptions *out) {
+    out->bee_count = defaults->bee_count;
+    out->tick_count = 1200;
+    out->seed = defaults->rng_seed;
+    out->thread_count = defaults->sim_worker_count;
+    out->kernel = SIM_KINEMATICS_AUTO;
+    out->mode_buckets = true;
+    out->hibernation = true;
+    out->lazy_recharge = false;
+    out->multi_rate = false;
+    out->caste_pools = false;
+    out->detail_region = false;
+    out->compact = false;
+    out->dt_sec = defaults->sim_fixed_dt;
+    out->verbose = false;
+    out->load_path = NULL;
+    out->save_path = NULL;
+    out->record_path = NULL;
+    out->replay_path = NULL;
+    out->rewind_interval = 0;
+    out->seek_tick = UINT64_MAX;
+
+    for (int i = 1; i < argc; ++i) {
+        const char *arg = argv[i];
+        const char *value = (i + 1 < argc) ? argv[i + 1] : NULL;
+        uint64_t u64 = 0;
+        if (strcmp(arg, "--bees") == 0) {
+            if (!headless_parse_u64(value, &u64) || u64 == 0) {
+                LOG_ERROR("headless: --bees expects a positive integer");
+                return false;
+            }
+            out->bee_count = (size_t)u64;
+            ++i;
+        } else if (strcmp(arg, "--ticks") == 0) {
+            if (!headless_parse_u64(value, &u64)) {
+                LOG_ERROR("headless: --ticks expects a non-negative integer");
+                return false;
+            }
+            out->tick_count = u64;
+            ++i;
+        } else if (strcmp(arg, "--seed") == 0) {
+            if (!headless_parse_u64(value, &u64)) {
+                LOG_ERROR("headless: --seed expects an integer");
+                return false;
+            }
+            out->seed = u64;
+            ++i;
+        } else if (strcmp(arg, "--threads") == 0) {
+            if (!headless_parse_u64(value, &u64) || u64 == 0) {
+                LOG_ERROR("headless: --threads expects a positive integer");
+                return false;
+            }
+            out->thread_count = (size_t)u64;
+            ++i;
+        } else if (strcmp(arg, "--kernel") == 0) {
+            if (!headless_parse_kernel(value, &out->kernel)) {
+                LOG_ERROR("headless: --kernel expects auto, scalar, sse2 or avx2");
+                return false;
+            }
+            ++i;
+        } else if (strcmp(arg, "--no-buckets") == 0) {
+            out->mode_buckets = false;
+        } else if (strcmp(arg, "--no-hibernate") == 0) {
+            out->hibernation = false;
+        } else if (strcmp(arg, "--lazy-recharge") == 0) {
+            out->lazy_recharge = true;
+        } else if (strcmp(arg, "--multi-rate") == 0) {
+            out->multi_rate = true;
+        } else if (strcmp(arg, "--caste-pools") == 0) {
+            out->caste_pools = true;
+        } else if (strcmp(arg, "--roi") == 0) {
+            if (!headless_parse_rect(value, out->detail_rect)) {
+                LOG_ERROR("headless: --roi expects X0,Y0,X1,Y1 with X0 <= X1 and Y0 <= Y1");
+                return false;
+            }
+            out->detail_region = true;
+            ++i;
+        } else if (strcmp(arg, "--compact") == 0) {
+            out->compact = true;
+        } else if (strcmp(arg, "--dt") == 0) {
+            if (!headless_parse_float(value, &out->dt_sec) || out->dt_sec <= 0.0f) {
+                LOG_ERROR("headless: --dt expects a positive number of seconds");
+                return false;
+            }
+            ++i;
+        } else if (strcmp(arg, "--rewind") == 0) {
+            if (!headless_parse_u64(value, &out->rewind_interval) || out->rewind_interval == 0) {
+                LOG_ERROR("headless: --rewind expects a positive number of ticks");
+                return false;
+            }
+            ++i;
+        } else if (strcmp(arg, "--seek") == 0) {
+            if (!headless_parse_u64(value, &out->seek_tick) || out->seek_tick == UINT64_MAX) {
+                LOG_ERROR("headless: --seek expects a tick number");
+                return false;
+            }
+            ++i;
+        } else if (strcmp(arg, "--verbose") == 0) {
+            out->verbose = true;
+        } else if (strcmp(arg, "--load") == 0 || strcmp(arg, "--save") == 0 || strcmp(arg, "--record") == 0 ||
+                   strcmp(arg, "--replay") == 0) {
+            if (!value) {
+                LOG_ERROR("headless: %s expects a file path", arg);
+                return false;
+            }
+            if (strcmp(arg, "--load") == 0) {
+                out->load_path = value;
+            } else if (strcmp(arg, "--save") == 0) {
+                out->save_path = value;
+            } else if (strcmp(arg, "--record") == 0) {
+                out->record_path = value;
+            } else {
+                out->replay_path = value;
+            }
+            ++i;
+        } else if (strcmp(arg, "--help") == 0 || strcmp(arg, "-h") == 0) {
+            headless_usage(argv[0]);
+            exit(0);
+        } else {
+            LOG_ERROR("headless: unknown argument '%s'", arg);
+            return false;
+        }
+    }
+    return true;
+}
+
+static int headless_replay(const HeadlessOptions *options) {
+    double start_sec = headless_now_sec();
+    SimReplayReport report;
+    bool ok = sim_journal_replay(options->replay_path, options->thread_count, &report);
+    double elapsed_sec = headless_now_sec() - start_sec;
+    if (!ok) {
+        LOG_ERROR("headless: failed to replay journal '%s'", options->replay_path);
+        return 1;
+    }
+    printf("replay=%s events=%" PRIu64 " ticks=%" PRIu64 " threads=%zu elapsed=%.3fs\n",
+           options->replay_path,
+           report.events,
+           report.ticks,
+           options->thread_count,
+           elapsed_sec);
+    printf("hashes_checked=%" PRIu64 " hashes_mismatched=%" PRIu64 "\n", report.hashes_checked, report.hashes_mismatched);
+    if (report.first_divergence_tick != UINT64_MAX) {
+        printf("first_divergence_tick=%" PRIu64 "\n", report.first_divergence_tick);
+    }
+    printf("state_hash=0x%016" PRIx64 "\n", report.final_hash);
+    return report.first_divergence_tick == UINT64_MAX ? 0 : 3;
+}
+
+int main(int argc, char **argv) {
+    log_init();
+
+    Params params;
+    params_init_defaults(&params);
+
+    HeadlessOptions options;
+    if (!headless_parse_args(argc, argv, &params, &options)) {
+        headless_usage(argv[0]);
+        log_shutdown();
+        return 2;
+    }
+
+    params.bee_count = options.bee_count;
+    params.rng_seed = options.seed;
+    params.sim_worker_count = options.thread_count;
+    params.sim_fixed_dt = options.dt_sec;
+    params.sim_compact_state = options.compact;
+
+    char err[256];
+    if (!params_validate(&params, err, sizeof err)) {
+        LOG_ERROR("headless: params validation failed: %s", err);
+        log_shutdown();
+        return 2;
+    }
+
+    log_set_level(options.verbose ? LOG_LEVEL_INFO : LOG_LEVEL_WARN);
+
+    if (options.replay_path) {
+        int replay_status = headless_replay(&options);
+        log_shutdown();
+        return replay_status;
+    }
+
+    SimJournal *journal = NULL;
+    if (options.record_path && !sim_journal_open(&journal, options.record_path, 0)) {
+        LOG_ERROR("headless: failed to create journal '%s'", options.record_path);
+        log_shutdown();
+        return 1;
+    }
+
+    HexWorld world = {0};
+    SimState *sim = NULL;
+    if (options.load_path) {
+        if (!sim_snapshot_load(&sim, &world, &params, options.load_path)) {
+            LOG_ERROR("headless: failed to load checkpoint '%s'", options.load_path);
+            sim_journal_close(journal, NULL);
+            log_shutdown();
+            return 1;
+        }
+        sim_journal_note_load(journal, sim, options.load_path);
+        sim_set_journal(sim, journal);
+        sim_set_kinematics_kernel(sim, options.kernel);
+        options.bee_count = sim_live_count(sim);
+    } else {
+        if (!hex_world_init(&world, &params)) {
+            LOG_ERROR("headless: hex world initialization failed");
+            sim_journal_close(journal, NULL);
+            log_shutdown();
+            return 1;
+        }
+        if (!sim_init(&sim, &params)) {
+            LOG_ERROR("headless: simulation initialization failed");
+            hex_world_shutdown(&world);
+            sim_journal_close(journal, NULL);
+            log_shutdown();
+            return 1;
+        }
+        sim_bind_hex_world(sim, &world);
+        sim_journal_note_params(journal, sim, SIM_JOURNAL_INIT, &params);
+        sim_set_journal(sim, journal);
+        sim_set_kinematics_kernel(sim, options.kernel);
+        sim_set_mode_buckets(sim, options.mode_buckets);
+        sim_set_hibernation(sim, options.mode_buckets && options.hibernation);
+        sim_set_lazy_recharge(sim, options.lazy_recharge);
+        sim_set_multi_rate(sim, options.mode_buckets && options.multi_rate);
+        sim_set_caste_pools(sim, options.mode_buckets && options.hibernation && options.caste_pools);
+        if (options.detail_region) {
+            sim_set_detail_region(sim,
+                                  options.detail_rect[0],
+                                  options.detail_rect[1],
+                                  options.detail_rect[2],
+                                  options.detail_rect[3]);
+        }
+    }
+    sim_set_inspection(sim, false);
+
+    // Headless keeps every keyframe of the run.
+    SimRewind *rewind = NULL;
+    if (options.rewind_interval > 0 || options.seek_tick != UINT64_MAX) {
+        uint64_t interval = options.rewind_interval > 0 ? options.rewind_interval : 120u;
+        size_t keyframes = (size_t)(options.tick_count / interval) + 2u;
+        if (sim_rewind_create(&rewind, interval, keyframes, 0)) {
+            sim_journal_note_rewind_restart(journal, sim, interval, keyframes, 0);
+        } else {
+            LOG_ERROR("headless: failed to create the rewind ring");
+        }
+    }
+    sim_rewind_capture(rewind, sim);
+
+    double start_sec = headless_now_sec();
+    for (uint64_t tick = 0; tick < options.tick_count; ++tick) {
+        sim_tick(sim, options.dt_sec);
+        sim_rewind_capture(rewind, sim);
+    }
+    double elapsed_sec = headless_now_sec() - start_sec;
+
+    double ticks_per_sec = elapsed_sec > 0.0 ? (double)options.tick_count / elapsed_sec : 0.0;
+    double bee_ticks = (double)options.tick_count * (double)options.bee_count;
+    double ns_per_bee_tick = bee_ticks > 0.0 ? elapsed_sec * 1e9 / bee_ticks : 0.0;
+
+    printf("bees=%zu ticks=%" PRIu64 " seed=0x%" PRIx64 " threads=%zu kernel=%s buckets=%s dt=%.6f\n",
+           options.bee_count,
+           options.tick_count,
+           options.seed,
+           options.thread_count,
+           sim_kinematics_kernel_name(sim_get_kinematics_kernel(sim)),
+           options.mode_buckets ? "on" : "off",
+           options.dt_sec);
+    printf("elapsed=%.3fs sim_time=%.2fs ticks/sec=%.1f ns/bee-tick=%.2f\n",
+           elapsed_sec,
+           (double)options.tick_count * (double)options.dt_sec,
+           ticks_per_sec,
+           ns_per_bee_tick);
+    printf("parked=%zu pooled=%zu bee_state_bytes=%zu\n",
+           sim_parked_count(sim),
+           sim_pooled_count(sim),
+           sim_bee_state_bytes(sim));
+    printf("hive_honey_uL=%.3f\n", (double)hex_world_hive_total_honey(&world));
+    printf("state_hash=0x%016" PRIx64 "\n", sim_state_hash(sim));
+
+    int status = 0;
+    if (rewind) {
+        SimRewindStats stats;
+        sim_rewind_get_stats(rewind, &stats);
+        printf("rewind_keyframes=%zu rewind_bytes=%zu rewind_shared_bytes=%zu\n",
+               stats.keyframes,
+               stats.bytes,
+               stats.shared_bytes);
+    }
+    if (options.seek_tick != UINT64_MAX) {
+        double seek_start_sec = headless_now_sec();
+        sim_journal_note_rewind_seek(journal, sim, options.seek_tick, options.dt_sec);
+        if (sim_rewind_seek(rewind, &sim, &world, options.seek_tick, options.dt_sec, options.thread_count)) {
+            sim_set_inspection(sim, false);
+            printf("seek_tick=%" PRIu64 " seek_elapsed=%.3fs state_hash=0x%016" PRIx64 "\n",
+                   options.seek_tick,
+                   headless_now_sec() - seek_start_sec,
+                   sim_state_hash(sim));
+        } else {
+            LOG_ERROR("headless: cannot rewind to tick %" PRIu64, options.seek_tick);
+            status = 1;
+        }
+    }
+    sim_rewind_destroy(rewind);
+    if (options.save_path && !sim_snapshot_save(sim, options.save_path)) {
+        LOG_ERROR("headless: failed to write checkpoint '%s'", options.save_path);
+        status = 1;
+    }
+    sim_set_journal(sim, NULL);
+    if (journal && !sim_journal_close(journal, sim)) {
+        LOG_ERROR("headless: failed to write journal '%s'", options.record_path);
+        status = 1;
+    }
+
+    sim_shutdown(sim);
+    hex_world_shutdown(&world);
+    log_shutdown();
+    return status;
+}
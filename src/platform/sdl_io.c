@@ -22,6 +22,11 @@ typedef struct PlatformState {
     bool prev_key_plus_down;
     bool prev_key_minus_down;
     bool prev_key_reset_down;
+    bool prev_key_save_down;
+    bool prev_key_load_down;
+    bool prev_key_comma_down;
+    bool prev_key_slower_down;
+    bool prev_key_faster_down;
     bool prev_mouse_left_down;
     bool prev_mouse_right_down;
     float prev_mouse_x_px;
@@ -221,6 +226,11 @@ void plat_pump(Platform *plat, Input *out_input, Timing *out_timing) {
     bool plus_down = keyboard ? (keyboard[SDL_SCANCODE_EQUALS] || keyboard[SDL_SCANCODE_KP_PLUS]) : false;
     bool minus_down = keyboard ? (keyboard[SDL_SCANCODE_MINUS] || keyboard[SDL_SCANCODE_KP_MINUS]) : false;
     bool reset_down = keyboard ? (keyboard[SDL_SCANCODE_0] || keyboard[SDL_SCANCODE_KP_0]) : false;
+    bool save_down = keyboard ? keyboard[SDL_SCANCODE_F5] != 0 : false;
+    bool load_down = keyboard ? keyboard[SDL_SCANCODE_F9] != 0 : false;
+    bool comma_down = keyboard ? keyboard[SDL_SCANCODE_COMMA] != 0 : false;
+    bool slower_down = keyboard ? keyboard[SDL_SCANCODE_LEFTBRACKET] != 0 : false;
+    bool faster_down = keyboard ? keyboard[SDL_SCANCODE_RIGHTBRACKET] != 0 : false;
 
     bool escape_pressed = escape_down && !state->prev_key_escape_down;
     bool space_pressed = space_down && !state->prev_key_space_down;
@@ -228,6 +238,11 @@ void plat_pump(Platform *plat, Input *out_input, Timing *out_timing) {
     bool plus_pressed = plus_down && !state->prev_key_plus_down;
     bool minus_pressed = minus_down && !state->prev_key_minus_down;
     bool reset_pressed = reset_down && !state->prev_key_reset_down;
+    bool save_pressed = save_down && !state->prev_key_save_down;
+    bool load_pressed = load_down && !state->prev_key_load_down;
+    bool comma_pressed = comma_down && !state->prev_key_comma_down;
+    bool slower_pressed = slower_down && !state->prev_key_slower_down;
+    bool faster_pressed = faster_down && !state->prev_key_faster_down;
 
     state->prev_key_escape_down = escape_down;
     state->prev_key_space_down = space_down;
@@ -235,6 +250,11 @@ void plat_pump(Platform *plat, Input *out_input, Timing *out_timing) {
     state->prev_key_plus_down = plus_down;
     state->prev_key_minus_down = minus_down;
     state->prev_key_reset_down = reset_down;
+    state->prev_key_save_down = save_down;
+    state->prev_key_load_down = load_down;
+    state->prev_key_comma_down = comma_down;
+    state->prev_key_slower_down = slower_down;
+    state->prev_key_faster_down = faster_down;
     state->prev_mouse_left_down = mouse_left_down;
     state->prev_mouse_right_down = mouse_right_down;
     state->prev_mouse_x_px = mouse_x_px;
@@ -252,6 +272,11 @@ void plat_pump(Platform *plat, Input *out_input, Timing *out_timing) {
     input.key_plus_pressed = plus_pressed;
     input.key_minus_pressed = minus_pressed;
     input.key_reset_pressed = reset_pressed;
+    input.key_save_pressed = save_pressed;
+    input.key_load_pressed = load_pressed;
+    input.key_comma_pressed = comma_pressed;
+    input.key_slower_pressed = slower_pressed;
+    input.key_faster_pressed = faster_pressed;
     input.key_w_down = keyboard ? keyboard[SDL_SCANCODE_W] != 0 : false;
     input.key_a_down = keyboard ? keyboard[SDL_SCANCODE_A] != 0 : false;
     input.key_s_down = keyboard ? keyboard[SDL_SCANCODE_S] != 0 : false;
@@ -1,15 +1,6 @@
 #include "bee.h"
 
-static float bee_rand_uniform01(uint64_t *state) {
-    uint64_t x = *state;
-    x ^= x << 13;
-    x ^= x >> 7;
-    x ^= x << 17;
-    *state = x;
-    return (float)((x >> 11) * (1.0 / 9007199254740992.0));
-}
-
-BeeRole bee_pick_role(float age_days, uint64_t *rng_state) {
+BeeRole bee_pick_role(float age_days, float roll01) {
     if (age_days < 6.0f) {
         return BEE_ROLE_NURSE;
     }
@@ -19,19 +10,33 @@ BeeRole bee_pick_role(float age_days, uint64_t *rng_state) {
     if (age_days < 18.0f) {
         return BEE_ROLE_STORAGE;
     }
-    if (!rng_state) {
-        return BEE_ROLE_FORAGER;
-    }
-    float roll = bee_rand_uniform01(rng_state);
-    if (roll < 0.12f) {
+    if (roll01 < 0.12f) {
         return BEE_ROLE_SCOUT;
     }
-    if (roll < 0.18f) {
+    if (roll01 < 0.18f) {
         return BEE_ROLE_GUARD;
     }
     return BEE_ROLE_FORAGER;
 }
 
+static bool bee_forage_capable(uint8_t role) {
+    return role == BEE_ROLE_FORAGER || role == BEE_ROLE_SCOUT;
+}
+
+bool bee_keeps_resting(uint8_t role, float energy, float state_time, bool patch_valid) {
+    return state_time < BEE_MIN_REST_SEC || energy < BEE_ENERGY_HIGH || !bee_forage_capable(role) || !patch_valid;
+}
+
+bool bee_keeps_harvesting(float energy, float load_ratio, float patch_stock, float patch_capacity, float state_time) {
+    if (energy <= BEE_ENERGY_LOW || load_ratio >= BEE_LOAD_FULL_RATIO || patch_stock <= 1e-3f) {
+        return false;
+    }
+    if (state_time < BEE_MIN_FORAGE_SEC) {
+        return true;
+    }
+    return patch_stock > 0.1f * patch_capacity && state_time < BEE_MAX_FORAGE_SEC;
+}
+
 void bee_decide_next_action(const BeeDecisionContext *ctx, BeeDecisionOutput *out) {
     if (!out) {
         return;
@@ -52,13 +57,13 @@ void bee_decide_next_action(const BeeDecisionContext *ctx, BeeDecisionOutput *ou
 
     const float capacity = ctx->capacity_uL > 0.0f ? ctx->capacity_uL : 1.0f;
     const float load_ratio = ctx->load_uL / capacity;
-    const float load_empty_threshold = 0.05f * capacity;
-    const float load_full_threshold = 0.95f;
-    const float energy_low = 0.28f;
-    const float energy_high = 0.82f;
-    const float min_rest_time = 2.0f;
-    const float min_forage_time = 2.0f;
-    const float max_forage_time = 30.0f;
+    const float load_empty_threshold = BEE_LOAD_EMPTY_RATIO * capacity;
+    const float load_full_threshold = BEE_LOAD_FULL_RATIO;
+    const float energy_low = BEE_ENERGY_LOW;
+    const float energy_high = BEE_ENERGY_HIGH;
+    const float min_rest_time = BEE_MIN_REST_SEC;
+    const float min_forage_time = BEE_MIN_FORAGE_SEC;
+    const float max_forage_time = BEE_MAX_FORAGE_SEC;
 
     uint8_t intent = ctx->previous_intent;
     uint8_t mode = ctx->previous_mode;
@@ -68,7 +73,7 @@ void bee_decide_next_action(const BeeDecisionContext *ctx, BeeDecisionOutput *ou
     }
     float target_x = ctx->forage_target_x;
     float target_y = ctx->forage_target_y;
-    const bool forage_capable = (ctx->role == BEE_ROLE_FORAGER || ctx->role == BEE_ROLE_SCOUT);
+    const bool forage_capable = bee_forage_capable(ctx->role);
 
     if (!ctx->inside_hive) {
         if (ctx->energy <= energy_low || load_ratio >= load_full_threshold) {
@@ -158,6 +163,3 @@ void bee_decide_next_action(const BeeDecisionContext *ctx, BeeDecisionOutput *ou
     result.target_id = target_id;
     *out = result;
 }
-
-
-
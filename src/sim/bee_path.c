@@ -79,12 +79,7 @@ static bool bee_path_point_inside_hive(const SimState *state, float x, float y)
     if (!hex_world_tile_from_world(state->hex_world, x, y, &index)) {
         return false;
     }
-    if (index >= state->hex_world->tile_count) {
-        return false;
-    }
-    HexTerrain terrain = state->hex_world->tiles[index].terrain;
-    return (terrain == HEX_TERRAIN_HIVE_INTERIOR || terrain == HEX_TERRAIN_HIVE_STORAGE ||
-            terrain == HEX_TERRAIN_HIVE_ENTRANCE);
+    return hex_world_tile_in_hive(state->hex_world, index);
 }
 
 static bool bee_path_point_inside_world(const SimState *state, float x, float y, float radius) {
@@ -149,7 +144,7 @@ bool bee_path_plan(const SimState *state,
     const float py = state->y[index];
     const float vx = state->vx[index];
     const float vy = state->vy[index];
-    float radius = state->radius ? state->radius[index] : state->default_radius;
+    float radius = sim_bee_radius(state, index);
     if (radius <= 0.0f) {
         radius = state->default_radius > 0.0f ? state->default_radius : 1.0f;
     }
@@ -2,10 +2,12 @@
 
 #include <float.h>
 #include <math.h>
+#include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
 #ifdef _MSC_VER
+#include <intrin.h>
 #include <malloc.h>
 #endif
 
@@ -13,6 +15,8 @@
 
 #include "sim_internal.h"
 #include "bee_path.h"
+#include "sim_kinematics.h"
+#include "sim_rng.h"
 #include "world/tiles/tile_flower.h"
 
 static void *alloc_aligned(size_t bytes) {
@@ -20,14 +24,14 @@ static void *alloc_aligned(size_t bytes) {
         return NULL;
     }
 #if defined(_MSC_VER)
-    void *ptr = _aligned_malloc(bytes, 16);
+    void *ptr = _aligned_malloc(bytes, SIM_CACHE_LINE_BYTES);
     if (ptr) {
         memset(ptr, 0, bytes);
     }
     return ptr;
 #else
     void *ptr = NULL;
-    if (posix_memalign(&ptr, 16, bytes) != 0) {
+    if (posix_memalign(&ptr, SIM_CACHE_LINE_BYTES, bytes) != 0) {
         return NULL;
     }
     memset(ptr, 0, bytes);
@@ -68,6 +72,7 @@ static void sim_free_floral_index(SimState *state) {
     free(state->floral_tile_indices);
     state->floral_tile_indices = NULL;
     state->floral_tile_count = 0;
+    sim_floral_index_free(&state->floral_tree);
 }
 
 static void sim_rebuild_floral_index(SimState *state) {
@@ -87,7 +92,7 @@ static void sim_rebuild_floral_index(SimState *state) {
     }
     size_t count = 0;
     for (size_t i = 0; i < tile_count; ++i) {
-        if (world->tiles[i].terrain == HEX_TERRAIN_FLOWERS && world->tiles[i].nectar_capacity > 0.0f) {
+        if (world->tiles[i].terrain == HEX_TERRAIN_FLOWERS && world->nectar_capacity[i] > 0.0f) {
             indices[count++] = i;
         }
     }
@@ -98,32 +103,17 @@ static void sim_rebuild_floral_index(SimState *state) {
     size_t *shrink = (size_t *)realloc(indices, count * sizeof(size_t));
     state->floral_tile_indices = shrink ? shrink : indices;
     state->floral_tile_count = count;
+    if (!sim_floral_index_build(&state->floral_tree, world, state->floral_tile_indices, count)) {
+        LOG_WARN("sim: floral tree unavailable; target selection falls back to a linear scan");
+    }
 }
 
 static bool sim_has_floral_tiles(const SimState *state) {
     return state && state->hex_world && state->floral_tile_count > 0 && state->floral_tile_indices;
 }
 
-static const HexTile *sim_get_tile_const(const SimState *state, int32_t id) {
-    if (!state || !state->hex_world || id < 0) {
-        return NULL;
-    }
-    size_t index = (size_t)id;
-    if (index >= state->hex_world->tile_count) {
-        return NULL;
-    }
-    return &state->hex_world->tiles[index];
-}
-
-static HexTile *sim_get_tile(SimState *state, int32_t id) {
-    if (!state || !state->hex_world || id < 0) {
-        return NULL;
-    }
-    size_t index = (size_t)id;
-    if (index >= state->hex_world->tile_count) {
-        return NULL;
-    }
-    return &state->hex_world->tiles[index];
+static bool sim_tile_valid(const SimState *state, int32_t id) {
+    return state && state->hex_world && id >= 0 && (size_t)id < state->hex_world->tile_count;
 }
 
 static void sim_tile_center(const SimState *state, size_t index, float *out_x, float *out_y) {
@@ -150,116 +140,92 @@ static bool sim_hive_exists(const SimState *state) {
     return state && state->hex_world && hex_world_hive_enabled(state->hex_world);
 }
 
-static bool sim_point_inside_hive(const SimState *state, float x, float y) {
-    if (!sim_hive_exists(state)) {
-        return false;
-    }
+// Full world -> axial -> rounded -> index conversion; SIM_TILE_NONE off the grid.
+static uint32_t sim_locate_tile(const SimState *state, float x, float y) {
     size_t index = (size_t)SIZE_MAX;
-    if (!hex_world_tile_from_world(state->hex_world, x, y, &index)) {
-        return false;
+    if (!state->hex_world || !hex_world_tile_from_world(state->hex_world, x, y, &index) ||
+        index >= state->hex_world->tile_count) {
+        return SIM_TILE_NONE;
     }
-    if (index >= state->hex_world->tile_count) {
-        return false;
-    }
-    HexTerrain terrain = state->hex_world->tiles[index].terrain;
-    return (terrain == HEX_TERRAIN_HIVE_INTERIOR || terrain == HEX_TERRAIN_HIVE_STORAGE ||
-            terrain == HEX_TERRAIN_HIVE_ENTRANCE);
+    return (uint32_t)index;
 }
 
-static bool sim_tile_passable_world(const SimState *state, float x, float y) {
-    if (!state || !state->hex_world) {
-        return true;
-    }
-    size_t index = (size_t)SIZE_MAX;
-    if (!hex_world_tile_from_world(state->hex_world, x, y, &index)) {
-        return true;
-    }
-    return hex_world_tile_passable(state->hex_world, index);
+// True when (x, y) lies well inside the inscribed circle of the tile, where the
+// full conversion is certain to return that tile.
+static bool sim_tile_holds_point(const HexWorld *world, size_t index, float x, float y) {
+    float dx = x - world->centers_world_xy[2 * index + 0];
+    float dy = y - world->centers_world_xy[2 * index + 1];
+    float inner = world->cell_radius * SIM_TILE_INNER_RADIUS;
+    return dx * dx + dy * dy < inner * inner;
 }
 
-static bool sim_any_floral_available(const SimState *state) {
-    if (!sim_has_floral_tiles(state)) {
-        return false;
-    }
+// Follows a bee from its cached tile: most moves stay inside the same hex or
+// step into one of its six neighbours. Points near a hex edge fall back to the
+// full conversion, so the result always matches sim_locate_tile.
+static uint32_t sim_track_tile(const SimState *state, uint32_t cached, float x, float y) {
     const HexWorld *world = state->hex_world;
-    for (size_t i = 0; i < state->floral_tile_count; ++i) {
-        size_t tile_index = state->floral_tile_indices[i];
-        if (tile_index < world->tile_count) {
-            if (world->tiles[tile_index].nectar_stock > 0.5f) {
-                return true;
-            }
+    if (!world || cached == SIM_TILE_NONE || cached >= world->tile_count) {
+        return sim_locate_tile(state, x, y);
+    }
+    if (sim_tile_holds_point(world, cached, x, y)) {
+        return cached;
+    }
+    static const int k_neighbour_dq[6] = {1, -1, 0, 0, 1, -1};
+    static const int k_neighbour_dr[6] = {0, 0, 1, -1, -1, 1};
+    int q = 0;
+    int r = 0;
+    hex_world_index_to_axial(world, cached, &q, &r);
+    for (int n = 0; n < 6; ++n) {
+        size_t index = hex_world_index(world, q + k_neighbour_dq[n], r + k_neighbour_dr[n]);
+        if (index != (size_t)SIZE_MAX && sim_tile_holds_point(world, index, x, y)) {
+            return (uint32_t)index;
         }
     }
-    return false;
+    return sim_locate_tile(state, x, y);
+}
+
+static bool sim_tile_inside_hive(const SimState *state, uint32_t tile) {
+    return tile != SIM_TILE_NONE && sim_hive_exists(state) && hex_world_tile_in_hive(state->hex_world, tile);
 }
 
-static float sim_tile_score(const HexWorld *world, size_t tile_index, float from_x, float from_y) {
-    const float *centers = world->centers_world_xy;
-    float cx = centers[tile_index * 2 + 0];
-    float cy = centers[tile_index * 2 + 1];
-    float dx = cx - from_x;
-    float dy = cy - from_y;
-    float distance_sq = dx * dx + dy * dy;
-    const HexTile *tile = &world->tiles[tile_index];
-    float quality = tile->flower_quality;
-    if (quality < 0.05f) {
-        quality = 0.05f;
+static bool sim_tile_passable(const SimState *state, uint32_t tile) {
+    if (!state->hex_world || tile == SIM_TILE_NONE) {
+        return true;
     }
-    float stock_ratio = (tile->nectar_capacity > 0.0f) ? (tile->nectar_stock / tile->nectar_capacity) : 0.0f;
-    float weight = 1.0f + quality * 0.75f + stock_ratio * 0.5f;
-    return distance_sq / weight;
+    return hex_world_tile_passable(state->hex_world, tile);
+}
+
+static bool sim_any_floral_available(const SimState *state) {
+    return sim_has_floral_tiles(state) && hex_world_floral_available_count(state->hex_world) > 0;
 }
 
-static int32_t sim_choose_floral_tile(const SimState *state, float from_x, float from_y, uint64_t *rng_state) {
+// Picks the best-scoring floral tile (with a small per-bee jitter so nearby
+// bees spread over comparable patches) through the floral tree, or by a linear
+// scan when the tree could not be built. Both give the same tile.
+static int32_t sim_choose_floral_tile(const SimState *state,
+                                      float from_x,
+                                      float from_y,
+                                      SimRngKey rng_key,
+                                      uint32_t bee,
+                                      uint64_t tick) {
     if (!sim_has_floral_tiles(state)) {
         return -1;
     }
-    const HexWorld *world = state->hex_world;
-    size_t best_index = SIZE_MAX;
-    float best_score = FLT_MAX;
-    size_t fallback_index = SIZE_MAX;
-    float fallback_stock = 0.0f;
-
-    for (size_t i = 0; i < state->floral_tile_count; ++i) {
-        size_t tile_index = state->floral_tile_indices[i];
-        if (tile_index >= world->tile_count) {
-            continue;
-        }
-        const HexTile *tile = &world->tiles[tile_index];
-        if (tile->terrain != HEX_TERRAIN_FLOWERS || tile->nectar_capacity <= 0.0f) {
-            continue;
-        }
-        if (tile->nectar_stock > fallback_stock) {
-            fallback_stock = tile->nectar_stock;
-            fallback_index = tile_index;
-        }
-        if (tile->nectar_stock <= 0.5f) {
-            continue;
-        }
-        float score = sim_tile_score(world, tile_index, from_x, from_y);
-        if (rng_state) {
-            float jitter = 0.95f + 0.1f * rand_uniform01(rng_state);
-            score *= jitter;
-        }
-        if (score < best_score) {
-            best_score = score;
-            best_index = tile_index;
-        }
-    }
-
-    if (best_index != SIZE_MAX) {
-        if (best_index > (size_t)INT32_MAX) {
-            return -1;
-        }
-        return (int32_t)best_index;
-    }
-    if (fallback_index != SIZE_MAX && fallback_stock > 0.0f) {
-        if (fallback_index > (size_t)INT32_MAX) {
-            return -1;
-        }
-        return (int32_t)fallback_index;
-    }
-    return -1;
+    if (state->floral_tree.nodes) {
+        int32_t chosen =
+            sim_floral_index_choose(&state->floral_tree, state->hex_world, from_x, from_y, rng_key, bee, tick);
+        if (chosen >= 0 || !hex_world_nectar_lazy(state->hex_world)) {
+            return chosen;
+        }
+    }
+    return sim_floral_choose_linear(state->hex_world,
+                                    state->floral_tile_indices,
+                                    state->floral_tile_count,
+                                    from_x,
+                                    from_y,
+                                    rng_key,
+                                    bee,
+                                    tick);
 }
 
 static float sim_diurnal_multiplier(const SimState *state) {
@@ -289,39 +255,17 @@ static void sim_tiles_recharge(SimState *state, float dt_sec) {
     if (!sim_has_floral_tiles(state)) {
         return;
     }
-    float multiplier = sim_diurnal_multiplier(state);
     HexWorld *world = state->hex_world;
-    for (size_t i = 0; i < state->floral_tile_count; ++i) {
-        size_t tile_index = state->floral_tile_indices[i];
-        if (tile_index >= world->tile_count) {
-            continue;
-        }
-        HexTile *tile = &world->tiles[tile_index];
-        if (tile->terrain != HEX_TERRAIN_FLOWERS || tile->nectar_capacity <= 0.0f || tile->nectar_recharge_rate <= 0.0f) {
-            tile->nectar_recharge_multiplier = multiplier;
-            continue;
-        }
-        tile->nectar_recharge_multiplier = multiplier;
-        float recharge = tile->nectar_recharge_rate * multiplier * dt_sec;
-        tile->nectar_stock += recharge;
-        if (tile->nectar_stock > tile->nectar_capacity) {
-            tile->nectar_stock = tile->nectar_capacity;
-        }
-        if (tile->nectar_stock < 0.0f) {
-            tile->nectar_stock = 0.0f;
-        }
-        if (world->flower_system) {
-            tile_flower_override_payload(world->flower_system,
-                                         world,
-                                         tile_index,
-                                         tile->nectar_capacity,
-                                         tile->nectar_stock,
-                                         tile->nectar_recharge_rate,
-                                         tile->nectar_recharge_multiplier,
-                                         tile->flower_quality,
-                                         tile->flower_viscosity);
-        }
+    FlowerSystem *flowers = world->flower_system;
+    if (!flowers || !flowers->stock_changed) {
+        return;
+    }
+    if (flowers->lazy) {
+        tile_flower_advance(flowers, world, dt_sec);
+        return;
     }
+    tile_flower_recharge(flowers, world, sim_diurnal_multiplier(state), dt_sec);
+    sim_floral_index_touch_bits(&state->floral_tree, flowers->stock_changed, world->tile_count);
 }
 
 static uint32_t bee_mode_color(uint8_t mode) {
@@ -344,22 +288,6 @@ static uint32_t bee_color_for(uint8_t role, uint8_t mode) {
     return bee_mode_color(mode);
 }
 
-static float rand_angle(uint64_t *state) {
-    return rand_uniform01(state) * TWO_PI - (float)M_PI;
-}
-
-static float sample_gaussian(uint64_t *state, float mean, float stddev) {
-    if (stddev <= 0.0f) {
-        return mean;
-    }
-    float u1 = rand_uniform01(state);
-    float u2 = rand_uniform01(state);
-    u1 = u1 <= 1e-6f ? 1e-6f : u1;
-    float mag = stddev * sqrtf(-2.0f * logf(u1));
-    float z0 = mag * cosf(TWO_PI * u2);
-    return mean + z0;
-}
-
 static float wrap_angle(float angle) {
     angle = fmodf(angle + (float)M_PI, TWO_PI);
     if (angle < 0.0f) {
@@ -378,6 +306,164 @@ static void update_scratch(SimState *state) {
     }
 }
 
+static float sim_rest_recovery(const SimState *state) {
+    return state->bee_rest_recovery_per_s > 0.0f ? state->bee_rest_recovery_per_s : 0.3f;
+}
+
+// Write sites of the compact-mode dither; a bee stores at most once per site
+// and tick (resolve and the IDLE bucket are exclusive).
+enum {
+    SIM_STORE_SITE_TICK = 0,
+    SIM_STORE_SITE_COMMIT = 1,
+    SIM_STORE_SITE_WAKE = 2,
+};
+
+// Stochastic rounding to a 16-bit step count: floor(value * steps + u) with u
+// uniform in [0, 1) is unbiased, so a run of sub-step changes drifts at the
+// right mean rate instead of being rounded away every tick.
+static uint16_t sim_quantize_u16(float value, float steps_per_unit, uint32_t dither) {
+    double scaled = (double)value * (double)steps_per_unit + (double)sim_rng_word_to_unit(dither);
+    if (!(scaled >= 1.0)) {
+        return 0;
+    }
+    if (scaled >= (double)UINT16_MAX) {
+        return UINT16_MAX;
+    }
+    return (uint16_t)scaled;
+}
+
+// Stores energy and/or load (pass NAN to keep a column). A value equal to the
+// stored one is kept as is, so unchanged columns never pick up dither noise.
+static void sim_store_bee_state(SimState *state, size_t i, float energy, float load, uint64_t tick, uint32_t site) {
+    if (!state->compact) {
+        if (energy == energy) {
+            state->energy[i] = energy;
+        }
+        if (load == load) {
+            state->load_nectar[i] = load;
+        }
+        return;
+    }
+    bool store_energy = energy == energy && energy != sim_bee_energy(state, i);
+    bool store_load = load == load && load != sim_bee_load(state, i);
+    if (!store_energy && !store_load) {
+        return;
+    }
+    uint32_t dither[4];
+    sim_rng_block(sim_rng_key(state->seed), (uint32_t)i, tick, SIM_RNG_SLOT(SIM_RNG_STREAM_QUANTIZE, site), dither);
+    if (store_energy) {
+        state->energy_q[i] = sim_quantize_u16(energy, SIM_ENERGY_STEPS, dither[0]);
+    }
+    if (store_load) {
+        state->load_q[i] = sim_quantize_u16(load, 1.0f / state->load_quantum_uL, dither[1]);
+    }
+}
+
+// Closed-form rest update of a parked bee up to the current sim time.
+static void sim_parked_values(const SimState *state, size_t i, float *out_energy, float *out_t_state, float *out_age_days) {
+    uint32_t ticks = (uint32_t)state->tick_index - state->park_tick[i];
+    double elapsed = (double)ticks * (double)state->stamp_dt_sec;
+    float energy = sim_bee_energy(state, i) + sim_rest_recovery(state) * (float)elapsed;
+    if (energy < 0.0f) energy = 0.0f;
+    if (energy > 1.0f) energy = 1.0f;
+    float t_state = state->t_state[i] + (float)elapsed;
+    float age_days = state->age_days[i] + (float)(elapsed / 86400.0);
+    *out_energy = energy;
+    *out_t_state = t_state;
+    *out_age_days = age_days;
+}
+
+// Keeps the parked column, the chunk's parked count and its mask in step.
+static void sim_set_parked(SimState *state, size_t i, bool parked) {
+    SimChunkStats *stats = &state->chunk_stats[i / SIM_TICK_CHUNK_BEES];
+    size_t j = i % SIM_TICK_CHUNK_BEES;
+    uint64_t bit = UINT64_C(1) << (j % 64u);
+    state->parked[i] = parked ? 1u : 0u;
+    if (parked) {
+        stats->parked_count++;
+        stats->parked_mask[j / 64u] |= bit;
+    } else {
+        stats->parked_count--;
+        stats->parked_mask[j / 64u] &= ~bit;
+    }
+}
+
+static void sim_unpark(SimState *state, size_t i) {
+    if (!state->parked[i]) {
+        return;
+    }
+    float energy = 0.0f;
+    float t_state = 0.0f;
+    float age_days = 0.0f;
+    sim_parked_values(state, i, &energy, &t_state, &age_days);
+    sim_store_bee_state(state, i, energy, NAN, state->tick_index, SIM_STORE_SITE_WAKE);
+    state->t_state[i] = t_state;
+    state->age_days[i] = age_days;
+    sim_set_parked(state, i, false);
+    timer_wheel_cancel(state->wake_wheel, (uint32_t)i);
+}
+
+static void sim_wake_fired(void *user_data, uint32_t bee) {
+    sim_unpark((SimState *)user_data, bee);
+}
+
+// Wakes every parked bee. Called before anything that would invalidate the
+// closed-form rest update: runtime params, the hive, or the fast paths.
+static void sim_wake_all(SimState *state) {
+    if (!state || !state->parked) {
+        return;
+    }
+    for (size_t i = 0; i < state->count; ++i) {
+        if (state->parked[i]) {
+            sim_unpark(state, i);
+        }
+    }
+    timer_wheel_reset(state->wake_wheel, state->tick_index);
+}
+
+static void sim_clear_parking(SimState *state) {
+    state->sim_time_sec = 0.0;
+    memset(state->parked, 0, sizeof(uint8_t) * state->capacity);
+    for (size_t c = 0; c < state->chunk_capacity; ++c) {
+        state->chunk_stats[c].parked_count = 0;
+        state->chunk_stats[c].park_request_count = 0;
+        memset(state->chunk_stats[c].parked_mask, 0, sizeof(state->chunk_stats[c].parked_mask));
+    }
+    timer_wheel_reset(state->wake_wheel, 0);
+}
+
+// The per-bee tile cache (and the inside-hive bit the mode fast paths trust)
+// is recomputed whenever positions or the world change outside sim_tick.
+static void sim_refresh_tile_cache(SimState *state) {
+    if (!state || !state->tile_index || !state->bee_flags) {
+        return;
+    }
+    for (size_t i = 0; i < state->count; ++i) {
+        state->tile_index[i] = sim_locate_tile(state, state->x[i], state->y[i]);
+        sim_bee_set_flag(state, i, SIM_BEE_INSIDE_HIVE, sim_tile_inside_hive(state, state->tile_index[i]));
+    }
+}
+
+static float sim_uniform_capacity(const SimState *state) {
+    return state->bee_capacity_uL > 0.0f ? state->bee_capacity_uL : 50.0f;
+}
+
+// Re-derives the compact load step from the uniform capacity, carrying every
+// load over (clamped to the new capacity, rounded to nearest).
+static void sim_requantize_loads(SimState *state) {
+    float capacity = sim_uniform_capacity(state);
+    float quantum = capacity / SIM_ENERGY_STEPS;
+    if (quantum == state->load_quantum_uL) {
+        return;
+    }
+    for (size_t i = 0; i < state->count; ++i) {
+        float load = (float)state->load_q[i] * state->load_quantum_uL;
+        if (load > capacity) load = capacity;
+        state->load_q[i] = (uint16_t)(load / quantum + 0.5f);
+    }
+    state->load_quantum_uL = quantum;
+}
+
 static void configure_from_params(SimState *state, const Params *params) {
     if (!state || !params) {
         return;
@@ -411,6 +497,9 @@ static void configure_from_params(SimState *state, const Params *params) {
             }
         }
     }
+    if (state->load_q) {
+        sim_requantize_loads(state);
+    }
 }
 
 static void reset_log_stats(SimState *state) {
@@ -422,6 +511,90 @@ static void reset_log_stats(SimState *state) {
     state->log_speed_max = 0.0;
 }
 
+// Where bees unload and rest: the preferred unload tile, else the hive
+// center, else the world center.
+static void sim_unload_point(const SimState *state, float *out_x, float *out_y) {
+    float x = state->world_w * 0.5f;
+    float y = state->world_h * 0.5f;
+    if (state->hex_world) {
+        float center_x = x;
+        float center_y = y;
+        if (hex_world_hive_center(state->hex_world, &center_x, &center_y)) {
+            x = center_x;
+            y = center_y;
+        }
+        if (!hex_world_hive_preferred_unload(state->hex_world, out_x, out_y)) {
+            *out_x = x;
+            *out_y = y;
+        }
+        return;
+    }
+    *out_x = x;
+    *out_y = y;
+}
+
+// Writes a fresh bee resting at (x, y) into slot i, heading home.
+static void sim_init_bee(SimState *state,
+                         size_t i,
+                         float x,
+                         float y,
+                         float heading,
+                         float age_days,
+                         BeeRole role,
+                         float home_x,
+                         float home_y) {
+    state->x[i] = x;
+    state->y[i] = y;
+    state->vx[i] = 0.0f;
+    state->vy[i] = 0.0f;
+    if (state->heading) {
+        state->heading[i] = heading;
+    }
+    if (state->radius) {
+        state->radius[i] = state->default_radius;
+    }
+    state->age_days[i] = age_days;
+    state->t_state[i] = 0.0f;
+    if (state->compact) {
+        state->energy_q[i] = UINT16_MAX;
+        state->load_q[i] = 0;
+    } else {
+        state->energy[i] = 1.0f;
+        state->load_nectar[i] = 0.0f;
+    }
+    state->target_pos_x[i] = home_x;
+    state->target_pos_y[i] = home_y;
+    state->target_id[i] = -1;
+    state->topic_id[i] = -1;
+    state->topic_confidence[i] = 0;
+    if (state->capacity_uL && state->harvest_rate_uLps) {
+        state->capacity_uL[i] = state->bee_capacity_uL;
+        state->harvest_rate_uLps[i] = state->bee_harvest_rate_uLps;
+    }
+
+    state->tile_index[i] = sim_locate_tile(state, x, y);
+    state->bee_flags[i] = 0;
+    sim_bee_set_field(state, i, SIM_BEE_ROLE_SHIFT, (uint8_t)role);
+    sim_bee_set_field(state, i, SIM_BEE_MODE_SHIFT, (uint8_t)BEE_MODE_IDLE);
+    sim_bee_set_field(state, i, SIM_BEE_INTENT_SHIFT, (uint8_t)BEE_INTENT_REST);
+    sim_bee_set_flag(state, i, SIM_BEE_INSIDE_HIVE, sim_tile_inside_hive(state, state->tile_index[i]));
+    if (state->color_rgba) {
+        state->color_rgba[i] = bee_color_for((uint8_t)role, BEE_MODE_IDLE);
+    }
+    if (state->path_waypoint_x) {
+        state->path_waypoint_x[i] = home_x;
+    }
+    if (state->path_waypoint_y) {
+        state->path_waypoint_y[i] = home_y;
+    }
+    state->request_tile[i] = -1;
+    state->request_uL[i] = 0.0f;
+    if (state->scratch_xy) {
+        state->scratch_xy[2 * i + 0] = x;
+        state->scratch_xy[2 * i + 1] = y;
+    }
+}
+
 static void fill_bees(SimState *state, const Params *params, uint64_t seed) {
     if (!state) {
         return;
@@ -435,38 +608,27 @@ static void fill_bees(SimState *state, const Params *params, uint64_t seed) {
         seed = state->seed ? state->seed : UINT64_C(0xBEE);
     }
     state->seed = seed;
-    state->rng_state = seed;
+    state->tick_index = 0;
+    sim_clear_parking(state);
+    memset(state->caste_pool, 0, sizeof(state->caste_pool));
+    state->pooled_count = 0;
+    state->pool_day_start_sec = 0.0;
 
-    float entrance_x = state->world_w * 0.5f;
-    float entrance_y = state->world_h * 0.5f;
-    float unload_x = entrance_x;
-    float unload_y = entrance_y;
-    float hive_center_x = entrance_x;
-    float hive_center_y = entrance_y;
-    if (state->hex_world) {
-        if (hex_world_hive_center(state->hex_world, &hive_center_x, &hive_center_y)) {
-            entrance_x = hive_center_x;
-            entrance_y = hive_center_y;
-            unload_x = hive_center_x;
-            unload_y = hive_center_y;
-        }
-        if (!hex_world_hive_preferred_entrance(state->hex_world, &entrance_x, &entrance_y)) {
-            entrance_x = hive_center_x;
-            entrance_y = hive_center_y;
-        }
-        if (!hex_world_hive_preferred_unload(state->hex_world, &unload_x, &unload_y)) {
-            unload_x = hive_center_x;
-            unload_y = hive_center_y;
-        }
-    }
+    float unload_x = 0.0f;
+    float unload_y = 0.0f;
+    sim_unload_point(state, &unload_x, &unload_y);
+
+    // Every slot below count is refilled, so a reset also revives dead slots.
+    state->free_count = 0;
+    state->live_count = state->count;
 
     const float bee_radius = state->default_radius;
     const float spacing = clamp_positive(bee_radius * 3.0f, bee_radius * 1.5f);
-    size_t cols = (size_t)ceil(sqrt((double)state->capacity));
+    size_t cols = (size_t)ceil(sqrt((double)state->count));
     if (cols == 0) {
         cols = 1;
     }
-    size_t rows = (state->capacity + cols - 1u) / cols;
+    size_t rows = (state->count + cols - 1u) / cols;
 
     const float grid_w = (float)(cols - 1) * spacing;
     const float grid_h = (float)(rows - 1) * spacing;
@@ -477,8 +639,7 @@ static void fill_bees(SimState *state, const Params *params, uint64_t seed) {
     const float min_y_allowed = bee_radius + state->bounce_margin;
     const float max_y_allowed = state->world_h - bee_radius - state->bounce_margin;
 
-
-    uint64_t rng = state->rng_state;
+    const SimRngKey rng_key = sim_rng_key(seed);
 
     for (size_t i = 0; i < state->count; ++i) {
         size_t col = i % cols;
@@ -487,8 +648,10 @@ static void fill_bees(SimState *state, const Params *params, uint64_t seed) {
         float base_x = origin_x + (float)col * spacing;
         float base_y = origin_y + (float)row * spacing;
 
-        float jitter_x = rand_symmetric(&rng) * bee_radius * 0.25f;
-        float jitter_y = rand_symmetric(&rng) * bee_radius * 0.25f;
+        uint32_t spawn_draws[4];
+        sim_rng_block(rng_key, (uint32_t)i, 0, SIM_RNG_SLOT(SIM_RNG_STREAM_SPAWN, 0), spawn_draws);
+        float jitter_x = (sim_rng_word_to_unit(spawn_draws[0]) * 2.0f - 1.0f) * bee_radius * 0.25f;
+        float jitter_y = (sim_rng_word_to_unit(spawn_draws[1]) * 2.0f - 1.0f) * bee_radius * 0.25f;
 
         float x = base_x + jitter_x;
         float y = base_y + jitter_y;
@@ -516,91 +679,87 @@ static void fill_bees(SimState *state, const Params *params, uint64_t seed) {
         if (y < clamped_min_y) y = clamped_min_y;
         if (y > clamped_max_y) y = clamped_max_y;
 
-        float heading = rand_angle(&rng);
-
-        state->x[i] = x;
-        state->y[i] = y;
-        state->heading[i] = heading;
-        state->vx[i] = 0.0f;
-        state->vy[i] = 0.0f;
-        state->radius[i] = bee_radius;
-
-        float age_days = rand_uniform01(&rng) * 25.0f;
-        state->age_days[i] = age_days;
-        state->t_state[i] = 0.0f;
-        state->energy[i] = 1.0f;
-        state->load_nectar[i] = 0.0f;
-        state->target_pos_x[i] = unload_x;
-        state->target_pos_y[i] = unload_y;
-        state->target_id[i] = -1;
-        state->topic_id[i] = -1;
-        state->topic_confidence[i] = 0;
-        state->capacity_uL[i] = state->bee_capacity_uL;
-        state->harvest_rate_uLps[i] = state->bee_harvest_rate_uLps;
+        float heading = sim_rng_word_to_unit(spawn_draws[2]) * TWO_PI - (float)M_PI;
+        float age_days = sim_rng_word_to_unit(spawn_draws[3]) * 25.0f;
+        float role_roll = sim_rng_uniform01(rng_key, (uint32_t)i, 0, SIM_RNG_SLOT(SIM_RNG_STREAM_SPAWN, 1));
+        BeeRole role = (i == 0) ? BEE_ROLE_QUEEN : bee_pick_role(age_days, role_roll);
+        sim_init_bee(state, i, x, y, heading, age_days, role, unload_x, unload_y);
+    }
 
-        BeeRole role = (i == 0) ? BEE_ROLE_QUEEN : bee_pick_role(age_days, &rng);
-        state->role[i] = (uint8_t)role;
+    reset_log_stats(state);
+    update_scratch(state);
+    state->spatial_stale = true;
+}
 
-        state->mode[i] = (uint8_t)BEE_MODE_IDLE;
-        state->intent[i] = (uint8_t)BEE_INTENT_REST;
-        state->color_rgba[i] = bee_color_for(state->role[i], state->mode[i]);
+static bool sim_reserve_workers(SimState *state, size_t worker_count) {
+    if (worker_count == 0) {
+        worker_count = 1;
+    }
+    if (state->job_pool && job_pool_worker_count(state->job_pool) == worker_count) {
+        state->worker_count = worker_count;
+        return true;
+    }
+    JobPool *pool = NULL;
+    if (worker_count > 1 && !job_pool_create(&pool, worker_count)) {
+        LOG_ERROR("sim: failed to start %zu workers; keeping %zu", worker_count, state->worker_count);
+        return false;
+    }
+    job_pool_destroy(state->job_pool);
+    state->job_pool = pool;
+    state->worker_count = worker_count;
+    return true;
+}
 
-        bool inside = sim_point_inside_hive(state, x, y);
-        state->inside_hive_flag[i] = inside ? 1u : 0u;
-        if (state->path_valid) {
-            state->path_valid[i] = 0u;
-        }
-        if (state->path_has_waypoint) {
-            state->path_has_waypoint[i] = 0u;
-        }
-        if (state->path_waypoint_x) {
-            state->path_waypoint_x[i] = unload_x;
-        }
-        if (state->path_waypoint_y) {
-            state->path_waypoint_y[i] = unload_y;
-        }
+static float sim_spatial_cell_size(const SimState *state, size_t capacity) {
+    float cell_size = sqrtf(state->world_w * state->world_h * SIM_SPATIAL_BEES_PER_CELL / (float)capacity);
+    if (cell_size < 4.0f * state->default_radius) {
+        cell_size = 4.0f * state->default_radius;
     }
+    return cell_size;
+}
 
-    state->rng_state = rng;
-    reset_log_stats(state);
-    update_scratch(state);
+// Frees a per-bee column unless it lives in the mapped checkpoint.
+static void sim_free_column(const SimState *state, void *column) {
+    if (!snapshot_reader_owns(state->snapshot, column)) {
+        free_aligned(column);
+    }
 }
 
 static void sim_release(SimState *state) {
     if (!state) {
         return;
     }
-    free_aligned(state->x);
-    free_aligned(state->y);
-    free_aligned(state->vx);
-    free_aligned(state->vy);
-    free_aligned(state->heading);
-    free_aligned(state->radius);
-    free_aligned(state->color_rgba);
-    free_aligned(state->scratch_xy);
-    free_aligned(state->age_days);
-    free_aligned(state->t_state);
-    free_aligned(state->energy);
-    free_aligned(state->load_nectar);
-    free_aligned(state->target_pos_x);
-    free_aligned(state->target_pos_y);
-    free_aligned(state->target_id);
-    free_aligned(state->topic_id);
-    free_aligned(state->topic_confidence);
-    free_aligned(state->role);
-    free_aligned(state->mode);
-    free_aligned(state->intent);
-    free_aligned(state->capacity_uL);
-    free_aligned(state->harvest_rate_uLps);
-    free_aligned(state->inside_hive_flag);
-    free_aligned(state->path_waypoint_x);
-    free_aligned(state->path_waypoint_y);
-    free_aligned(state->path_has_waypoint);
-    free_aligned(state->path_valid);
+    SimBeeColumn columns[SIM_BEE_COLUMN_MAX];
+    size_t column_count = sim_bee_columns(state, columns);
+    for (size_t c = 0; c < column_count; ++c) {
+        sim_free_column(state, *columns[c].data);
+    }
+    free(state->tile_request_count);
+    free_aligned(state->chunk_stats);
+    free_aligned(state->view_radius);
+    free_aligned(state->view_color_rgba);
+    timer_wheel_destroy(state->wake_wheel);
+    sim_spatial_free(&state->spatial);
+    job_pool_destroy(state->job_pool);
     sim_free_floral_index(state);
+    snapshot_reader_close(state->snapshot);
     free(state);
 }
 
+static void sim_reserve_tile_buckets(SimState *state, size_t tile_count) {
+    if (tile_count <= state->tile_request_capacity) {
+        return;
+    }
+    free(state->tile_request_count);
+    state->tile_request_capacity = 0;
+    state->tile_request_count = (uint32_t *)calloc(tile_count, sizeof(uint32_t));
+    if (!state->tile_request_count) {
+        LOG_ERROR("sim: failed to allocate request buckets for %zu tiles", tile_count);
+        return;
+    }
+    state->tile_request_capacity = tile_count;
+}
+
 bool sim_init(SimState **out_state, const Params *params) {
     if (!out_state || *out_state || !params) {
         LOG_ERROR("sim_init: invalid arguments");
@@ -625,6 +784,8 @@ bool sim_init(SimState **out_state, const Params *params) {
                                                    : (float)params->window_width_px;
     state->world_h = params->world_height_px > 0.0f ? params->world_height_px
                                                    : (float)params->window_height_px;
+    state->compact = params->sim_compact_state;
+    state->inspection = true;
     state->hex_world = NULL;
     state->floral_tile_indices = NULL;
     state->floral_tile_count = 0;
@@ -638,149 +799,1244 @@ bool sim_init(SimState **out_state, const Params *params) {
     state->y = (float *)alloc_aligned(sizeof(float) * count);
     state->vx = (float *)alloc_aligned(sizeof(float) * count);
     state->vy = (float *)alloc_aligned(sizeof(float) * count);
-    state->heading = (float *)alloc_aligned(sizeof(float) * count);
-    state->radius = (float *)alloc_aligned(sizeof(float) * count);
-    state->color_rgba = (uint32_t *)alloc_aligned(sizeof(uint32_t) * count);
     state->scratch_xy = (float *)alloc_aligned(sizeof(float) * count * 2u);
     state->age_days = (float *)alloc_aligned(sizeof(float) * count);
     state->t_state = (float *)alloc_aligned(sizeof(float) * count);
-    state->energy = (float *)alloc_aligned(sizeof(float) * count);
-    state->load_nectar = (float *)alloc_aligned(sizeof(float) * count);
+    bool columns_ok = true;
+    if (state->compact) {
+        state->energy_q = (uint16_t *)alloc_aligned(sizeof(uint16_t) * count);
+        state->load_q = (uint16_t *)alloc_aligned(sizeof(uint16_t) * count);
+        state->load_quantum_uL = sim_uniform_capacity(state) / SIM_ENERGY_STEPS;
+        columns_ok = state->energy_q && state->load_q;
+    } else {
+        state->heading = (float *)alloc_aligned(sizeof(float) * count);
+        state->radius = (float *)alloc_aligned(sizeof(float) * count);
+        state->color_rgba = (uint32_t *)alloc_aligned(sizeof(uint32_t) * count);
+        state->energy = (float *)alloc_aligned(sizeof(float) * count);
+        state->load_nectar = (float *)alloc_aligned(sizeof(float) * count);
+        state->capacity_uL = (float *)alloc_aligned(sizeof(float) * count);
+        state->harvest_rate_uLps = (float *)alloc_aligned(sizeof(float) * count);
+        columns_ok = state->heading && state->radius && state->color_rgba && state->energy && state->load_nectar &&
+                     state->capacity_uL && state->harvest_rate_uLps;
+    }
     state->target_pos_x = (float *)alloc_aligned(sizeof(float) * count);
     state->target_pos_y = (float *)alloc_aligned(sizeof(float) * count);
     state->target_id = (int32_t *)alloc_aligned(sizeof(int32_t) * count);
     state->topic_id = (int16_t *)alloc_aligned(sizeof(int16_t) * count);
     state->topic_confidence = (uint8_t *)alloc_aligned(sizeof(uint8_t) * count);
-    state->role = (uint8_t *)alloc_aligned(sizeof(uint8_t) * count);
-    state->mode = (uint8_t *)alloc_aligned(sizeof(uint8_t) * count);
-    state->intent = (uint8_t *)alloc_aligned(sizeof(uint8_t) * count);
-    state->capacity_uL = (float *)alloc_aligned(sizeof(float) * count);
-    state->harvest_rate_uLps = (float *)alloc_aligned(sizeof(float) * count);
-    state->inside_hive_flag = (uint8_t *)alloc_aligned(sizeof(uint8_t) * count);
-    state->path_waypoint_x = (float *)alloc_aligned(sizeof(float) * count);
-    state->path_waypoint_y = (float *)alloc_aligned(sizeof(float) * count);
-    state->path_has_waypoint = (uint8_t *)alloc_aligned(sizeof(uint8_t) * count);
-    state->path_valid = (uint8_t *)alloc_aligned(sizeof(uint8_t) * count);
-
-    if (!state->x || !state->y || !state->vx || !state->vy || !state->heading ||
-        !state->radius || !state->color_rgba || !state->scratch_xy ||
-        !state->age_days || !state->t_state || !state->energy || !state->load_nectar ||
+    state->bee_flags = (uint16_t *)alloc_aligned(sizeof(uint16_t) * count);
+    state->tile_index = (uint32_t *)alloc_aligned(sizeof(uint32_t) * count);
+    if (state->inspection) {
+        state->path_waypoint_x = (float *)alloc_aligned(sizeof(float) * count);
+        state->path_waypoint_y = (float *)alloc_aligned(sizeof(float) * count);
+        columns_ok = columns_ok && state->path_waypoint_x && state->path_waypoint_y;
+    }
+    state->request_tile = (int32_t *)alloc_aligned(sizeof(int32_t) * count);
+    state->request_uL = (float *)alloc_aligned(sizeof(float) * count);
+    state->touched_tiles = (uint32_t *)alloc_aligned(sizeof(uint32_t) * count);
+    state->request_bee = (uint32_t *)alloc_aligned(sizeof(uint32_t) * count);
+    state->requests = (HexTileRequest *)alloc_aligned(sizeof(HexTileRequest) * count);
+    state->request_granted_uL = (float *)alloc_aligned(sizeof(float) * count);
+    state->chunk_capacity = (count + SIM_TICK_CHUNK_BEES - 1u) / SIM_TICK_CHUNK_BEES;
+    state->chunk_stats = (SimChunkStats *)alloc_aligned(sizeof(SimChunkStats) * state->chunk_capacity);
+    state->parked = (uint8_t *)alloc_aligned(sizeof(uint8_t) * count);
+    state->park_tick = (uint32_t *)alloc_aligned(sizeof(uint32_t) * count);
+    state->park_requests = (SimParkRequest *)alloc_aligned(sizeof(SimParkRequest) * count);
+    timer_wheel_create(&state->wake_wheel, count, 0);
+    state->free_slots = (uint32_t *)alloc_aligned(sizeof(uint32_t) * count);
+    state->compaction_remap = (uint32_t *)alloc_aligned(sizeof(uint32_t) * count);
+    bool spatial_ok = sim_spatial_init(&state->spatial, state->world_w, state->world_h, sim_spatial_cell_size(state, count), count);
+
+    if (!state->x || !state->y || !state->vx || !state->vy || !state->scratch_xy ||
+        !state->age_days || !state->t_state || !columns_ok ||
         !state->target_pos_x || !state->target_pos_y || !state->target_id ||
-        !state->topic_id || !state->topic_confidence || !state->role ||
-        !state->mode || !state->intent || !state->capacity_uL || !state->harvest_rate_uLps ||
-        !state->inside_hive_flag || !state->path_waypoint_x || !state->path_waypoint_y ||
-        !state->path_has_waypoint || !state->path_valid) {
+        !state->topic_id || !state->topic_confidence || !state->bee_flags ||
+        !state->tile_index || !state->request_tile ||
+        !state->request_uL || !state->touched_tiles || !state->request_bee || !state->requests ||
+        !state->request_granted_uL || !state->chunk_stats || !state->parked || !state->park_tick ||
+        !state->park_requests || !state->free_slots || !state->compaction_remap || !state->wake_wheel ||
+        !spatial_ok) {
         LOG_ERROR("sim_init: allocation failure for bee buffers");
         sim_release(state);
         return false;
     }
 
+    if (!sim_reserve_workers(state, params->sim_worker_count)) {
+        sim_release(state);
+        return false;
+    }
+    state->kinematics_kernel = sim_kinematics_resolve(SIM_KINEMATICS_AUTO);
+    state->mode_buckets = true;
+    state->hibernation = true;
+
     fill_bees(state, params, state->seed);
 
     *out_state = state;
-    LOG_INFO("sim: initialized count=%zu capacity=%zu seed=0x%llx dt=%.5f max_speed=%.1f jitter=%.1fdeg/s",
+    LOG_INFO("sim: initialized count=%zu capacity=%zu seed=0x%llx dt=%.5f max_speed=%.1f jitter=%.1fdeg/s workers=%zu kernel=%s",
              state->count,
              state->capacity,
              (unsigned long long)state->seed,
              params->sim_fixed_dt,
              params->motion_max_speed,
-             params->motion_jitter_deg_per_sec);
+             params->motion_jitter_deg_per_sec,
+             state->worker_count,
+             sim_kinematics_kernel_name(state->kinematics_kernel));
     return true;
 }
 
+static void sim_apply_lazy_recharge(SimState *state) {
+    HexWorld *world = state->hex_world;
+    if (!world || !world->flower_system) {
+        return;
+    }
+    if (!tile_flower_set_lazy(world->flower_system,
+                              world,
+                              state->lazy_recharge,
+                              state->floral_day_period_sec,
+                              state->floral_night_scale,
+                              state->floral_clock_sec)) {
+        LOG_WARN("sim: lazy nectar recharge unavailable; recharging every tick");
+    }
+}
+
 void sim_bind_hex_world(SimState *state, HexWorld *world) {
     if (!state) {
         return;
     }
+    sim_wake_all(state);
     state->hex_world = world;
+    sim_refresh_tile_cache(state);
     if (!world) {
         sim_free_floral_index(state);
         return;
     }
+    if (state->lazy_recharge) {
+        sim_apply_lazy_recharge(state);
+    }
     sim_rebuild_floral_index(state);
+    sim_reserve_tile_buckets(state, world->tile_count);
 }
 
-void sim_tick(SimState *state, float dt_sec) {
-    if (!state || state->count == 0) {
-        return;
-    }
-    if (dt_sec <= 0.0f) {
-        update_scratch(state);
-        return;
+static float sim_bee_capacity(const SimState *state, size_t i) {
+    if (state->capacity_uL && state->capacity_uL[i] > 0.0f) {
+        return state->capacity_uL[i];
     }
+    return sim_uniform_capacity(state);
+}
 
-    state->floral_clock_sec += dt_sec;
-    sim_tiles_recharge(state, dt_sec);
-
-    uint64_t rng = state->rng_state;
-    const float world_w = state->world_w;
-    const float world_h = state->world_h;
-    const float bounce_margin = state->bounce_margin;
-    const float base_speed = state->bee_speed_mps > 0.0f ? state->bee_speed_mps : state->max_speed;
-    const float max_speed = base_speed > 0.0f ? base_speed : state->max_speed;
-    const float seek_accel = state->bee_seek_accel > 0.0f ? state->bee_seek_accel : state->max_speed * 2.0f;
-    float arrive_tol = state->bee_arrive_tol_world > 0.0f ? state->bee_arrive_tol_world : state->default_radius * 2.0f;
-
-    float entrance_x = world_w * 0.5f;
-    float entrance_y = world_h * 0.5f;
-    float unload_x = entrance_x;
-    float unload_y = entrance_y;
-    float hive_center_x = entrance_x;
-    float hive_center_y = entrance_y;
-    if (state->hex_world) {
-        if (hex_world_hive_center(state->hex_world, &hive_center_x, &hive_center_y)) {
-            entrance_x = hive_center_x;
-            entrance_y = hive_center_y;
-            unload_x = hive_center_x;
-            unload_y = hive_center_y;
-        }
-        if (!hex_world_hive_preferred_entrance(state->hex_world, &entrance_x, &entrance_y)) {
-            entrance_x = hive_center_x;
-            entrance_y = hive_center_y;
-        }
-        if (!hex_world_hive_preferred_unload(state->hex_world, &unload_x, &unload_y)) {
-            unload_x = hive_center_x;
-            unload_y = hive_center_y;
-        }
+static float sim_bee_harvest_rate(const SimState *state, size_t i) {
+    if (state->harvest_rate_uLps && state->harvest_rate_uLps[i] > 0.0f) {
+        return state->harvest_rate_uLps[i];
     }
+    return state->bee_harvest_rate_uLps;
+}
 
-    double speed_sum = 0.0;
-    float speed_min_tick = FLT_MAX;
-    float speed_max_tick = 0.0f;
-    uint64_t bounce_counter = 0;
-    bool any_patch_available = sim_any_floral_available(state);
+bool sim_set_worker_count(SimState *state, size_t worker_count) {
+    if (!state) {
+        return false;
+    }
+    if (worker_count == state->worker_count) {
+        return true;
+    }
+    if (!sim_reserve_workers(state, worker_count)) {
+        return false;
+    }
+    LOG_INFO("sim: tick workers=%zu", state->worker_count);
+    return true;
+}
+
+bool sim_set_kinematics_kernel(SimState *state, SimKinematicsKernel kernel) {
+    if (!state) {
+        return false;
+    }
+    SimKinematicsKernel resolved = sim_kinematics_resolve(kernel);
+    state->kinematics_kernel = resolved;
+    if (kernel != SIM_KINEMATICS_AUTO && resolved != kernel) {
+        LOG_WARN("sim: %s kinematics not supported on this CPU; using %s",
+                 sim_kinematics_kernel_name(kernel),
+                 sim_kinematics_kernel_name(resolved));
+        return false;
+    }
+    return true;
+}
+
+void sim_set_mode_buckets(SimState *state, bool enabled) {
+    if (!state) {
+        return;
+    }
+    sim_journal_note_option(state->journal, state, SIM_JOURNAL_OPTION_MODE_BUCKETS, enabled);
+    if (!enabled) {
+        sim_wake_all(state);
+    }
+    state->mode_buckets = enabled;
+}
+
+void sim_set_hibernation(SimState *state, bool enabled) {
+    if (!state) {
+        return;
+    }
+    sim_journal_note_option(state->journal, state, SIM_JOURNAL_OPTION_HIBERNATION, enabled);
+    if (!enabled) {
+        sim_wake_all(state);
+    }
+    state->hibernation = enabled;
+}
+
+void sim_set_lazy_recharge(SimState *state, bool enabled) {
+    if (!state || state->lazy_recharge == enabled) {
+        return;
+    }
+    sim_journal_note_option(state->journal, state, SIM_JOURNAL_OPTION_LAZY_RECHARGE, enabled);
+    state->lazy_recharge = enabled;
+    sim_apply_lazy_recharge(state);
+    // The tree aggregates switch between exact stocks and lazy bounds.
+    sim_rebuild_floral_index(state);
+}
+
+void sim_set_multi_rate(SimState *state, bool enabled) {
+    if (!state || state->multi_rate == enabled) {
+        return;
+    }
+    sim_journal_note_option(state->journal, state, SIM_JOURNAL_OPTION_MULTI_RATE, enabled);
+    // Lagging bees catch up on their next tick either way.
+    state->multi_rate = enabled;
+}
+
+void sim_set_detail_region(SimState *state, float min_x, float min_y, float max_x, float max_y) {
+    if (!state) {
+        return;
+    }
+    sim_journal_note_detail_region(state->journal, state, true, min_x, min_y, max_x, max_y);
+    state->detail_region = true;
+    state->detail_min_x = min_x;
+    state->detail_min_y = min_y;
+    state->detail_max_x = max_x;
+    state->detail_max_y = max_y;
+}
+
+void sim_clear_detail_region(SimState *state) {
+    if (!state || !state->detail_region) {
+        return;
+    }
+    sim_journal_note_detail_region(state->journal, state, false, 0.0f, 0.0f, 0.0f, 0.0f);
+    state->detail_region = false;
+}
 
+bool sim_set_inspection(SimState *state, bool enabled) {
+    if (!state) {
+        return false;
+    }
+    if (state->inspection == enabled) {
+        return true;
+    }
+    if (!enabled) {
+        sim_free_column(state, state->path_waypoint_x);
+        sim_free_column(state, state->path_waypoint_y);
+        state->path_waypoint_x = NULL;
+        state->path_waypoint_y = NULL;
+        state->inspection = false;
+        return true;
+    }
+    float *waypoint_x = (float *)alloc_aligned(sizeof(float) * state->capacity);
+    float *waypoint_y = (float *)alloc_aligned(sizeof(float) * state->capacity);
+    if (!waypoint_x || !waypoint_y) {
+        LOG_ERROR("sim: failed to allocate inspection columns for %zu bees", state->capacity);
+        free_aligned(waypoint_x);
+        free_aligned(waypoint_y);
+        return false;
+    }
+    // The next tick writes the real waypoints; until then report the target.
     for (size_t i = 0; i < state->count; ++i) {
+        waypoint_x[i] = state->target_pos_x[i];
+        waypoint_y[i] = state->target_pos_y[i];
+    }
+    state->path_waypoint_x = waypoint_x;
+    state->path_waypoint_y = waypoint_y;
+    state->inspection = true;
+    return true;
+}
+
+size_t sim_bee_state_bytes(const SimState *state) {
+    if (!state) {
+        return 0;
+    }
+    SimBeeColumn columns[SIM_BEE_COLUMN_MAX];
+    size_t column_count = sim_bee_columns((SimState *)state, columns);
+    size_t bytes = 0;
+    for (size_t c = 0; c < column_count; ++c) {
+        if (*columns[c].data) {
+            bytes += columns[c].elem_size;
+        }
+    }
+    bytes += sim_spatial_bytes_per_bee() + timer_wheel_bytes_per_entry();
+    if (state->view_capacity > 0) {
+        bytes += sizeof(float) + sizeof(uint32_t);
+    }
+    return bytes;
+}
+
+#define SIM_COLUMN(field, is_scratch) \
+    (SimBeeColumn) { (void **)&state->field, sizeof(*state->field), #field, is_scratch }
+
+size_t sim_bee_columns(SimState *state, SimBeeColumn out[SIM_BEE_COLUMN_MAX]) {
+    size_t n = 0;
+    out[n++] = SIM_COLUMN(x, false);
+    out[n++] = SIM_COLUMN(y, false);
+    out[n++] = SIM_COLUMN(vx, false);
+    out[n++] = SIM_COLUMN(vy, false);
+    out[n++] = SIM_COLUMN(heading, false);
+    out[n++] = SIM_COLUMN(radius, false);
+    out[n++] = SIM_COLUMN(color_rgba, false);
+    out[n++] = (SimBeeColumn){(void **)&state->scratch_xy, 2u * sizeof(float), "scratch_xy", true};
+    out[n++] = SIM_COLUMN(age_days, false);
+    out[n++] = SIM_COLUMN(t_state, false);
+    out[n++] = SIM_COLUMN(energy, false);
+    out[n++] = SIM_COLUMN(load_nectar, false);
+    out[n++] = SIM_COLUMN(energy_q, false);
+    out[n++] = SIM_COLUMN(load_q, false);
+    out[n++] = SIM_COLUMN(target_pos_x, false);
+    out[n++] = SIM_COLUMN(target_pos_y, false);
+    out[n++] = SIM_COLUMN(target_id, false);
+    out[n++] = SIM_COLUMN(topic_id, false);
+    out[n++] = SIM_COLUMN(topic_confidence, false);
+    out[n++] = SIM_COLUMN(bee_flags, false);
+    out[n++] = SIM_COLUMN(capacity_uL, false);
+    out[n++] = SIM_COLUMN(harvest_rate_uLps, false);
+    out[n++] = SIM_COLUMN(tile_index, false);
+    out[n++] = SIM_COLUMN(path_waypoint_x, false);
+    out[n++] = SIM_COLUMN(path_waypoint_y, false);
+    out[n++] = SIM_COLUMN(request_tile, false);
+    out[n++] = SIM_COLUMN(request_uL, false);
+    out[n++] = SIM_COLUMN(parked, false);
+    out[n++] = SIM_COLUMN(park_tick, false);
+    out[n++] = SIM_COLUMN(touched_tiles, true);
+    out[n++] = SIM_COLUMN(request_bee, true);
+    out[n++] = SIM_COLUMN(requests, true);
+    out[n++] = SIM_COLUMN(request_granted_uL, true);
+    out[n++] = SIM_COLUMN(park_requests, true);
+    out[n++] = SIM_COLUMN(free_slots, true);
+    out[n++] = SIM_COLUMN(compaction_remap, true);
+    return n;
+}
+
+#undef SIM_COLUMN
+
+// Grows every per-bee array to at least needed slots (doubling), keeping the
+// contents. The wake wheel is sized by capacity, so parked bees are woken and
+// the wheel recreated. Leaves the state untouched on allocation failure.
+static bool sim_reserve_bees(SimState *state, size_t needed) {
+    if (needed <= state->capacity) {
+        return true;
+    }
+    size_t capacity = state->capacity * 2u;
+    if (capacity < needed) {
+        capacity = needed;
+    }
+    if (capacity >= UINT32_MAX) {
+        LOG_ERROR("sim: cannot grow beyond %zu bees", state->capacity);
+        return false;
+    }
+
+    SimBeeColumn columns[SIM_BEE_COLUMN_MAX];
+    size_t column_count = sim_bee_columns(state, columns);
+    void *grown[SIM_BEE_COLUMN_MAX] = {0};
+    bool ok = true;
+    for (size_t c = 0; c < column_count; ++c) {
+        if (*columns[c].data) {
+            grown[c] = alloc_aligned(columns[c].elem_size * capacity);
+            ok = ok && grown[c];
+        }
+    }
+    size_t chunk_capacity = (capacity + SIM_TICK_CHUNK_BEES - 1u) / SIM_TICK_CHUNK_BEES;
+    SimChunkStats *chunk_stats = (SimChunkStats *)alloc_aligned(sizeof(SimChunkStats) * chunk_capacity);
+    TimerWheel *wake_wheel = NULL;
+    ok = ok && chunk_stats && timer_wheel_create(&wake_wheel, capacity, state->tick_index);
+    SimSpatialGrid spatial;
+    ok = ok && sim_spatial_init(&spatial, state->world_w, state->world_h, sim_spatial_cell_size(state, capacity), capacity);
+    if (!ok) {
+        LOG_ERROR("sim: failed to grow bee buffers to %zu", capacity);
+        for (size_t c = 0; c < column_count; ++c) {
+            free_aligned(grown[c]);
+        }
+        free_aligned(chunk_stats);
+        timer_wheel_destroy(wake_wheel);
+        return false;
+    }
+
+    sim_wake_all(state);
+    for (size_t c = 0; c < column_count; ++c) {
+        if (grown[c]) {
+            memcpy(grown[c], *columns[c].data, columns[c].elem_size * state->capacity);
+            sim_free_column(state, *columns[c].data);
+            *columns[c].data = grown[c];
+        }
+    }
+    memcpy(chunk_stats, state->chunk_stats, sizeof(SimChunkStats) * state->chunk_capacity);
+    free_aligned(state->chunk_stats);
+    state->chunk_stats = chunk_stats;
+    state->chunk_capacity = chunk_capacity;
+    timer_wheel_destroy(state->wake_wheel);
+    state->wake_wheel = wake_wheel;
+    sim_spatial_free(&state->spatial);
+    state->spatial = spatial;
+    state->spatial_stale = true;
+    state->capacity = capacity;
+    LOG_INFO("sim: grew bee capacity to %zu", capacity);
+    return true;
+}
+
+// Turns slot i into a free slot: no position (NaN keeps it out of the spatial
+// queries), invisible, and ignored by the tick.
+static void sim_kill_bee(SimState *state, size_t i) {
+    sim_unpark(state, i);
+    state->x[i] = NAN;
+    state->y[i] = NAN;
+    state->vx[i] = 0.0f;
+    state->vy[i] = 0.0f;
+    if (state->radius) {
+        state->radius[i] = 0.0f;
+    }
+    if (state->color_rgba) {
+        state->color_rgba[i] = 0u;
+    }
+    if (state->scratch_xy) {
+        state->scratch_xy[2 * i + 0] = NAN;
+        state->scratch_xy[2 * i + 1] = NAN;
+    }
+    if (state->compact) {
+        state->energy_q[i] = 0;
+        state->load_q[i] = 0;
+    } else {
+        state->energy[i] = 0.0f;
+        state->load_nectar[i] = 0.0f;
+    }
+    state->target_id[i] = -1;
+    state->tile_index[i] = SIM_TILE_NONE;
+    state->bee_flags[i] = SIM_BEE_DEAD;
+    state->request_tile[i] = -1;
+    state->request_uL[i] = 0.0f;
+}
+
+// The population helpers below do the work of the public calls without
+// journaling, for the callers that are recorded as a whole.
+static size_t sim_spawn(SimState *state, BeeRole role, float age_days, float x, float y) {
+    size_t i;
+    if (state->free_count > 0) {
+        i = state->free_slots[--state->free_count];
+    } else {
+        if (!sim_reserve_bees(state, state->count + 1u)) {
+            return SIZE_MAX;
+        }
+        i = state->count++;
+        state->parked[i] = 0u;
+    }
+    float home_x = 0.0f;
+    float home_y = 0.0f;
+    sim_unload_point(state, &home_x, &home_y);
+    float heading = sim_rng_uniform01(sim_rng_key(state->seed), (uint32_t)i, state->tick_index,
+                                      SIM_RNG_SLOT(SIM_RNG_STREAM_SPAWN, 2)) *
+                        TWO_PI -
+                    (float)M_PI;
+    sim_init_bee(state, i, x, y, heading, age_days, role, home_x, home_y);
+    state->live_count++;
+    return i;
+}
+
+static bool sim_despawn(SimState *state, size_t index) {
+    if (index >= state->count || sim_bee_flag(state, index, SIM_BEE_DEAD)) {
+        return false;
+    }
+    sim_kill_bee(state, index);
+    state->free_slots[state->free_count++] = (uint32_t)index;
+    state->live_count--;
+    return true;
+}
+
+static size_t sim_compact_slots(SimState *state) {
+    if (state->free_count == 0) {
+        return 0;
+    }
+    sim_wake_all(state);
+    size_t old_count = state->count;
+    size_t live = 0;
+    for (size_t i = 0; i < old_count; ++i) {
+        state->compaction_remap[i] = sim_bee_flag(state, i, SIM_BEE_DEAD) ? UINT32_MAX : (uint32_t)live++;
+    }
+
+    // Stable: live bees keep their relative order, so the queen stays first
+    // and equal-distance picks still go to the older bee.
+    SimBeeColumn columns[SIM_BEE_COLUMN_MAX];
+    size_t column_count = sim_bee_columns(state, columns);
+    for (size_t c = 0; c < column_count; ++c) {
+        uint8_t *data = (uint8_t *)*columns[c].data;
+        size_t elem = columns[c].elem_size;
+        if (!data || columns[c].scratch) {
+            continue;
+        }
+        for (size_t i = 0; i < old_count; ++i) {
+            uint32_t to = state->compaction_remap[i];
+            if (to != UINT32_MAX && to != i) {
+                memcpy(data + (size_t)to * elem, data + i * elem, elem);
+            }
+        }
+    }
+    state->count = live;
+    state->live_count = live;
+    state->free_count = 0;
+    state->compaction_epoch++;
+    update_scratch(state);
+    state->spatial_stale = true;
+    return old_count - live;
+}
+
+size_t sim_spawn_bee(SimState *state, BeeRole role, float x, float y) {
+    if (!state) {
+        return SIZE_MAX;
+    }
+    sim_journal_note_spawn(state->journal, state, role, x, y);
+    return sim_spawn(state, role, 0.0f, x, y);
+}
+
+bool sim_despawn_bee(SimState *state, size_t index) {
+    if (!state) {
+        return false;
+    }
+    sim_journal_note_value(state->journal, state, SIM_JOURNAL_DESPAWN, index);
+    return sim_despawn(state, index);
+}
+
+size_t sim_compact(SimState *state) {
+    if (!state) {
+        return 0;
+    }
+    sim_journal_note(state->journal, state, SIM_JOURNAL_COMPACT);
+    return sim_compact_slots(state);
+}
+
+bool sim_set_population(SimState *state, size_t live_count) {
+    if (!state || live_count == 0) {
+        return false;
+    }
+    sim_journal_note_value(state->journal, state, SIM_JOURNAL_SET_POPULATION, live_count);
+    if (live_count > state->live_count + state->pooled_count) {
+        size_t births = live_count - state->live_count - state->pooled_count;
+        if (births > state->free_count && !sim_reserve_bees(state, state->count + births - state->free_count)) {
+            return false;
+        }
+        float home_x = 0.0f;
+        float home_y = 0.0f;
+        sim_unload_point(state, &home_x, &home_y);
+        const SimRngKey rng_key = sim_rng_key(state->seed);
+        while (state->live_count + state->pooled_count < live_count) {
+            float role_roll = sim_rng_uniform01(rng_key, (uint32_t)state->live_count, state->tick_index,
+                                                SIM_RNG_SLOT(SIM_RNG_STREAM_SPAWN, 3));
+            sim_spawn(state, bee_pick_role(0.0f, role_roll), 0.0f, home_x, home_y);
+        }
+    } else {
+        for (size_t day = 0; day < SIM_POOL_DAYS; ++day) {
+            for (size_t role = 0; role < SIM_POOL_ROLES; ++role) {
+                size_t excess = state->live_count + state->pooled_count - live_count;
+                size_t taken = state->caste_pool[role][day] < excess ? state->caste_pool[role][day] : excess;
+                state->caste_pool[role][day] -= (uint32_t)taken;
+                state->pooled_count -= taken;
+            }
+        }
+        // Newest slots go first; the queen in slot 0 is kept.
+        for (size_t i = state->count; i-- > 1 && state->live_count + state->pooled_count > live_count;) {
+            sim_despawn(state, i);
+        }
+        sim_compact_slots(state);
+    }
+    state->spatial_stale = true;
+    LOG_INFO("sim: population=%zu capacity=%zu", state->live_count, state->capacity);
+    return true;
+}
+
+size_t sim_live_count(const SimState *state) {
+    return state ? state->live_count : 0;
+}
+
+size_t sim_pooled_count(const SimState *state) {
+    return state ? state->pooled_count : 0;
+}
+
+static float sim_pool_day_fraction(const SimState *state, double now_sec) {
+    return (float)((now_sec - state->pool_day_start_sec) / 86400.0);
+}
+
+// Moves slot i, a bee parked until an event wakes it, into the cohort nearest
+// its age. Returns false, leaving the bee in place, for roles the pools do not
+// hold, a bee carrying nectar, or one old enough to take an outside role.
+static bool sim_pool_absorb(SimState *state, size_t i, float age_days, double now_sec) {
+    uint8_t role = sim_bee_role(state, i);
+    if (role >= SIM_POOL_ROLES || sim_bee_load(state, i) != 0.0f) {
+        return false;
+    }
+    float day = floorf(age_days - sim_pool_day_fraction(state, now_sec) + 0.5f);
+    if (!(day < (float)SIM_POOL_DAYS)) {
+        return false;
+    }
+    size_t cohort = day > 0.0f ? (size_t)day : 0u;
+    sim_despawn(state, i);
+    state->caste_pool[role][cohort]++;
+    state->pooled_count++;
+    return true;
+}
+
+// Materializes one bee of cohort (role, day) as new_role, resting at the
+// unload point. Returns its index, or SIZE_MAX (leaving it pooled) if
+// capacity could not grow.
+static size_t sim_pool_release(SimState *state, size_t role, size_t day, BeeRole new_role, double now_sec) {
+    float x = 0.0f;
+    float y = 0.0f;
+    sim_unload_point(state, &x, &y);
+    float age_days = (float)day + sim_pool_day_fraction(state, now_sec);
+    size_t i = sim_spawn(state, new_role, age_days, x, y);
+    if (i == SIZE_MAX) {
+        LOG_ERROR("sim: failed to materialize a pooled bee");
+        return SIZE_MAX;
+    }
+    state->caste_pool[role][day]--;
+    state->pooled_count--;
+    return i;
+}
+
+// Ages the cohorts by a day for every day boundary sim time has passed. The
+// oldest cohort draws its outside roles and is materialized; the others take
+// up the in-hive role of their new age.
+static void sim_pool_advance(SimState *state, double now_sec) {
+    const SimRngKey rng_key = sim_rng_key(state->seed);
+    while (now_sec - state->pool_day_start_sec >= 86400.0) {
+        const size_t last = SIM_POOL_DAYS - 1u;
+        for (size_t role = 0; role < SIM_POOL_ROLES; ++role) {
+            while (state->caste_pool[role][last] > 0) {
+                float role_roll = sim_rng_uniform01(rng_key, (uint32_t)state->pooled_count, state->tick_index,
+                                                    SIM_RNG_SLOT(SIM_RNG_STREAM_SPAWN, 4));
+                BeeRole new_role = bee_pick_role((float)SIM_POOL_DAYS, role_roll);
+                if (sim_pool_release(state, role, last, new_role, now_sec) == SIZE_MAX) {
+                    break;  // kept until the next day
+                }
+            }
+        }
+        for (size_t day = last; day-- > 0;) {
+            for (size_t role = 0; role < SIM_POOL_ROLES; ++role) {
+                size_t next_role = (size_t)bee_pick_role((float)(day + 1u), 0.0f);
+                if (next_role < role) {
+                    next_role = role;
+                }
+                state->caste_pool[next_role][day + 1u] += state->caste_pool[role][day];
+                state->caste_pool[role][day] = 0;
+            }
+        }
+        state->pool_day_start_sec += 86400.0;
+    }
+}
+
+void sim_set_caste_pools(SimState *state, bool enabled) {
+    if (!state || state->caste_pools == enabled) {
+        return;
+    }
+    sim_journal_note_option(state->journal, state, SIM_JOURNAL_OPTION_CASTE_POOLS, enabled);
+    if (enabled) {
+        state->pool_day_start_sec = state->sim_time_sec;
+        for (size_t i = 0; i < state->count; ++i) {
+            if (state->parked[i] && timer_wheel_due(state->wake_wheel, (uint32_t)i) == UINT64_MAX) {
+                float energy = 0.0f;
+                float t_state = 0.0f;
+                float age_days = 0.0f;
+                sim_parked_values(state, i, &energy, &t_state, &age_days);
+                sim_pool_absorb(state, i, age_days, state->sim_time_sec);
+            }
+        }
+    } else {
+        for (size_t role = 0; role < SIM_POOL_ROLES; ++role) {
+            for (size_t day = 0; day < SIM_POOL_DAYS; ++day) {
+                while (state->caste_pool[role][day] > 0) {
+                    if (sim_pool_release(state, role, day, (BeeRole)role, state->sim_time_sec) == SIZE_MAX) {
+                        return;  // the rest stay pooled, and pools on
+                    }
+                }
+            }
+        }
+    }
+    state->caste_pools = enabled;
+    state->spatial_stale = true;
+    LOG_INFO("sim: caste pools %s pooled=%zu live=%zu", enabled ? "on" : "off", state->pooled_count, state->live_count);
+}
+
+size_t sim_unpool_bee(SimState *state) {
+    if (!state || state->pooled_count == 0) {
+        return SIZE_MAX;
+    }
+    sim_journal_note(state->journal, state, SIM_JOURNAL_UNPOOL);
+    float roll = sim_rng_uniform01(sim_rng_key(state->seed), (uint32_t)state->pooled_count, state->tick_index,
+                                   SIM_RNG_SLOT(SIM_RNG_STREAM_SPAWN, 5));
+    size_t pick = (size_t)((double)roll * (double)state->pooled_count);
+    if (pick >= state->pooled_count) {
+        pick = state->pooled_count - 1u;
+    }
+    for (size_t role = 0; role < SIM_POOL_ROLES; ++role) {
+        for (size_t day = 0; day < SIM_POOL_DAYS; ++day) {
+            if (pick < state->caste_pool[role][day]) {
+                return sim_pool_release(state, role, day, (BeeRole)role, state->sim_time_sec);
+            }
+            pick -= state->caste_pool[role][day];
+        }
+    }
+    return SIZE_MAX;
+}
+
+uint64_t sim_compaction_epoch(const SimState *state) {
+    return state ? state->compaction_epoch : 0;
+}
+
+size_t sim_compacted_index(const SimState *state, size_t index, uint64_t epoch) {
+    if (!state || index == SIZE_MAX) {
+        return SIZE_MAX;
+    }
+    if (epoch == state->compaction_epoch) {
+        return index;
+    }
+    if (epoch + 1u != state->compaction_epoch || index >= state->capacity) {
+        return SIZE_MAX;
+    }
+    uint32_t moved = state->compaction_remap[index];
+    return moved == UINT32_MAX ? SIZE_MAX : (size_t)moved;
+}
+
+uint64_t sim_tick_index(const SimState *state) {
+    return state ? state->tick_index : 0;
+}
+
+size_t sim_parked_count(const SimState *state) {
+    if (!state) {
+        return 0;
+    }
+    size_t parked = 0;
+    size_t chunk_count = (state->count + SIM_TICK_CHUNK_BEES - 1u) / SIM_TICK_CHUNK_BEES;
+    for (size_t c = 0; c < chunk_count; ++c) {
+        parked += state->chunk_stats[c].parked_count;
+    }
+    return parked;
+}
+
+SimKinematicsKernel sim_get_kinematics_kernel(const SimState *state) {
+    return state ? state->kinematics_kernel : SIM_KINEMATICS_SCALAR;
+}
+
+const char *sim_kinematics_kernel_name(SimKinematicsKernel kernel) {
+    switch (kernel) {
+        case SIM_KINEMATICS_AUTO: return "auto";
+        case SIM_KINEMATICS_SCALAR: return "scalar";
+        case SIM_KINEMATICS_SSE2: return "sse2";
+        case SIM_KINEMATICS_AVX2: return "avx2";
+        default: return "unknown";
+    }
+}
+
+typedef struct SimTickFrame {
+    SimState *state;
+    float dt_sec;
+    float stamp_dt_sec;  // length of every tick since an outstanding park_tick
+    bool catch_up;       // the step length changed: no bee lags this tick
+    SimRngKey rng_key;
+    uint64_t tick_index;
+    double sim_time_after;  // sim_time_sec once this tick completes
+    float world_w;
+    float world_h;
+    float bounce_margin;
+    float base_speed;
+    float max_speed;
+    float seek_accel;
+    float arrive_tol;
+    float entrance_x;
+    float entrance_y;
+    float unload_x;
+    float unload_y;
+    float hive_center_x;
+    float hive_center_y;
+    bool any_patch_available;
+    // Level of detail: the detail region grown by the margin, the circle the
+    // hive walls lie in (radius 0 without a hive) and the unit direction from
+    // its center out through the entrance.
+    bool lod;
+    float lod_min_x;
+    float lod_min_y;
+    float lod_max_x;
+    float lod_max_y;
+    float lod_hive_x;
+    float lod_hive_y;
+    float lod_hive_radius;
+    float lod_entrance_dir_x;
+    float lod_entrance_dir_y;
+    float lod_speed_scale;   // mean forward progress of jittered flight
+    float lod_effort_scale;  // its inverse: coarse flight pays for full speed
+    // Compact mode has no radius column; the kinematics kernel reads this.
+    float uniform_radius[SIM_TICK_CHUNK_BEES];
+} SimTickFrame;
+
+// Per-bee values carried from the steering stage, through the kinematics
+// kernel, to the resolve stage of one chunk.
+typedef struct SimChunkLanes {
+    float desired_vx[SIM_TICK_CHUNK_BEES];
+    float desired_vy[SIM_TICK_CHUNK_BEES];
+    float damp[SIM_TICK_CHUNK_BEES];
+    float new_x[SIM_TICK_CHUNK_BEES];
+    float new_y[SIM_TICK_CHUNK_BEES];
+    float target_x[SIM_TICK_CHUNK_BEES];
+    float target_y[SIM_TICK_CHUNK_BEES];
+    float path_waypoint_x[SIM_TICK_CHUNK_BEES];
+    float path_waypoint_y[SIM_TICK_CHUNK_BEES];
+    int32_t target_id[SIM_TICK_CHUNK_BEES];
+    uint8_t mode[SIM_TICK_CHUNK_BEES];
+    uint8_t prev_mode[SIM_TICK_CHUNK_BEES];
+    uint8_t intent[SIM_TICK_CHUNK_BEES];
+    uint8_t inside_before[SIM_TICK_CHUNK_BEES];
+    uint8_t path_valid[SIM_TICK_CHUNK_BEES];
+    uint8_t path_has_waypoint[SIM_TICK_CHUNK_BEES];
+    uint8_t settled[SIM_TICK_CHUNK_BEES];  // 1: final state already written
+    uint8_t coarse[SIM_TICK_CHUNK_BEES];   // 1: steered at the coarse level of detail
+    float dt_sec[SIM_TICK_CHUNK_BEES];     // tick length plus any time skipped by multi-rate
+} SimChunkLanes;
+
+// Chunk-local bee indices grouped by the mode each bee entered the tick in.
+// Each bucket runs its own homogeneous fast path; bees that leave their mode's
+// steady state this tick, and all flight modes, go through the generic path.
+typedef struct SimChunkBuckets {
+    uint16_t active[SIM_TICK_CHUNK_BEES];  // every lane not parked, in slot order
+    uint16_t idle[SIM_TICK_CHUNK_BEES];
+    uint16_t foraging[SIM_TICK_CHUNK_BEES];
+    uint16_t unloading[SIM_TICK_CHUNK_BEES];
+    uint16_t generic[SIM_TICK_CHUNK_BEES];
+    size_t active_count;
+    size_t idle_count;
+    size_t foraging_count;
+    size_t unloading_count;
+    size_t generic_count;
+} SimChunkBuckets;
+
+static bool sim_point_inside_walls(const SimTickFrame *frame, float x, float y, float radius) {
+    float min_x = radius + frame->bounce_margin;
+    float max_x = frame->world_w - radius - frame->bounce_margin;
+    if (min_x > max_x) {
+        min_x = max_x = frame->world_w * 0.5f;
+    }
+    float min_y = radius + frame->bounce_margin;
+    float max_y = frame->world_h - radius - frame->bounce_margin;
+    if (min_y > max_y) {
+        min_y = max_y = frame->world_h * 0.5f;
+    }
+    return x >= min_x && x <= max_x && y >= min_y && y <= max_y;
+}
+
+// Multi-rate: true if bee i is held in place in a mode with a sub-rate and
+// this is not its tick. Phases are staggered by index so every tick advances
+// an even share of each chunk. The wall test keeps the kinematics kernel from
+// counting a bounce for the skipped lane.
+static bool sim_rate_skips(const SimTickFrame *frame, size_t i, uint8_t mode) {
+    const SimState *state = frame->state;
+    uint64_t rate = 0;
+    switch (mode) {
+        case BEE_MODE_IDLE: rate = SIM_RATE_IDLE_TICKS; break;
+        case BEE_MODE_FORAGING:
+        case BEE_MODE_UNLOADING: rate = SIM_RATE_HOLD_TICKS; break;
+        default: return false;
+    }
+    if (((frame->tick_index + i) & (rate - 1u)) == 0u) {
+        return false;
+    }
+    return state->vx[i] == 0.0f && state->vy[i] == 0.0f &&
+           sim_point_inside_walls(frame, state->x[i], state->y[i], sim_bee_radius(state, i));
+}
+
+static unsigned sim_lowest_bit(uint64_t word) {
+#if defined(_MSC_VER)
+    unsigned long index = 0;
+    _BitScanForward64(&index, word);
+    return (unsigned)index;
+#else
+    return (unsigned)__builtin_ctzll(word);
+#endif
+}
+
+// Lists the chunk's lanes that are not parked and sorts them into the mode
+// buckets. Parked lanes are skipped through the chunk's parked mask, so they
+// never reach the buckets, the kinematics kernel or the resolve stage.
+static void sim_chunk_bucket(const SimTickFrame *frame,
+                             size_t begin,
+                             size_t end,
+                             const SimChunkStats *stats,
+                             SimChunkBuckets *buckets,
+                             SimChunkLanes *lanes) {
+    SimState *state = frame->state;
+    const bool multi_rate = state->multi_rate && state->mode_buckets;
+    const size_t lane_count = end - begin;
+    buckets->active_count = 0;
+    buckets->idle_count = 0;
+    buckets->foraging_count = 0;
+    buckets->unloading_count = 0;
+    buckets->generic_count = 0;
+    for (size_t w = 0; w * 64u < lane_count; ++w) {
+        uint64_t awake = ~stats->parked_mask[w];
+        if (lane_count - w * 64u < 64u) {
+            awake &= (UINT64_C(1) << (lane_count - w * 64u)) - 1u;
+        }
+        for (; awake != 0u; awake &= awake - 1u) {
+            buckets->active[buckets->active_count++] = (uint16_t)(w * 64u + sim_lowest_bit(awake));
+        }
+    }
+    for (size_t k = 0; k < buckets->active_count; ++k) {
+        uint16_t j = buckets->active[k];
+        size_t i = begin + j;
+        if (sim_bee_flag(state, i, SIM_BEE_DEAD)) {
+            lanes->desired_vx[j] = 0.0f;
+            lanes->desired_vy[j] = 0.0f;
+            lanes->damp[j] = 1.0f;
+            lanes->settled[j] = 1u;
+            continue;
+        }
+        uint8_t mode = sim_bee_mode(state, i);
+        if (multi_rate && !frame->catch_up && sim_rate_skips(frame, i, mode)) {
+            if (!sim_bee_flag(state, i, SIM_BEE_LAGGING)) {
+                sim_bee_set_flag(state, i, SIM_BEE_LAGGING, true);
+                state->park_tick[i] = (uint32_t)frame->tick_index;
+            }
+            lanes->desired_vx[j] = 0.0f;
+            lanes->desired_vy[j] = 0.0f;
+            lanes->damp[j] = 1.0f;
+            lanes->settled[j] = 1u;
+            state->request_tile[i] = -1;
+            continue;
+        }
+        lanes->settled[j] = 0u;
+        lanes->dt_sec[j] = frame->dt_sec;
+        if (sim_bee_flag(state, i, SIM_BEE_LAGGING)) {
+            uint32_t held_ticks = (uint32_t)frame->tick_index - state->park_tick[i];
+            lanes->dt_sec[j] = (float)held_ticks * frame->stamp_dt_sec + frame->dt_sec;
+            sim_bee_set_flag(state, i, SIM_BEE_LAGGING, false);
+        }
+        if (!state->mode_buckets) {
+            buckets->generic[buckets->generic_count++] = j;
+            continue;
+        }
+        switch (mode) {
+            case BEE_MODE_IDLE:
+                buckets->idle[buckets->idle_count++] = j;
+                break;
+            case BEE_MODE_FORAGING:
+                buckets->foraging[buckets->foraging_count++] = j;
+                break;
+            case BEE_MODE_UNLOADING:
+                buckets->unloading[buckets->unloading_count++] = j;
+                break;
+            default:
+                buckets->generic[buckets->generic_count++] = j;
+                break;
+        }
+    }
+}
+
+// Lanes for a bee that keeps its mode and target and is damped in place.
+static void sim_lane_hold(SimChunkLanes *lanes,
+                          size_t j,
+                          uint8_t mode,
+                          uint8_t intent,
+                          float target_x,
+                          float target_y,
+                          int32_t target_id,
+                          uint8_t inside) {
+    lanes->desired_vx[j] = 0.0f;
+    lanes->desired_vy[j] = 0.0f;
+    lanes->damp[j] = 1.0f;
+    lanes->target_x[j] = target_x;
+    lanes->target_y[j] = target_y;
+    lanes->path_waypoint_x[j] = target_x;
+    lanes->path_waypoint_y[j] = target_y;
+    lanes->target_id[j] = target_id;
+    lanes->mode[j] = mode;
+    lanes->prev_mode[j] = mode;
+    lanes->intent[j] = intent;
+    lanes->inside_before[j] = inside;
+    lanes->path_valid[j] = 0u;
+    lanes->path_has_waypoint[j] = 0u;
+    lanes->coarse[j] = 0u;
+}
+
+// Tick at which a parked resting bee's decision could first change, 0 if it
+// could change now (it is only waiting for a floral patch), or UINT64_MAX if
+// it rests until an event wakes it.
+static uint64_t sim_rest_wake_tick(const SimTickFrame *frame, uint8_t role, float energy, float t_state, float rest_recovery) {
+    if (role != BEE_ROLE_FORAGER && role != BEE_ROLE_SCOUT) {
+        return UINT64_MAX;
+    }
+    float need_sec = BEE_MIN_REST_SEC - t_state;
+    float energy_sec = (BEE_ENERGY_HIGH - energy) / rest_recovery;
+    if (energy_sec > need_sec) {
+        need_sec = energy_sec;
+    }
+    if (need_sec <= 0.0f) {
+        return 0;
+    }
+    // The bee has rested (m - 1) ticks past this one when tick index + m starts.
+    return frame->tick_index + 1u + (uint64_t)ceilf(need_sec / frame->dt_sec);
+}
+
+// IDLE bucket: an empty, motionless bee resting inside the hive only recovers
+// energy and ages, so its whole tick is written here and the resolve stage
+// skips it. The kinematics kernel leaves it in place (zero velocity, damped,
+// away from the walls). Writes exactly what the generic stages would. With
+// hibernation on, a bee whose next decision is known is then parked.
+static void sim_chunk_idle(const SimTickFrame *frame,
+                           size_t begin,
+                           SimChunkBuckets *buckets,
+                           SimChunkLanes *lanes,
+                           SimChunkStats *stats) {
+    SimState *state = frame->state;
+    const float unload_x = frame->unload_x;
+    const float unload_y = frame->unload_y;
+    const float rest_recovery = sim_rest_recovery(state);
+
+    for (size_t k = 0; k < buckets->idle_count; ++k) {
+        uint16_t j = buckets->idle[k];
+        size_t i = begin + j;
+        float energy = sim_bee_energy(state, i);
+        float load = sim_bee_load(state, i);
+        float capacity = sim_bee_capacity(state, i);
+        uint8_t role = sim_bee_role(state, i);
+        if (sim_bee_intent(state, i) != BEE_INTENT_REST || !sim_bee_flag(state, i, SIM_BEE_INSIDE_HIVE) ||
+            state->vx[i] != 0.0f || state->vy[i] != 0.0f || load > BEE_LOAD_EMPTY_RATIO * capacity ||
+            !bee_keeps_resting(role, energy, state->t_state[i], frame->any_patch_available) ||
+            !sim_point_inside_walls(frame, state->x[i], state->y[i], sim_bee_radius(state, i))) {
+            buckets->generic[buckets->generic_count++] = j;
+            continue;
+        }
+
+        sim_lane_hold(lanes, j, BEE_MODE_IDLE, BEE_INTENT_REST, unload_x, unload_y, -1, 1u);
+        lanes->settled[j] = 1u;
+        const float dt_sec = lanes->dt_sec[j];
+
+        energy += rest_recovery * dt_sec;
+        if (energy < 0.0f) energy = 0.0f;
+        if (energy > 1.0f) energy = 1.0f;
+        if (load < 0.0f) load = 0.0f;
+        if (load > capacity) load = capacity;
+
+        state->vx[i] = 0.0f;
+        state->vy[i] = 0.0f;
+        sim_store_bee_state(state, i, energy, load, frame->tick_index, SIM_STORE_SITE_TICK);
+        state->request_tile[i] = -1;
+        state->request_uL[i] = 0.0f;
+        sim_bee_set_field(state, i, SIM_BEE_INTENT_SHIFT, BEE_INTENT_REST);
+        sim_bee_set_flag(state, i, SIM_BEE_PATH_VALID | SIM_BEE_PATH_WAYPOINT, false);
+        if (state->color_rgba) {
+            state->color_rgba[i] = bee_color_for(role, BEE_MODE_IDLE);
+        }
+        if (state->path_waypoint_x) {
+            state->path_waypoint_x[i] = unload_x;
+        }
+        if (state->path_waypoint_y) {
+            state->path_waypoint_y[i] = unload_y;
+        }
+        state->target_pos_x[i] = unload_x;
+        state->target_pos_y[i] = unload_y;
+        state->target_id[i] = -1;
+        float t_state = state->t_state[i] + dt_sec;
+        state->t_state[i] = t_state;
+        state->age_days[i] += dt_sec / 86400.0f;
+        uint8_t prev_conf = state->topic_confidence[i];
+        float conf = (float)prev_conf;
+        conf -= dt_sec * 20.0f;
+        if (conf < 0.0f) conf = 0.0f;
+        if (conf > 255.0f) conf = 255.0f;
+        state->topic_confidence[i] = (uint8_t)(conf + 0.5f);
+        if (state->scratch_xy) {
+            state->scratch_xy[2 * i + 0] = state->x[i];
+            state->scratch_xy[2 * i + 1] = state->y[i];
+        }
+
+        // Every other column is now constant while the bee rests; the topic
+        // confidence must be too before the bee can park.
+        if (!state->hibernation || state->topic_confidence[i] != prev_conf) {
+            continue;
+        }
+        uint64_t wake_tick = sim_rest_wake_tick(frame, role, sim_bee_energy(state, i), t_state, rest_recovery);
+        if (wake_tick == 0) {
+            continue;
+        }
+        sim_set_parked(state, i, true);
+        state->park_tick[i] = (uint32_t)(frame->tick_index + 1u);
+        SimParkRequest *request = &state->park_requests[begin + stats->park_request_count++];
+        request->due_tick = wake_tick;
+        request->bee = (uint32_t)i;
+    }
+}
+
+// FORAGING bucket: a bee that keeps harvesting holds its tile and is damped in
+// place; decision, floral choice and path planning are skipped.
+static void sim_chunk_foraging(const SimTickFrame *frame, size_t begin, SimChunkBuckets *buckets, SimChunkLanes *lanes) {
+    SimState *state = frame->state;
+    for (size_t k = 0; k < buckets->foraging_count; ++k) {
+        uint16_t j = buckets->foraging[k];
+        size_t i = begin + j;
+        int32_t target_id = state->target_id[i];
+        if (!sim_tile_valid(state, target_id) || sim_bee_intent(state, i) != BEE_INTENT_HARVEST ||
+            sim_bee_flag(state, i, SIM_BEE_INSIDE_HIVE) ||
+            !bee_keeps_harvesting(sim_bee_energy(state, i),
+                                  sim_bee_load(state, i) / sim_bee_capacity(state, i),
+                                  hex_world_tile_nectar_stock(state->hex_world, (size_t)target_id),
+                                  state->hex_world->nectar_capacity[target_id],
+                                  state->t_state[i])) {
+            buckets->generic[buckets->generic_count++] = j;
+            continue;
+        }
+        float center_x = 0.0f;
+        float center_y = 0.0f;
+        sim_tile_center(state, (size_t)target_id, &center_x, &center_y);
+        sim_lane_hold(lanes, j, BEE_MODE_FORAGING, BEE_INTENT_HARVEST, center_x, center_y, target_id, 0u);
+    }
+}
+
+// UNLOADING bucket: a loaded bee already at the unload point stays there.
+static void sim_chunk_unloading(const SimTickFrame *frame, size_t begin, SimChunkBuckets *buckets, SimChunkLanes *lanes) {
+    SimState *state = frame->state;
+    const float unload_x = frame->unload_x;
+    const float unload_y = frame->unload_y;
+    for (size_t k = 0; k < buckets->unloading_count; ++k) {
+        uint16_t j = buckets->unloading[k];
+        size_t i = begin + j;
+        float dx = unload_x - state->x[i];
+        float dy = unload_y - state->y[i];
+        float distance = sqrtf(dx * dx + dy * dy);
+        if (sim_bee_intent(state, i) != BEE_INTENT_UNLOAD || !sim_bee_flag(state, i, SIM_BEE_INSIDE_HIVE) ||
+            sim_bee_load(state, i) <= BEE_LOAD_EMPTY_RATIO * sim_bee_capacity(state, i) ||
+            distance > frame->arrive_tol) {
+            buckets->generic[buckets->generic_count++] = j;
+            continue;
+        }
+        sim_lane_hold(lanes, j, BEE_MODE_UNLOADING, BEE_INTENT_UNLOAD, unload_x, unload_y, -1, 1u);
+    }
+}
+
+// Level of detail: true, with the unit direction to the target, when bee
+// (x, y) is outside the grown detail region and the straight leg to the
+// target provably misses the hive walls, so bee_path_plan would fly it
+// straight too. A leg ending at the entrance (a corner tile of the hive hex)
+// qualifies only from within 45 degrees of its outward direction, which keeps
+// the wall tiles beside it clear of the leg.
+static bool sim_coarse_leg(const SimTickFrame *frame,
+                           float x,
+                           float y,
+                           float target_x,
+                           float target_y,
+                           float distance,
+                           float *out_dir_x,
+                           float *out_dir_y) {
+    if (!frame->lod ||
+        (x >= frame->lod_min_x && x <= frame->lod_max_x && y >= frame->lod_min_y && y <= frame->lod_max_y)) {
+        return false;
+    }
+    float radius = frame->lod_hive_radius;
+    if (radius > 0.0f) {
+        float px = x - frame->lod_hive_x;
+        float py = y - frame->lod_hive_y;
+        if (px * px + py * py <= radius * radius) {
+            return false;
+        }
+        float tx = target_x - frame->lod_hive_x;
+        float ty = target_y - frame->lod_hive_y;
+        if (tx * tx + ty * ty <= radius * radius) {
+            float ex = x - frame->entrance_x;
+            float ey = y - frame->entrance_y;
+            bool to_entrance = target_x == frame->entrance_x && target_y == frame->entrance_y;
+            float outward = ex * frame->lod_entrance_dir_x + ey * frame->lod_entrance_dir_y;
+            if (!to_entrance || outward < 0.7071f * sqrtf(ex * ex + ey * ey)) {
+                return false;
+            }
+        } else {
+            // Closest approach of the leg to the hive center.
+            float lx = tx - px;
+            float ly = ty - py;
+            float len_sq = lx * lx + ly * ly;
+            float t = len_sq > 0.0f ? -(px * lx + py * ly) / len_sq : 0.0f;
+            if (t < 0.0f) t = 0.0f;
+            if (t > 1.0f) t = 1.0f;
+            float cx = px + lx * t;
+            float cy = py + ly * t;
+            if (cx * cx + cy * cy <= radius * radius) {
+                return false;
+            }
+        }
+    }
+    float inv_dist = 1.0f / distance;
+    *out_dir_x = (target_x - x) * inv_dist;
+    *out_dir_y = (target_y - y) * inv_dist;
+    return true;
+}
+
+// Stage 1 (generic path): decision, target selection and path planning for the
+// listed bees. Produces the desired velocity (or a damping flag) for the
+// kinematics kernel.
+static void sim_chunk_steer(const SimTickFrame *frame,
+                            size_t begin,
+                            const uint16_t *list,
+                            size_t list_count,
+                            SimChunkLanes *lanes) {
+    SimState *state = frame->state;
+    const float dt_sec = frame->dt_sec;
+    const float base_speed = frame->base_speed;
+    const float arrive_tol = frame->arrive_tol;
+    const float entrance_x = frame->entrance_x;
+    const float entrance_y = frame->entrance_y;
+    const float unload_x = frame->unload_x;
+    const float unload_y = frame->unload_y;
+    const bool any_patch_available = frame->any_patch_available;
+    const SimRngKey rng_key = frame->rng_key;
+    const uint64_t tick = frame->tick_index;
+
+    if (list_count == 0) {
+        return;
+    }
+    // Draws cover only the span of the listed lanes. The fast paths hand
+    // their leavers over after the bucket pass, so the list is not sorted.
+    size_t first = SIM_TICK_CHUNK_BEES;
+    size_t last = 0;
+    for (size_t k = 0; k < list_count; ++k) {
+        first = list[k] < first ? list[k] : first;
+        last = list[k] > last ? list[k] : last;
+    }
+    float flight_jitter[SIM_TICK_CHUNK_BEES];
+    sim_rng_fill_uniform01(rng_key,
+                           (uint32_t)(begin + first),
+                           last + 1u - first,
+                           tick,
+                           SIM_RNG_SLOT(SIM_RNG_STREAM_FLIGHT_JITTER, 0),
+                           flight_jitter + first);
+
+    for (size_t k = 0; k < list_count; ++k) {
+        size_t j = list[k];
+        size_t i = begin + j;
         float x = state->x[i];
         float y = state->y[i];
-        float vx = state->vx[i];
-        float vy = state->vy[i];
-        float heading = state->heading[i];
-        float radius = state->radius[i];
-        float energy = state->energy[i];
-        float load = state->load_nectar[i];
-        uint8_t prev_mode = state->mode[i];
-        uint8_t prev_intent = state->intent[i];
+        float energy = sim_bee_energy(state, i);
+        float load = sim_bee_load(state, i);
+        uint8_t prev_mode = sim_bee_mode(state, i);
+        uint8_t prev_intent = sim_bee_intent(state, i);
         float prev_t_state = state->t_state[i];
         int32_t target_id = state->target_id[i];
         float target_x = state->target_pos_x[i];
         float target_y = state->target_pos_y[i];
-        float capacity = state->capacity_uL[i] > 0.0f ? state->capacity_uL[i] : state->bee_capacity_uL;
-        if (capacity <= 0.0f) {
-            capacity = 50.0f;
-        }
-        float harvest_rate = state->harvest_rate_uLps[i] > 0.0f ? state->harvest_rate_uLps[i] : state->bee_harvest_rate_uLps;
+        float capacity = sim_bee_capacity(state, i);
 
-        const HexTile *target_tile = sim_get_tile_const(state, target_id);
+        bool target_valid = sim_tile_valid(state, target_id);
         float tile_center_x = target_x;
         float tile_center_y = target_y;
-        if (target_tile) {
+        if (target_valid) {
             sim_tile_center(state, (size_t)target_id, &tile_center_x, &tile_center_y);
         }
-        bool inside_hive_now = sim_point_inside_hive(state, x, y);
+        bool inside_hive_now = sim_tile_inside_hive(state, state->tile_index[i]);
 
         float current_arrive_tol = arrive_tol;
-        if (target_tile && (prev_mode == BEE_MODE_OUTBOUND || prev_mode == BEE_MODE_FORAGING ||
+        if (target_valid && (prev_mode == BEE_MODE_OUTBOUND || prev_mode == BEE_MODE_FORAGING ||
                             prev_intent == BEE_INTENT_FIND_PATCH || prev_intent == BEE_INTENT_HARVEST)) {
             float tile_tol = state->hex_world ? state->hex_world->cell_radius * 0.6f : state->default_radius * 2.0f;
             if (tile_tol > current_arrive_tol) {
@@ -799,21 +2055,21 @@ void sim_tick(SimState *state, float dt_sec) {
             .energy = energy,
             .load_uL = load,
             .capacity_uL = capacity,
-            .patch_stock = target_tile ? target_tile->nectar_stock : 0.0f,
-            .patch_capacity = target_tile ? target_tile->nectar_capacity : 0.0f,
-            .patch_quality = target_tile ? target_tile->flower_quality : 0.0f,
+            .patch_stock = target_valid ? hex_world_tile_nectar_stock(state->hex_world, (size_t)target_id) : 0.0f,
+            .patch_capacity = target_valid ? state->hex_world->nectar_capacity[target_id] : 0.0f,
+            .patch_quality = target_valid ? state->hex_world->flower_quality[target_id] : 0.0f,
             .state_time = prev_t_state,
             .dt_sec = dt_sec,
-            .hive_center_x = hive_center_x,
-            .hive_center_y = hive_center_y,
+            .hive_center_x = frame->hive_center_x,
+            .hive_center_y = frame->hive_center_y,
             .entrance_x = entrance_x,
             .entrance_y = entrance_y,
             .unload_x = unload_x,
             .unload_y = unload_y,
-            .forage_target_x = target_tile ? tile_center_x : target_x,
-            .forage_target_y = target_tile ? tile_center_y : target_y,
+            .forage_target_x = target_valid ? tile_center_x : target_x,
+            .forage_target_y = target_valid ? tile_center_y : target_y,
             .arrive_tol = current_arrive_tol,
-            .role = state->role[i],
+            .role = sim_bee_role(state, i),
             .previous_mode = prev_mode,
             .previous_intent = prev_intent,
             .patch_id = target_id,
@@ -829,8 +2085,8 @@ void sim_tick(SimState *state, float dt_sec) {
         bool mode_changed = (mode != prev_mode);
 
         if (mode == BEE_MODE_OUTBOUND || mode == BEE_MODE_FORAGING) {
-            if (target_id < 0 || !sim_get_tile_const(state, target_id)) {
-                int32_t chosen = sim_choose_floral_tile(state, x, y, &rng);
+            if (target_id < 0 || !sim_tile_valid(state, target_id)) {
+                int32_t chosen = sim_choose_floral_tile(state, x, y, rng_key, (uint32_t)i, tick);
                 if (chosen != target_id) {
                     target_id = chosen;
                     mode_changed = true;
@@ -838,26 +2094,28 @@ void sim_tick(SimState *state, float dt_sec) {
             }
         }
 
-        target_tile = sim_get_tile_const(state, target_id);
-        if ((mode == BEE_MODE_OUTBOUND || mode == BEE_MODE_FORAGING) && !target_tile) {
+        target_valid = sim_tile_valid(state, target_id);
+        if ((mode == BEE_MODE_OUTBOUND || mode == BEE_MODE_FORAGING) && !target_valid) {
             intent = BEE_INTENT_REST;
             mode = BEE_MODE_IDLE;
             target_id = -1;
         }
 
-        if (target_tile) {
+        if (target_valid) {
             sim_tile_center(state, (size_t)target_id, &tile_center_x, &tile_center_y);
         }
 
-        if (mode == BEE_MODE_OUTBOUND && target_tile) {
+        if (mode == BEE_MODE_OUTBOUND && target_valid) {
             if (mode_changed || target_id != state->target_id[i]) {
-                float jitter_angle = rand_uniform01(&rng) * TWO_PI;
+                float jitter_angle =
+                    sim_rng_uniform01(rng_key, (uint32_t)i, tick, SIM_RNG_SLOT(SIM_RNG_STREAM_OUTBOUND_TARGET, 0)) *
+                    TWO_PI;
                 float jitter_radius = state->hex_world ? state->hex_world->cell_radius * 0.35f
                                                        : state->default_radius * 1.5f;
                 target_x = tile_center_x + cosf(jitter_angle) * jitter_radius;
                 target_y = tile_center_y + sinf(jitter_angle) * jitter_radius;
             }
-        } else if (mode == BEE_MODE_FORAGING && target_tile) {
+        } else if (mode == BEE_MODE_FORAGING && target_valid) {
             target_x = tile_center_x;
             target_y = tile_center_y;
         } else if (mode == BEE_MODE_RETURNING || mode == BEE_MODE_ENTERING) {
@@ -869,7 +2127,7 @@ void sim_tick(SimState *state, float dt_sec) {
         }
 
         current_arrive_tol = arrive_tol;
-        if (target_tile && mode == BEE_MODE_FORAGING) {
+        if (target_valid && mode == BEE_MODE_FORAGING) {
             float tile_tol = state->hex_world ? state->hex_world->cell_radius * 0.5f : state->default_radius * 1.5f;
             if (tile_tol > current_arrive_tol) {
                 current_arrive_tol = tile_tol;
@@ -891,10 +2149,16 @@ void sim_tick(SimState *state, float dt_sec) {
 
         float desired_vx = 0.0f;
         float desired_vy = 0.0f;
+        uint8_t coarse = 0u;
         if (flight_mode) {
-            if (distance > 1e-5f) {
-                float dir_x = 0.0f;
-                float dir_y = 0.0f;
+            float dir_x = 0.0f;
+            float dir_y = 0.0f;
+            if (distance > 1e-5f && sim_coarse_leg(frame, x, y, target_x, target_y, distance, &dir_x, &dir_y)) {
+                path_valid = 1u;
+                coarse = 1u;
+                desired_vx = dir_x * base_speed * frame->lod_speed_scale;
+                desired_vy = dir_y * base_speed * frame->lod_speed_scale;
+            } else if (distance > 1e-5f) {
                 BeePathPlan path_plan = {0};
                 bool have_plan = bee_path_plan(state, i, target_x, target_y, current_arrive_tol, &path_plan);
                 if (have_plan && path_plan.valid) {
@@ -918,7 +2182,7 @@ void sim_tick(SimState *state, float dt_sec) {
                     path_waypoint_x = target_x;
                     path_waypoint_y = target_y;
                 }
-                float jitter = 0.08f * rand_symmetric(&rng);
+                float jitter = SIM_FLIGHT_JITTER_RAD * (flight_jitter[j] * 2.0f - 1.0f);
                 float cos_j = cosf(jitter);
                 float sin_j = sinf(jitter);
                 float rot_x = dir_x * cos_j - dir_y * sin_j;
@@ -926,132 +2190,164 @@ void sim_tick(SimState *state, float dt_sec) {
                 desired_vx = rot_x * base_speed;
                 desired_vy = rot_y * base_speed;
             }
-        } else {
-            vx *= 0.65f;
-            vy *= 0.65f;
-            if (fabsf(vx) < 1e-3f) vx = 0.0f;
-            if (fabsf(vy) < 1e-3f) vy = 0.0f;
-        }
-
-        float dvx = desired_vx - vx;
-        float dvy = desired_vy - vy;
-        float delta_v = sqrtf(dvx * dvx + dvy * dvy);
-        float max_delta = seek_accel * dt_sec;
-        if (delta_v > max_delta && delta_v > 1e-6f) {
-            float scale = max_delta / delta_v;
-            dvx *= scale;
-            dvy *= scale;
-        }
-        vx += dvx;
-        vy += dvy;
-
-        float speed = sqrtf(vx * vx + vy * vy);
-        if (speed > max_speed && speed > 1e-6f) {
-            float scale = max_speed / speed;
-            vx *= scale;
-            vy *= scale;
-            speed = max_speed;
         }
 
-        float new_x = x + vx * dt_sec;
-        float new_y = y + vy * dt_sec;
+        lanes->desired_vx[j] = desired_vx;
+        lanes->desired_vy[j] = desired_vy;
+        lanes->damp[j] = flight_mode ? 0.0f : 1.0f;
+        lanes->target_x[j] = target_x;
+        lanes->target_y[j] = target_y;
+        lanes->path_waypoint_x[j] = path_waypoint_x;
+        lanes->path_waypoint_y[j] = path_waypoint_y;
+        lanes->target_id[j] = target_id;
+        lanes->mode[j] = mode;
+        lanes->prev_mode[j] = prev_mode;
+        lanes->intent[j] = intent;
+        lanes->inside_before[j] = inside_hive_now ? 1u : 0u;
+        lanes->path_valid[j] = path_valid;
+        lanes->path_has_waypoint[j] = path_has_waypoint;
+        lanes->coarse[j] = coarse;
+    }
+}
 
-        float min_x = radius + bounce_margin;
-        float max_x = world_w - radius - bounce_margin;
-        if (min_x > max_x) {
-            float mid = world_w * 0.5f;
-            min_x = max_x = mid;
-        }
-        if (new_x < min_x) {
-            new_x = min_x;
-            vx = -vx * 0.3f;
-            ++bounce_counter;
-        } else if (new_x > max_x) {
-            new_x = max_x;
-            vx = -vx * 0.3f;
-            ++bounce_counter;
-        }
+// Stage 3: terrain collision, hive entry, energy, world requests and the
+// final column writes. Returns the chunk's speed statistics through stats.
+static void sim_chunk_resolve(const SimTickFrame *frame,
+                              size_t begin,
+                              size_t end,
+                              const SimChunkBuckets *buckets,
+                              const SimChunkLanes *lanes,
+                              SimChunkStats *stats) {
+    SimState *state = frame->state;
+    const float unload_x = frame->unload_x;
+    const float unload_y = frame->unload_y;
+    double speed_sum = 0.0;
+    float speed_min_tick = FLT_MAX;
+    float speed_max_tick = 0.0f;
+    if (buckets->active_count < end - begin) {
+        speed_min_tick = 0.0f;  // parked bees stand still
+    }
 
-        float min_y = radius + bounce_margin;
-        float max_y = world_h - radius - bounce_margin;
-        if (min_y > max_y) {
-            float mid = world_h * 0.5f;
-            min_y = max_y = mid;
-        }
-        if (new_y < min_y) {
-            new_y = min_y;
-            vy = -vy * 0.3f;
-            ++bounce_counter;
-        } else if (new_y > max_y) {
-            new_y = max_y;
-            vy = -vy * 0.3f;
-            ++bounce_counter;
+    for (size_t k = 0; k < buckets->active_count; ++k) {
+        size_t j = buckets->active[k];
+        size_t i = begin + j;
+        if (lanes->settled[j]) {
+            // Settled idle bees stand still: speed 0, nothing else to resolve.
+            speed_min_tick = 0.0f;
+            continue;
         }
-
-        if (!sim_tile_passable_world(state, new_x, new_y)) {
+        float x = state->x[i];
+        float y = state->y[i];
+        float vx = state->vx[i];
+        float vy = state->vy[i];
+        float new_x = lanes->new_x[j];
+        float new_y = lanes->new_y[j];
+        float energy = sim_bee_energy(state, i);
+        float load = sim_bee_load(state, i);
+        float prev_t_state = state->t_state[i];
+        float capacity = sim_bee_capacity(state, i);
+        float harvest_rate = sim_bee_harvest_rate(state, i);
+        uint8_t prev_mode = lanes->prev_mode[j];
+        uint8_t mode = lanes->mode[j];
+        int32_t target_id = lanes->target_id[j];
+        float target_x = lanes->target_x[j];
+        float target_y = lanes->target_y[j];
+        uint8_t path_valid = lanes->path_valid[j];
+        int32_t request_tile = -1;
+        float request_uL = 0.0f;
+
+        uint32_t bee_tile = sim_track_tile(state, state->tile_index[i], new_x, new_y);
+        if (!sim_tile_passable(state, bee_tile)) {
             new_x = x;
             new_y = y;
             vx = 0.0f;
             vy = 0.0f;
+            bee_tile = state->tile_index[i];
         }
 
         float speed_after = sqrtf(vx * vx + vy * vy);
-        bool inside_after = sim_point_inside_hive(state, new_x, new_y);
+        bool inside_after = sim_tile_inside_hive(state, bee_tile);
 
-        if (inside_after && !inside_hive_now && (mode == BEE_MODE_RETURNING || mode == BEE_MODE_ENTERING)) {
+        if (inside_after && !lanes->inside_before[j] && (mode == BEE_MODE_RETURNING || mode == BEE_MODE_ENTERING)) {
             mode = BEE_MODE_ENTERING;
             target_x = unload_x;
             target_y = unload_y;
         }
-        state->inside_hive_flag[i] = inside_after ? 1u : 0u;
 
-        flight_mode = (mode == BEE_MODE_OUTBOUND || mode == BEE_MODE_RETURNING || mode == BEE_MODE_ENTERING);
+        // A bee multi-rate skipped spent the skipped time held in prev_mode;
+        // only this tick belongs to a new mode.
+        float dt_sec = lanes->dt_sec[j];
+        float held_sec = 0.0f;
+        if (mode != prev_mode) {
+            held_sec = dt_sec - frame->dt_sec;
+            dt_sec = frame->dt_sec;
+        }
+
+        bool flight_mode = (mode == BEE_MODE_OUTBOUND || mode == BEE_MODE_RETURNING || mode == BEE_MODE_ENTERING);
         const float flight_cost = 0.0007f;
         const float forage_cost = 0.00025f;
         float rest_recovery = state->bee_rest_recovery_per_s > 0.0f ? state->bee_rest_recovery_per_s : 0.3f;
         if (flight_mode) {
             float load_factor = 1.0f + (capacity > 0.0f ? (load / capacity) * 0.25f : 0.0f);
-            energy -= flight_cost * speed_after * load_factor * dt_sec;
+            float effort = lanes->coarse[j] ? frame->lod_effort_scale : 1.0f;
+            energy -= flight_cost * speed_after * effort * load_factor * dt_sec;
         } else if (mode == BEE_MODE_FORAGING) {
             energy -= forage_cost * dt_sec;
         } else {
             energy += rest_recovery * dt_sec;
         }
+        if (held_sec > 0.0f) {
+            energy += prev_mode == BEE_MODE_FORAGING ? -forage_cost * held_sec : rest_recovery * held_sec;
+        }
 
         if (mode == BEE_MODE_FORAGING) {
-            HexTile *tile_mut = sim_get_tile(state, target_id);
-            if (tile_mut && tile_mut->nectar_stock > 0.0f) {
-                float patch_factor = 0.6f + 0.4f * tile_mut->flower_quality;
+            if (sim_tile_valid(state, target_id) && hex_world_tile_nectar_stock(state->hex_world, (size_t)target_id) > 0.0f) {
+                float patch_factor = 0.6f + 0.4f * state->hex_world->flower_quality[target_id];
                 float request = harvest_rate * patch_factor * dt_sec;
                 float space = capacity - load;
                 if (request > space) request = space;
-                if (request > 0.0f) {
-                    float harvested = hex_world_tile_harvest(state->hex_world, (size_t)target_id, request, NULL);
-                    if (harvested > space) {
-                        harvested = space;
-                    }
-                    if (harvested > 0.0f) {
-                        load += harvested;
-                    }
-                }
-                if (tile_mut->nectar_stock <= 0.5f) {
-                    target_id = -1;
-                    target_tile = NULL;
-                }
+                request_tile = target_id;
+                request_uL = request > 0.0f ? request : 0.0f;
             }
         } else if (mode == BEE_MODE_UNLOADING) {
             float unload_request = state->bee_unload_rate_uLps * dt_sec;
             if (unload_request > load) unload_request = load;
-            if (unload_request > 0.0f) {
-                float deposited = hex_world_hive_deposit_world(state->hex_world, new_x, new_y, unload_request);
-                if (deposited > unload_request) {
-                    deposited = unload_request;
-                }
-                if (deposited < 0.0f) {
-                    deposited = 0.0f;
-                }
-                load -= deposited;
+            if (unload_request > 0.0f && sim_hive_exists(state) && bee_tile != SIM_TILE_NONE &&
+                hex_world_tile_allows_deposit(state->hex_world, bee_tile)) {
+                request_tile = (int32_t)bee_tile;
+                request_uL = unload_request;
+            }
+        }
+
+        // The held time still harvests or deposits in prev_mode, on the tile
+        // the bee was held at. A bee has one request slot per tick; the
+        // decision rules never leave either mode for one that requests on
+        // another tile, so the two requests can always be added.
+        int32_t held_tile = -1;
+        float held_uL = 0.0f;
+        if (held_sec > 0.0f && prev_mode == BEE_MODE_FORAGING) {
+            int32_t held_target = state->target_id[i];
+            if (sim_tile_valid(state, held_target) &&
+                hex_world_tile_nectar_stock(state->hex_world, (size_t)held_target) > 0.0f) {
+                float patch_factor = 0.6f + 0.4f * state->hex_world->flower_quality[held_target];
+                float space = capacity - load - (request_tile == held_target ? request_uL : 0.0f);
+                held_uL = harvest_rate * patch_factor * held_sec;
+                if (held_uL > space) held_uL = space;
+                held_tile = held_target;
             }
+        } else if (held_sec > 0.0f && prev_mode == BEE_MODE_UNLOADING) {
+            uint32_t held_on = state->tile_index[i];
+            float remaining = load - (request_tile == (int32_t)held_on ? request_uL : 0.0f);
+            held_uL = state->bee_unload_rate_uLps * held_sec;
+            if (held_uL > remaining) held_uL = remaining;
+            if (sim_hive_exists(state) && held_on != SIM_TILE_NONE &&
+                hex_world_tile_allows_deposit(state->hex_world, held_on)) {
+                held_tile = (int32_t)held_on;
+            }
+        }
+        if (held_tile >= 0 && held_uL > 0.0f && (request_tile < 0 || request_tile == held_tile)) {
+            request_tile = held_tile;
+            request_uL += held_uL;
         }
 
         if (energy < 0.0f) energy = 0.0f;
@@ -1065,12 +2361,12 @@ void sim_tick(SimState *state, float dt_sec) {
 
         state->x[i] = new_x;
         state->y[i] = new_y;
+        state->tile_index[i] = bee_tile;
         state->vx[i] = vx;
         state->vy[i] = vy;
-        if (speed_after > 1e-5f) {
-            heading = wrap_angle(atan2f(vy, vx));
+        if (state->heading && speed_after > 1e-5f) {
+            state->heading[i] = wrap_angle(atan2f(vy, vx));
         }
-        state->heading[i] = heading;
 
         if (speed_after < speed_min_tick) {
             speed_min_tick = speed_after;
@@ -1080,41 +2376,425 @@ void sim_tick(SimState *state, float dt_sec) {
         }
         speed_sum += speed_after;
 
-        state->energy[i] = energy;
-        state->load_nectar[i] = load;
-        state->intent[i] = intent;
-        state->mode[i] = mode;
-        state->color_rgba[i] = bee_color_for(state->role[i], mode);
-        if (state->path_valid) {
-            state->path_valid[i] = path_valid;
+        sim_store_bee_state(state, i, energy, load, frame->tick_index, SIM_STORE_SITE_TICK);
+        state->request_tile[i] = request_tile;
+        state->request_uL[i] = request_uL;
+        uint8_t role = sim_bee_role(state, i);
+        uint16_t flags = (uint16_t)((role << SIM_BEE_ROLE_SHIFT) | (mode << SIM_BEE_MODE_SHIFT) |
+                                    (lanes->intent[j] << SIM_BEE_INTENT_SHIFT));
+        if (inside_after) {
+            flags |= SIM_BEE_INSIDE_HIVE;
+        }
+        if (path_valid) {
+            flags |= SIM_BEE_PATH_VALID;
+            if (lanes->path_has_waypoint[j]) {
+                flags |= SIM_BEE_PATH_WAYPOINT;
+            }
         }
-        if (state->path_has_waypoint) {
-            state->path_has_waypoint[i] = (path_valid ? path_has_waypoint : 0u);
+        state->bee_flags[i] = flags;
+        if (state->color_rgba) {
+            state->color_rgba[i] = bee_color_for(role, mode);
         }
         if (state->path_waypoint_x) {
-            state->path_waypoint_x[i] = path_valid ? path_waypoint_x : target_x;
+            state->path_waypoint_x[i] = path_valid ? lanes->path_waypoint_x[j] : target_x;
         }
         if (state->path_waypoint_y) {
-            state->path_waypoint_y[i] = path_valid ? path_waypoint_y : target_y;
+            state->path_waypoint_y[i] = path_valid ? lanes->path_waypoint_y[j] : target_y;
         }
         state->target_pos_x[i] = target_x;
         state->target_pos_y[i] = target_y;
         state->target_id[i] = target_id;
         state->t_state[i] = (mode == prev_mode) ? prev_t_state + dt_sec : 0.0f;
-        state->age_days[i] += dt_sec / 86400.0f;
+        state->age_days[i] += lanes->dt_sec[j] / 86400.0f;
         float conf = (float)state->topic_confidence[i];
-        conf -= dt_sec * 20.0f;
+        conf -= lanes->dt_sec[j] * 20.0f;
         if (conf < 0.0f) conf = 0.0f;
         if (conf > 255.0f) conf = 255.0f;
         state->topic_confidence[i] = (uint8_t)(conf + 0.5f);
+        if (state->scratch_xy) {
+            state->scratch_xy[2 * i + 0] = new_x;
+            state->scratch_xy[2 * i + 1] = new_y;
+        }
     }
 
-    state->rng_state = rng;
-    update_scratch(state);
+    stats->speed_sum = speed_sum;
+    stats->speed_min = speed_min_tick;
+    stats->speed_max = speed_max_tick;
+}
+
+// Lanes of a chunk with parked bees, packed down to the active ones so the
+// kernel runs over awake bees only.
+typedef struct SimChunkPacked {
+    float x[SIM_TICK_CHUNK_BEES];
+    float y[SIM_TICK_CHUNK_BEES];
+    float radius[SIM_TICK_CHUNK_BEES];
+    float desired_vx[SIM_TICK_CHUNK_BEES];
+    float desired_vy[SIM_TICK_CHUNK_BEES];
+    float damp[SIM_TICK_CHUNK_BEES];
+    float vx[SIM_TICK_CHUNK_BEES];
+    float vy[SIM_TICK_CHUNK_BEES];
+    float new_x[SIM_TICK_CHUNK_BEES];
+    float new_y[SIM_TICK_CHUNK_BEES];
+} SimChunkPacked;
+
+// Runs the kinematics kernel over the chunk's active lanes and returns the
+// wall bounces. A chunk without parked bees is integrated in place; otherwise
+// the active lanes are gathered, integrated and scattered back. The kernel is
+// per lane, so both give the same bits.
+static uint64_t sim_chunk_kinematics(const SimTickFrame *frame,
+                                     size_t begin,
+                                     size_t end,
+                                     const SimChunkBuckets *buckets,
+                                     SimChunkLanes *lanes) {
+    SimState *state = frame->state;
+    const float *radius = state->radius ? state->radius + begin : frame->uniform_radius;
+    SimKinematicsParams kinematics = {
+        .dt_sec = frame->dt_sec,
+        .max_delta_v = frame->seek_accel * frame->dt_sec,
+        .max_speed = frame->max_speed,
+        .world_w = frame->world_w,
+        .world_h = frame->world_h,
+        .bounce_margin = frame->bounce_margin,
+    };
+    if (buckets->active_count == end - begin) {
+        SimKinematicsLanes kinematic_lanes = {
+            .x = state->x + begin,
+            .y = state->y + begin,
+            .radius = radius,
+            .desired_vx = lanes->desired_vx,
+            .desired_vy = lanes->desired_vy,
+            .damp = lanes->damp,
+            .vx = state->vx + begin,
+            .vy = state->vy + begin,
+            .new_x = lanes->new_x,
+            .new_y = lanes->new_y,
+            .count = end - begin,
+        };
+        return sim_kinematics_run(state->kinematics_kernel, &kinematics, &kinematic_lanes);
+    }
+
+    SimChunkPacked packed;
+    size_t count = buckets->active_count;
+    for (size_t k = 0; k < count; ++k) {
+        size_t j = buckets->active[k];
+        packed.x[k] = state->x[begin + j];
+        packed.y[k] = state->y[begin + j];
+        packed.radius[k] = radius[j];
+        packed.desired_vx[k] = lanes->desired_vx[j];
+        packed.desired_vy[k] = lanes->desired_vy[j];
+        packed.damp[k] = lanes->damp[j];
+        packed.vx[k] = state->vx[begin + j];
+        packed.vy[k] = state->vy[begin + j];
+    }
+    SimKinematicsLanes kinematic_lanes = {
+        .x = packed.x,
+        .y = packed.y,
+        .radius = packed.radius,
+        .desired_vx = packed.desired_vx,
+        .desired_vy = packed.desired_vy,
+        .damp = packed.damp,
+        .vx = packed.vx,
+        .vy = packed.vy,
+        .new_x = packed.new_x,
+        .new_y = packed.new_y,
+        .count = count,
+    };
+    uint64_t bounces = count > 0 ? sim_kinematics_run(state->kinematics_kernel, &kinematics, &kinematic_lanes) : 0u;
+    for (size_t k = 0; k < count; ++k) {
+        size_t j = buckets->active[k];
+        state->vx[begin + j] = packed.vx[k];
+        state->vy[begin + j] = packed.vy[k];
+        lanes->new_x[j] = packed.new_x[k];
+        lanes->new_y[j] = packed.new_y[k];
+    }
+    return bounces;
+}
+
+// Advances bees [chunk_index * SIM_TICK_CHUNK_BEES, ...) by one tick. Reads the
+// shared world but never writes it: harvests and deposits are recorded in the
+// per-bee request columns and applied by sim_commit_world_requests.
+static void sim_tick_chunk(void *user_data, size_t chunk_index) {
+    const SimTickFrame *frame = (const SimTickFrame *)user_data;
+    SimState *state = frame->state;
+
+    size_t begin = chunk_index * SIM_TICK_CHUNK_BEES;
+    size_t end = begin + SIM_TICK_CHUNK_BEES;
+    if (end > state->count) {
+        end = state->count;
+    }
+
+    SimChunkStats *stats = &state->chunk_stats[chunk_index];
+    stats->park_request_count = 0;
+    if (stats->parked_count == end - begin) {
+        stats->speed_sum = 0.0;
+        stats->speed_min = 0.0f;
+        stats->speed_max = 0.0f;
+        stats->bounce_count = 0;
+        return;
+    }
+
+    SimChunkLanes lanes;
+    SimChunkBuckets buckets;
+    sim_chunk_bucket(frame, begin, end, stats, &buckets, &lanes);
+    sim_chunk_idle(frame, begin, &buckets, &lanes, stats);
+    sim_chunk_foraging(frame, begin, &buckets, &lanes);
+    sim_chunk_unloading(frame, begin, &buckets, &lanes);
+    sim_chunk_steer(frame, begin, buckets.generic, buckets.generic_count, &lanes);
+
+    stats->bounce_count = sim_chunk_kinematics(frame, begin, end, &buckets, &lanes);
+    sim_chunk_resolve(frame, begin, end, &buckets, &lanes, stats);
+}
+
+// Buckets this tick's per-bee requests by tile with a counting sort over the
+// touched tiles only. Harvest tiles come first, then hive storage tiles; within
+// a tile requests stay in bee order, so the resolve pass is deterministic.
+// Returns the total request count and stores the harvest prefix length.
+static size_t sim_gather_requests(SimState *state, size_t *out_harvest_count) {
+    *out_harvest_count = 0;
+    HexWorld *world = state->hex_world;
+    uint32_t *tile_count = state->tile_request_count;
+    if (!world || !tile_count || state->tile_request_capacity < world->tile_count) {
+        return 0;
+    }
+
+    size_t touched = 0;
+    for (size_t i = 0; i < state->count; ++i) {
+        int32_t tile = state->request_tile[i];
+        if (tile < 0) {
+            continue;
+        }
+        if (tile_count[tile]++ == 0u) {
+            state->touched_tiles[touched++] = (uint32_t)tile;
+        }
+    }
+    if (touched == 0) {
+        return 0;
+    }
+
+    // Turn counts into start offsets, harvest tiles before deposit tiles.
+    uint32_t offset = 0;
+    for (int pass = 0; pass < 2; ++pass) {
+        bool want_deposit = (pass == 1);
+        for (size_t t = 0; t < touched; ++t) {
+            uint32_t tile = state->touched_tiles[t];
+            if (hex_world_tile_allows_deposit(world, tile) != want_deposit) {
+                continue;
+            }
+            uint32_t n = tile_count[tile];
+            tile_count[tile] = offset;
+            offset += n;
+        }
+        if (pass == 0) {
+            *out_harvest_count = offset;
+        }
+    }
+
+    for (size_t i = 0; i < state->count; ++i) {
+        int32_t tile = state->request_tile[i];
+        if (tile < 0) {
+            continue;
+        }
+        uint32_t k = tile_count[tile]++;
+        state->request_bee[k] = (uint32_t)i;
+        state->requests[k].tile_index = (uint32_t)tile;
+        state->requests[k].amount_uL = state->request_uL[i];
+    }
+
+    for (size_t t = 0; t < touched; ++t) {
+        tile_count[state->touched_tiles[t]] = 0u;
+    }
+    return offset;
+}
+
+// Second phase of the tick: resolves the gathered requests against the hex
+// world (one stock update per tile) and applies the granted amounts to bees.
+static void sim_commit_world_requests(SimState *state) {
+    size_t harvest_count = 0;
+    size_t total = sim_gather_requests(state, &harvest_count);
+    if (total == 0) {
+        return;
+    }
+    hex_world_tile_harvest_resolve(state->hex_world, state->requests, harvest_count, state->request_granted_uL);
+    for (size_t k = 0; k < harvest_count; ++k) {
+        sim_floral_index_touch(&state->floral_tree, state->requests[k].tile_index);
+    }
+    hex_world_hive_deposit_resolve(state->hex_world,
+                                   state->requests + harvest_count,
+                                   total - harvest_count,
+                                   state->request_granted_uL + harvest_count);
+
+    for (size_t k = 0; k < total; ++k) {
+        size_t i = state->request_bee[k];
+        float capacity = sim_bee_capacity(state, i);
+        float load = sim_bee_load(state, i);
+        float granted = state->request_granted_uL[k];
+        if (k < harvest_count) {
+            float space = capacity - load;
+            if (granted > space) {
+                granted = space;
+            }
+            if (granted > 0.0f) {
+                load += granted;
+            }
+            if (hex_world_tile_nectar_stock(state->hex_world, state->requests[k].tile_index) <= 0.5f) {
+                state->target_id[i] = -1;
+            }
+        } else {
+            float requested = state->requests[k].amount_uL;
+            if (granted > requested) {
+                granted = requested;
+            }
+            if (granted < 0.0f) {
+                granted = 0.0f;
+            }
+            load -= granted;
+        }
+        if (load < 0.0f) load = 0.0f;
+        if (load > capacity) load = capacity;
+        sim_store_bee_state(state, i, NAN, load, state->tick_index, SIM_STORE_SITE_COMMIT);
+    }
+}
+
+void sim_tick(SimState *state, float dt_sec) {
+    if (!state || state->count == 0) {
+        return;
+    }
+    if (dt_sec <= 0.0f) {
+        update_scratch(state);
+        return;
+    }
+
+    if (state->free_count > 0 && state->tick_index % SIM_COMPACT_INTERVAL_TICKS == 0) {
+        sim_compact_slots(state);
+    }
+    state->floral_clock_sec += dt_sec;
+    sim_tiles_recharge(state, dt_sec);
+    if (state->hex_world) {
+        sim_floral_index_refresh(&state->floral_tree, state->hex_world);
+    }
+    // Stamps count ticks of stamp_dt_sec in 32 bits. Parked bees are settled
+    // before a step of another length and before the oldest possible stamp
+    // could wrap; lagging bees, at most a sub-rate behind, catch up instead.
+    bool catch_up = dt_sec != state->stamp_dt_sec;
+    if (catch_up || (state->tick_index & SIM_STAMP_REBASE_MASK) == 0u) {
+        sim_wake_all(state);
+    }
+    timer_wheel_advance(state->wake_wheel, state->tick_index, sim_wake_fired, state);
+
+    SimTickFrame frame = {
+        .state = state,
+        .dt_sec = dt_sec,
+        .stamp_dt_sec = state->stamp_dt_sec,
+        .catch_up = catch_up,
+        .rng_key = sim_rng_key(state->seed),
+        .tick_index = state->tick_index,
+        .sim_time_after = state->sim_time_sec + (double)dt_sec,
+        .world_w = state->world_w,
+        .world_h = state->world_h,
+        .bounce_margin = state->bounce_margin,
+    };
+    frame.base_speed = state->bee_speed_mps > 0.0f ? state->bee_speed_mps : state->max_speed;
+    frame.max_speed = frame.base_speed > 0.0f ? frame.base_speed : state->max_speed;
+    frame.seek_accel = state->bee_seek_accel > 0.0f ? state->bee_seek_accel : state->max_speed * 2.0f;
+    frame.arrive_tol = state->bee_arrive_tol_world > 0.0f ? state->bee_arrive_tol_world : state->default_radius * 2.0f;
+    if (!state->radius) {
+        for (size_t j = 0; j < SIM_TICK_CHUNK_BEES; ++j) {
+            frame.uniform_radius[j] = state->default_radius;
+        }
+    }
+
+    float entrance_x = frame.world_w * 0.5f;
+    float entrance_y = frame.world_h * 0.5f;
+    float unload_x = entrance_x;
+    float unload_y = entrance_y;
+    float hive_center_x = entrance_x;
+    float hive_center_y = entrance_y;
+    if (state->hex_world) {
+        if (hex_world_hive_center(state->hex_world, &hive_center_x, &hive_center_y)) {
+            entrance_x = hive_center_x;
+            entrance_y = hive_center_y;
+            unload_x = hive_center_x;
+            unload_y = hive_center_y;
+        }
+        if (!hex_world_hive_preferred_entrance(state->hex_world, &entrance_x, &entrance_y)) {
+            entrance_x = hive_center_x;
+            entrance_y = hive_center_y;
+        }
+        if (!hex_world_hive_preferred_unload(state->hex_world, &unload_x, &unload_y)) {
+            unload_x = hive_center_x;
+            unload_y = hive_center_y;
+        }
+    }
+    frame.entrance_x = entrance_x;
+    frame.entrance_y = entrance_y;
+    frame.unload_x = unload_x;
+    frame.unload_y = unload_y;
+    frame.hive_center_x = hive_center_x;
+    frame.hive_center_y = hive_center_y;
+    frame.any_patch_available = sim_any_floral_available(state);
+    if (state->detail_region) {
+        float margin = SIM_LOD_MARGIN_CELLS * (state->hex_world ? state->hex_world->cell_radius : state->default_radius * 2.0f);
+        frame.lod = true;
+        frame.lod_min_x = state->detail_min_x - margin;
+        frame.lod_min_y = state->detail_min_y - margin;
+        frame.lod_max_x = state->detail_max_x + margin;
+        frame.lod_max_y = state->detail_max_y + margin;
+        float hive_radius = 0.0f;
+        if (state->hex_world && hex_world_hive_bounds(state->hex_world, &frame.lod_hive_x, &frame.lod_hive_y, &hive_radius)) {
+            frame.lod_hive_radius = hive_radius + 2.0f * state->default_radius;
+            float out_x = entrance_x - frame.lod_hive_x;
+            float out_y = entrance_y - frame.lod_hive_y;
+            float out_len = sqrtf(out_x * out_x + out_y * out_y);
+            if (out_len > 1e-5f) {
+                frame.lod_entrance_dir_x = out_x / out_len;
+                frame.lod_entrance_dir_y = out_y / out_len;
+            }
+        }
+        frame.lod_speed_scale = sinf(SIM_FLIGHT_JITTER_RAD) / SIM_FLIGHT_JITTER_RAD;
+        frame.lod_effort_scale = 1.0f / frame.lod_speed_scale;
+    }
+
+    size_t chunk_count = (state->count + SIM_TICK_CHUNK_BEES - 1u) / SIM_TICK_CHUNK_BEES;
+    job_pool_run(state->job_pool, chunk_count, sim_tick_chunk, &frame);
+    sim_commit_world_requests(state);
+    for (size_t c = 0; c < chunk_count; ++c) {
+        const SimParkRequest *requests = &state->park_requests[c * SIM_TICK_CHUNK_BEES];
+        for (uint32_t k = 0; k < state->chunk_stats[c].park_request_count; ++k) {
+            uint32_t bee = requests[k].bee;
+            if (requests[k].due_tick != UINT64_MAX) {
+                timer_wheel_schedule(state->wake_wheel, bee, requests[k].due_tick);
+            } else if (state->caste_pools) {
+                sim_pool_absorb(state, bee, state->age_days[bee], frame.sim_time_after);
+            }
+        }
+    }
+    if (state->caste_pools) {
+        sim_pool_advance(state, frame.sim_time_after);
+    }
+    state->spatial_stale = true;
+    state->sim_time_sec = frame.sim_time_after;
+    state->stamp_dt_sec = dt_sec;
+    state->tick_index++;
+
+    double speed_sum = 0.0;
+    float speed_min_tick = FLT_MAX;
+    float speed_max_tick = 0.0f;
+    uint64_t bounce_counter = 0;
+    for (size_t c = 0; c < chunk_count; ++c) {
+        const SimChunkStats *stats = &state->chunk_stats[c];
+        speed_sum += stats->speed_sum;
+        if (stats->speed_min < speed_min_tick) {
+            speed_min_tick = stats->speed_min;
+        }
+        if (stats->speed_max > speed_max_tick) {
+            speed_max_tick = stats->speed_max;
+        }
+        bounce_counter += stats->bounce_count;
+    }
 
     state->log_accum_sec += dt_sec;
     state->log_bounce_count += bounce_counter;
-    state->log_sample_count += state->count;
+    state->log_sample_count += state->live_count;
     state->log_speed_sum += speed_sum;
     if (state->count > 0) {
         if (state->log_speed_min > speed_min_tick) {
@@ -1136,7 +2816,7 @@ void sim_tick(SimState *state, float dt_sec) {
         LOG_INFO("sim: n=%zu dt=%.5f speed=%.1f jitter=%.1fdeg/s avg=%.1f min=%.1f max=%.1f bounces=%llu",
                  state->count,
                  dt_sec,
-                 base_speed,
+                 frame.base_speed,
                  jitter_deg,
                  (float)avg_speed,
                  (float)min_speed_log,
@@ -1144,6 +2824,7 @@ void sim_tick(SimState *state, float dt_sec) {
                  (unsigned long long)state->log_bounce_count);
         reset_log_stats(state);
     }
+    sim_journal_note_tick(state->journal, state, dt_sec);
 }
 
 RenderView sim_build_view(SimState *state) {
@@ -1155,6 +2836,27 @@ RenderView sim_build_view(SimState *state) {
     view.positions_xy = state->scratch_xy;
     view.radii_px = state->radius;
     view.color_rgba = state->color_rgba;
+    if (!state->radius && state->count > 0) {
+        if (state->view_capacity < state->capacity) {
+            free_aligned(state->view_radius);
+            free_aligned(state->view_color_rgba);
+            state->view_radius = (float *)alloc_aligned(sizeof(float) * state->capacity);
+            state->view_color_rgba = (uint32_t *)alloc_aligned(sizeof(uint32_t) * state->capacity);
+            state->view_capacity = state->view_radius && state->view_color_rgba ? state->capacity : 0;
+            if (state->view_capacity == 0) {
+                LOG_ERROR("sim: failed to allocate view buffers for %zu bees", state->capacity);
+                view.count = 0;
+                return view;
+            }
+        }
+        for (size_t i = 0; i < state->count; ++i) {
+            bool dead = sim_bee_flag(state, i, SIM_BEE_DEAD);
+            state->view_radius[i] = dead ? 0.0f : state->default_radius;
+            state->view_color_rgba[i] = dead ? 0u : bee_color_for(sim_bee_role(state, i), sim_bee_mode(state, i));
+        }
+        view.radii_px = state->view_radius;
+        view.color_rgba = state->view_color_rgba;
+    }
 
     return view;
 }
@@ -1163,6 +2865,10 @@ void sim_apply_runtime_params(SimState *state, const Params *params) {
     if (!state || !params) {
         return;
     }
+    sim_journal_note_params(state->journal, state, SIM_JOURNAL_APPLY_PARAMS, params);
+    sim_wake_all(state);
+    // The speed clamp below would set dead slots moving.
+    sim_compact_slots(state);
 
     float min_speed = params->motion_min_speed;
     if (min_speed <= 0.0f) {
@@ -1195,6 +2901,7 @@ void sim_apply_runtime_params(SimState *state, const Params *params) {
         state->spawn_speed_std = 0.0f;
     }
     state->spawn_mode = params->motion_spawn_mode;
+    sim_set_worker_count(state, params->sim_worker_count);
 
     state->bee_capacity_uL = params->bee.capacity_uL;
     state->bee_harvest_rate_uLps = params->bee.harvest_rate_uLps;
@@ -1204,9 +2911,14 @@ void sim_apply_runtime_params(SimState *state, const Params *params) {
     state->bee_seek_accel = params->bee.seek_accel;
     state->bee_arrive_tol_world = params->bee.arrive_tol_world;
 
-    for (size_t i = 0; i < state->count; ++i) {
-        state->capacity_uL[i] = state->bee_capacity_uL;
-        state->harvest_rate_uLps[i] = state->bee_harvest_rate_uLps;
+    if (state->capacity_uL && state->harvest_rate_uLps) {
+        for (size_t i = 0; i < state->count; ++i) {
+            state->capacity_uL[i] = state->bee_capacity_uL;
+            state->harvest_rate_uLps[i] = state->bee_harvest_rate_uLps;
+        }
+    }
+    if (state->load_q) {
+        sim_requantize_loads(state);
     }
 
     const float world_w = state->world_w;
@@ -1216,7 +2928,12 @@ void sim_apply_runtime_params(SimState *state, const Params *params) {
         float vx = state->vx[i];
         float vy = state->vy[i];
         float speed_sq = vx * vx + vy * vy;
-        float heading = state->heading[i];
+        // Compact mode keeps no heading; a bee at rest sets off on a drawn one.
+        float heading = state->heading ? state->heading[i]
+                                       : sim_rng_uniform01(sim_rng_key(state->seed), (uint32_t)i, state->tick_index,
+                                                           SIM_RNG_SLOT(SIM_RNG_STREAM_SPAWN, 6)) *
+                                                 TWO_PI -
+                                             (float)M_PI;
         if (speed_sq > 0.0f) {
             float speed = sqrtf(speed_sq);
             if (speed > max_speed && max_speed > 0.0f) {
@@ -1241,9 +2958,11 @@ void sim_apply_runtime_params(SimState *state, const Params *params) {
 
         state->vx[i] = vx;
         state->vy[i] = vy;
-        state->heading[i] = heading;
+        if (state->heading) {
+            state->heading[i] = heading;
+        }
 
-        float radius = state->radius ? state->radius[i] : state->default_radius;
+        float radius = sim_bee_radius(state, i);
         float min_x = radius + state->bounce_margin;
         float max_x = world_w - radius - state->bounce_margin;
         if (min_x > max_x) {
@@ -1276,7 +2995,9 @@ void sim_apply_runtime_params(SimState *state, const Params *params) {
         state->y[i] = y;
     }
 
+    sim_refresh_tile_cache(state);
     update_scratch(state);
+    state->spatial_stale = true;
     reset_log_stats(state);
 }
 
@@ -1287,36 +3008,558 @@ void sim_reset(SimState *state, uint64_t seed) {
     if (seed == 0) {
         seed = state->seed ? state->seed : UINT64_C(0xBEE);
     }
+    sim_journal_note_value(state->journal, state, SIM_JOURNAL_RESET, seed);
     fill_bees(state, NULL, seed);
     LOG_INFO("sim: reset seed=0x%llx", (unsigned long long)seed);
 }
 
+void sim_set_journal(SimState *state, SimJournal *journal) {
+    if (state) {
+        state->journal = journal;
+    }
+}
+
 void sim_shutdown(SimState *state) {
     sim_release(state);
 }
 
+typedef struct SimSnapshotMeta {
+    uint64_t count;
+    uint64_t live_count;
+    uint64_t free_count;
+    uint64_t compaction_epoch;
+    uint64_t seed;
+    uint64_t tick_index;
+    uint64_t log_bounce_count;
+    uint64_t log_sample_count;
+    double log_accum_sec;
+    double log_speed_sum;
+    double log_speed_min;
+    double log_speed_max;
+    double sim_time_sec;
+    float world_w;
+    float world_h;
+    float default_radius;
+    float default_color[4];
+    float min_speed;
+    float max_speed;
+    float jitter_rad_per_sec;
+    float bounce_margin;
+    float spawn_speed_mean;
+    float spawn_speed_std;
+    float load_quantum_uL;
+    float floral_clock_sec;
+    float floral_day_period_sec;
+    float floral_night_scale;
+    float bee_capacity_uL;
+    float bee_harvest_rate_uLps;
+    float bee_unload_rate_uLps;
+    float bee_rest_recovery_per_s;
+    float bee_speed_mps;
+    float bee_seek_accel;
+    float bee_arrive_tol_world;
+    int32_t spawn_mode;
+    uint8_t compact;
+    uint8_t inspection;
+    uint8_t lazy_recharge;
+    uint8_t mode_buckets;
+    uint8_t hibernation;
+    uint8_t multi_rate;
+    uint8_t detail_region;
+    uint8_t pad0[1];
+    float detail_min_x;
+    float detail_min_y;
+    float detail_max_x;
+    float detail_max_y;
+    uint8_t caste_pools;
+    uint8_t pad1[3];
+    float stamp_dt_sec;
+    uint32_t pad2;
+    double pool_day_start_sec;
+    uint32_t caste_pool[SIM_POOL_ROLES][SIM_POOL_DAYS];
+} SimSnapshotMeta;
+
+// Written raw: every byte is a named field, so the designated initializer in
+// sim_snapshot_write_state leaves nothing unspecified on disk.
+_Static_assert(sizeof(SimSnapshotMeta) == 464u, "checkpoint meta layout is part of the file format");
+
+static void sim_snapshot_column_name(char out[SNAPSHOT_NAME_MAX], const char *column) {
+    snprintf(out, SNAPSHOT_NAME_MAX, "bee.%s", column);
+}
+
+bool sim_snapshot_write_state(const SimState *state, SnapshotWriter *writer) {
+    SimSnapshotMeta meta = {
+        .count = state->count,
+        .live_count = state->live_count,
+        .free_count = state->free_count,
+        .compaction_epoch = state->compaction_epoch,
+        .seed = state->seed,
+        .tick_index = state->tick_index,
+        .log_bounce_count = state->log_bounce_count,
+        .log_sample_count = state->log_sample_count,
+        .log_accum_sec = state->log_accum_sec,
+        .log_speed_sum = state->log_speed_sum,
+        .log_speed_min = state->log_speed_min,
+        .log_speed_max = state->log_speed_max,
+        .sim_time_sec = state->sim_time_sec,
+        .world_w = state->world_w,
+        .world_h = state->world_h,
+        .default_radius = state->default_radius,
+        .min_speed = state->min_speed,
+        .max_speed = state->max_speed,
+        .jitter_rad_per_sec = state->jitter_rad_per_sec,
+        .bounce_margin = state->bounce_margin,
+        .spawn_speed_mean = state->spawn_speed_mean,
+        .spawn_speed_std = state->spawn_speed_std,
+        .load_quantum_uL = state->load_quantum_uL,
+        .floral_clock_sec = state->floral_clock_sec,
+        .floral_day_period_sec = state->floral_day_period_sec,
+        .floral_night_scale = state->floral_night_scale,
+        .bee_capacity_uL = state->bee_capacity_uL,
+        .bee_harvest_rate_uLps = state->bee_harvest_rate_uLps,
+        .bee_unload_rate_uLps = state->bee_unload_rate_uLps,
+        .bee_rest_recovery_per_s = state->bee_rest_recovery_per_s,
+        .bee_speed_mps = state->bee_speed_mps,
+        .bee_seek_accel = state->bee_seek_accel,
+        .bee_arrive_tol_world = state->bee_arrive_tol_world,
+        .spawn_mode = state->spawn_mode,
+        .compact = state->compact,
+        .inspection = state->inspection,
+        .lazy_recharge = state->lazy_recharge,
+        .mode_buckets = state->mode_buckets,
+        .hibernation = state->hibernation,
+        .multi_rate = state->multi_rate,
+        .detail_region = state->detail_region,
+        .detail_min_x = state->detail_min_x,
+        .detail_min_y = state->detail_min_y,
+        .detail_max_x = state->detail_max_x,
+        .detail_max_y = state->detail_max_y,
+        .caste_pools = state->caste_pools,
+        .stamp_dt_sec = state->stamp_dt_sec,
+        .pool_day_start_sec = state->pool_day_start_sec,
+    };
+    memcpy(meta.default_color, state->default_color, sizeof(meta.default_color));
+    memcpy(meta.caste_pool, state->caste_pool, sizeof(meta.caste_pool));
+
+    // The wake wheel is not written; each parked bee's due tick is, and the
+    // loader re-arms it.
+    uint64_t *wake_due = (uint64_t *)malloc(sizeof(uint64_t) * state->count);
+    if (!wake_due) {
+        LOG_ERROR("sim_snapshot_save: failed to allocate %zu wake ticks", state->count);
+        return false;
+    }
+    for (size_t i = 0; i < state->count; ++i) {
+        wake_due[i] = timer_wheel_due(state->wake_wheel, (uint32_t)i);
+    }
+
+    snapshot_write(writer, "sim.meta", &meta, sizeof(meta), 1);
+    SimBeeColumn columns[SIM_BEE_COLUMN_MAX];
+    size_t column_count = sim_bee_columns((SimState *)state, columns);
+    for (size_t c = 0; c < column_count; ++c) {
+        if (columns[c].scratch || !*columns[c].data) {
+            continue;
+        }
+        char name[SNAPSHOT_NAME_MAX];
+        sim_snapshot_column_name(name, columns[c].name);
+        snapshot_write(writer, name, *columns[c].data, columns[c].elem_size, state->count);
+    }
+    snapshot_write(writer, "sim.free_slots", state->free_slots, sizeof(uint32_t), state->free_count);
+    bool ok = snapshot_write(writer, "sim.wake_due", wake_due, sizeof(uint64_t), state->count);
+    free(wake_due);
+    return hex_world_snapshot_write(state->hex_world, writer) && ok;
+}
+
+bool sim_snapshot_save(const SimState *state, const char *path) {
+    if (!state || !path || !state->hex_world) {
+        LOG_ERROR("sim_snapshot_save: invalid arguments or no hex world bound");
+        return false;
+    }
+    SnapshotWriter *writer = NULL;
+    if (!snapshot_writer_open(&writer, path, SIM_SNAPSHOT_VERSION)) {
+        return false;
+    }
+    if (!sim_snapshot_write_state(state, writer)) {
+        snapshot_writer_finish(writer);
+        return false;
+    }
+    if (!snapshot_writer_finish(writer)) {
+        return false;
+    }
+    LOG_INFO("sim: wrote checkpoint '%s' count=%zu tick=%llu",
+             path,
+             state->count,
+             (unsigned long long)state->tick_index);
+    return true;
+}
+
+static void sim_snapshot_restore_scalars(SimState *state, const SimSnapshotMeta *meta) {
+    state->count = (size_t)meta->count;
+    state->capacity = (size_t)meta->count;
+    state->live_count = (size_t)meta->live_count;
+    state->free_count = (size_t)meta->free_count;
+    state->compaction_epoch = meta->compaction_epoch;
+    state->seed = meta->seed;
+    state->tick_index = meta->tick_index;
+    state->log_bounce_count = meta->log_bounce_count;
+    state->log_sample_count = meta->log_sample_count;
+    state->log_accum_sec = meta->log_accum_sec;
+    state->log_speed_sum = meta->log_speed_sum;
+    state->log_speed_min = meta->log_speed_min;
+    state->log_speed_max = meta->log_speed_max;
+    state->sim_time_sec = meta->sim_time_sec;
+    state->stamp_dt_sec = meta->stamp_dt_sec;
+    state->world_w = meta->world_w;
+    state->world_h = meta->world_h;
+    state->default_radius = meta->default_radius;
+    memcpy(state->default_color, meta->default_color, sizeof(state->default_color));
+    state->min_speed = meta->min_speed;
+    state->max_speed = meta->max_speed;
+    state->jitter_rad_per_sec = meta->jitter_rad_per_sec;
+    state->bounce_margin = meta->bounce_margin;
+    state->spawn_speed_mean = meta->spawn_speed_mean;
+    state->spawn_speed_std = meta->spawn_speed_std;
+    state->spawn_mode = meta->spawn_mode;
+    state->load_quantum_uL = meta->load_quantum_uL;
+    state->floral_clock_sec = meta->floral_clock_sec;
+    state->floral_day_period_sec = meta->floral_day_period_sec;
+    state->floral_night_scale = meta->floral_night_scale;
+    state->bee_capacity_uL = meta->bee_capacity_uL;
+    state->bee_harvest_rate_uLps = meta->bee_harvest_rate_uLps;
+    state->bee_unload_rate_uLps = meta->bee_unload_rate_uLps;
+    state->bee_rest_recovery_per_s = meta->bee_rest_recovery_per_s;
+    state->bee_speed_mps = meta->bee_speed_mps;
+    state->bee_seek_accel = meta->bee_seek_accel;
+    state->bee_arrive_tol_world = meta->bee_arrive_tol_world;
+    state->compact = meta->compact != 0;
+    state->inspection = meta->inspection != 0;
+    state->lazy_recharge = meta->lazy_recharge != 0;
+    state->mode_buckets = meta->mode_buckets != 0;
+    state->hibernation = meta->hibernation != 0;
+    state->multi_rate = meta->multi_rate != 0;
+    state->detail_region = meta->detail_region != 0;
+    state->detail_min_x = meta->detail_min_x;
+    state->detail_min_y = meta->detail_min_y;
+    state->detail_max_x = meta->detail_max_x;
+    state->detail_max_y = meta->detail_max_y;
+    state->caste_pools = meta->caste_pools != 0;
+    state->pool_day_start_sec = meta->pool_day_start_sec;
+    memcpy(state->caste_pool, meta->caste_pool, sizeof(state->caste_pool));
+    state->pooled_count = 0;
+    for (size_t role = 0; role < SIM_POOL_ROLES; ++role) {
+        for (size_t day = 0; day < SIM_POOL_DAYS; ++day) {
+            state->pooled_count += state->caste_pool[role][day];
+        }
+    }
+}
+
+// Points every persistent column at its data in the mapping and allocates
+// the scratch ones. Returns false if a column the layout needs is missing.
+static bool sim_snapshot_bind_columns(SimState *state, const SnapshotReader *reader) {
+    size_t count = state->count;
+    SimBeeColumn columns[SIM_BEE_COLUMN_MAX];
+    size_t column_count = sim_bee_columns(state, columns);
+    for (size_t c = 0; c < column_count; ++c) {
+        if (columns[c].scratch) {
+            *columns[c].data = alloc_aligned(columns[c].elem_size * count);
+            if (!*columns[c].data) {
+                LOG_ERROR("sim_snapshot_load: allocation failure for bee buffers");
+                return false;
+            }
+            continue;
+        }
+        char name[SNAPSHOT_NAME_MAX];
+        sim_snapshot_column_name(name, columns[c].name);
+        size_t found = 0;
+        void *data = snapshot_column(reader, name, columns[c].elem_size, &found);
+        if (data && found != count) {
+            LOG_ERROR("sim_snapshot_load: column '%s' has %zu bees, expected %zu", name, found, count);
+            return false;
+        }
+        *columns[c].data = data;
+    }
+    bool layout_ok = state->compact ? (state->energy_q && state->load_q)
+                                    : (state->energy && state->load_nectar && state->capacity_uL &&
+                                       state->harvest_rate_uLps && state->heading && state->radius &&
+                                       state->color_rgba);
+    if (state->inspection) {
+        layout_ok = layout_ok && state->path_waypoint_x && state->path_waypoint_y;
+    }
+    static const char *const optional[] = {
+        "energy", "load_nectar", "energy_q", "load_q", "capacity_uL", "harvest_rate_uLps", "path_waypoint_x", "path_waypoint_y",
+        "heading", "radius", "color_rgba",
+    };
+    for (size_t c = 0; c < column_count && layout_ok; ++c) {
+        bool required = true;
+        for (size_t o = 0; o < sizeof optional / sizeof optional[0]; ++o) {
+            required = required && strcmp(columns[c].name, optional[o]) != 0;
+        }
+        layout_ok = *columns[c].data || !required;
+    }
+    if (!layout_ok) {
+        LOG_ERROR("sim_snapshot_load: checkpoint is missing bee columns");
+    }
+    return layout_ok;
+}
+
+// Re-arms the hibernation timers and the per-chunk parked counts.
+static bool sim_snapshot_restore_parking(SimState *state, const SnapshotReader *reader) {
+    size_t found = 0;
+    const uint64_t *wake_due = (const uint64_t *)snapshot_column(reader, "sim.wake_due", sizeof(uint64_t), &found);
+    if (!wake_due || found != state->count) {
+        LOG_ERROR("sim_snapshot_load: checkpoint is missing the wake ticks");
+        return false;
+    }
+    // The tick advances the wheel to tick_index before it runs, so the wheel
+    // a checkpoint was taken from stands one tick behind.
+    uint64_t now = state->tick_index > 0 ? state->tick_index - 1u : 0u;
+    if (!timer_wheel_create(&state->wake_wheel, state->capacity, now)) {
+        LOG_ERROR("sim_snapshot_load: failed to allocate the wake wheel");
+        return false;
+    }
+    for (size_t i = 0; i < state->count; ++i) {
+        if (state->parked[i]) {
+            sim_set_parked(state, i, true);
+            if (wake_due[i] != UINT64_MAX) {
+                timer_wheel_schedule(state->wake_wheel, (uint32_t)i, wake_due[i]);
+            }
+        }
+    }
+    return true;
+}
+
+bool sim_snapshot_restore(SimState **out_state,
+                          HexWorld *out_world,
+                          size_t worker_count,
+                          SnapshotReader *reader,
+                          const char *path) {
+    SimSnapshotMeta meta;
+    if (!snapshot_read(reader, "sim.meta", &meta, sizeof(meta), 1) || meta.count == 0 ||
+        meta.count >= UINT32_MAX || meta.live_count + meta.free_count != meta.count) {
+        LOG_ERROR("sim_snapshot_load: '%s' has no valid simulation state", path);
+        snapshot_reader_close(reader);
+        return false;
+    }
+    HexWorld world;
+    memset(&world, 0, sizeof(world));
+    if (!hex_world_snapshot_read(&world, reader)) {
+        snapshot_reader_close(reader);
+        return false;
+    }
+    SimState *state = (SimState *)calloc(1, sizeof(SimState));
+    if (!state) {
+        LOG_ERROR("sim_snapshot_load: failed to allocate SimState");
+        hex_world_shutdown(&world);
+        snapshot_reader_close(reader);
+        return false;
+    }
+    state->snapshot = reader;
+    sim_snapshot_restore_scalars(state, &meta);
+
+    size_t count = state->capacity;
+    state->chunk_capacity = (count + SIM_TICK_CHUNK_BEES - 1u) / SIM_TICK_CHUNK_BEES;
+    state->chunk_stats = (SimChunkStats *)alloc_aligned(sizeof(SimChunkStats) * state->chunk_capacity);
+    bool ok = state->chunk_stats && sim_snapshot_bind_columns(state, reader) &&
+              snapshot_read(reader, "sim.free_slots", state->free_slots, sizeof(uint32_t), state->free_count) &&
+              sim_snapshot_restore_parking(state, reader) &&
+              sim_spatial_init(&state->spatial, state->world_w, state->world_h, sim_spatial_cell_size(state, count), count) &&
+              sim_reserve_workers(state, worker_count);
+    if (!ok) {
+        LOG_ERROR("sim_snapshot_load: failed to restore '%s'", path);
+        sim_release(state);
+        hex_world_shutdown(&world);
+        return false;
+    }
+    // The last compaction's remap is not kept: indices from before the load
+    // belong to another state.
+    for (size_t i = 0; i < count; ++i) {
+        state->compaction_remap[i] = UINT32_MAX;
+    }
+    state->kinematics_kernel = sim_kinematics_resolve(SIM_KINEMATICS_AUTO);
+
+    // The flower system comes back with its own lazy clock, so the world is
+    // bound without sim_bind_hex_world (which would wake every parked bee).
+    *out_world = world;
+    state->hex_world = out_world;
+    sim_rebuild_floral_index(state);
+    sim_reserve_tile_buckets(state, out_world->tile_count);
+    update_scratch(state);
+    state->spatial_stale = true;
+
+    *out_state = state;
+    LOG_INFO("sim: restored '%s' count=%zu live=%zu tick=%llu workers=%zu",
+             path,
+             state->count,
+             state->live_count,
+             (unsigned long long)state->tick_index,
+             state->worker_count);
+    return true;
+}
+
+bool sim_snapshot_load(SimState **out_state, HexWorld *out_world, const Params *params, const char *path) {
+    if (!out_state || *out_state || !out_world || !params || !path) {
+        LOG_ERROR("sim_snapshot_load: invalid arguments");
+        return false;
+    }
+    SnapshotReader *reader = NULL;
+    if (!snapshot_reader_open(&reader, path, SIM_SNAPSHOT_VERSION)) {
+        return false;
+    }
+    return sim_snapshot_restore(out_state, out_world, params->sim_worker_count, reader, path);
+}
+
+static uint64_t sim_hash_bytes(uint64_t hash, const void *data, size_t bytes) {
+    const uint8_t *p = (const uint8_t *)data;
+    for (size_t i = 0; i < bytes; ++i) {
+        hash ^= p[i];
+        hash *= UINT64_C(0x100000001B3);
+    }
+    return hash;
+}
+
+uint64_t sim_state_hash(const SimState *state) {
+    uint64_t hash = UINT64_C(0xCBF29CE484222325);
+    if (!state) {
+        return hash;
+    }
+    size_t n = state->count;
+    hash = sim_hash_bytes(hash, &n, sizeof n);
+    hash = sim_hash_bytes(hash, &state->tick_index, sizeof state->tick_index);
+    hash = sim_hash_bytes(hash, state->x, sizeof(float) * n);
+    hash = sim_hash_bytes(hash, state->y, sizeof(float) * n);
+    hash = sim_hash_bytes(hash, state->vx, sizeof(float) * n);
+    hash = sim_hash_bytes(hash, state->vy, sizeof(float) * n);
+    if (state->heading) {
+        hash = sim_hash_bytes(hash, state->heading, sizeof(float) * n);
+    }
+    if (sim_parked_count(state) == 0 && !state->compact) {
+        hash = sim_hash_bytes(hash, state->t_state, sizeof(float) * n);
+        hash = sim_hash_bytes(hash, state->energy, sizeof(float) * n);
+    } else {
+        // Parked bees are hashed with their closed-form values, as if woken;
+        // compact energies with their decoded values.
+        for (int column = 0; column < 2; ++column) {
+            for (size_t i = 0; i < n; ++i) {
+                float value = column == 0 ? state->t_state[i] : sim_bee_energy(state, i);
+                if (state->parked[i]) {
+                    float energy = 0.0f;
+                    float t_state = 0.0f;
+                    float age_days = 0.0f;
+                    sim_parked_values(state, i, &energy, &t_state, &age_days);
+                    value = column == 0 ? t_state : energy;
+                }
+                hash = sim_hash_bytes(hash, &value, sizeof value);
+            }
+        }
+    }
+    if (state->compact) {
+        for (size_t i = 0; i < n; ++i) {
+            float load = sim_bee_load(state, i);
+            hash = sim_hash_bytes(hash, &load, sizeof load);
+        }
+    } else {
+        hash = sim_hash_bytes(hash, state->load_nectar, sizeof(float) * n);
+    }
+    hash = sim_hash_bytes(hash, state->target_pos_x, sizeof(float) * n);
+    hash = sim_hash_bytes(hash, state->target_pos_y, sizeof(float) * n);
+    hash = sim_hash_bytes(hash, state->target_id, sizeof(int32_t) * n);
+    // Byte per bee, as when mode and intent had columns of their own.
+    for (int field = 0; field < 2; ++field) {
+        unsigned shift = field == 0 ? SIM_BEE_MODE_SHIFT : SIM_BEE_INTENT_SHIFT;
+        for (size_t i = 0; i < n; ++i) {
+            uint8_t value = sim_bee_field(state, i, shift);
+            hash = sim_hash_bytes(hash, &value, sizeof value);
+        }
+    }
+    if (state->caste_pools) {
+        hash = sim_hash_bytes(hash, &state->pool_day_start_sec, sizeof state->pool_day_start_sec);
+        hash = sim_hash_bytes(hash, state->caste_pool, sizeof state->caste_pool);
+    }
+    if (state->hex_world) {
+        float honey = hex_world_hive_total_honey(state->hex_world);
+        hash = sim_hash_bytes(hash, &honey, sizeof honey);
+        // Current stock, so a world that drifts on its own is caught too.
+        size_t tile_count = hex_world_tile_count(state->hex_world);
+        for (size_t t = 0; t < tile_count; ++t) {
+            float stock = hex_world_tile_nectar_stock(state->hex_world, t);
+            hash = sim_hash_bytes(hash, &stock, sizeof stock);
+        }
+    }
+    return hash;
+}
+
+// Brings the grid up to date with the bee positions. The queries are the only
+// readers, so the tick leaves the rebuild to the first query after it; the
+// cached grid is the one piece of state a const query may write.
+static const SimSpatialGrid *sim_spatial_current(const SimState *state) {
+    if (state->spatial_stale) {
+        SimState *cache = (SimState *)state;
+        sim_spatial_build(&cache->spatial, state->x, state->y, state->count);
+        cache->spatial_stale = false;
+    }
+    return &state->spatial;
+}
+
 size_t sim_find_bee_near(const SimState *state, float world_x, float world_y, float radius_world) {
     if (!state || state->count == 0 || radius_world <= 0.0f) {
         return SIZE_MAX;
     }
-    float best_dist_sq = radius_world * radius_world;
-    size_t best_index = SIZE_MAX;
-    for (size_t i = 0; i < state->count; ++i) {
-        float dx = state->x[i] - world_x;
-        float dy = state->y[i] - world_y;
-        float combined = radius_world + state->radius[i];
-        float limit_sq = combined * combined;
-        float dist_sq = dx * dx + dy * dy;
-        if (dist_sq <= limit_sq && dist_sq <= best_dist_sq) {
-            best_dist_sq = dist_sq;
-            best_index = i;
-        }
+    size_t index = SIZE_MAX;
+    float dist_sq = 0.0f;
+    if (sim_spatial_query_nearest(sim_spatial_current(state), world_x, world_y, radius_world, 1, &index, &dist_sq) == 0) {
+        return SIZE_MAX;
     }
-    return best_index;
+    return index;
+}
+
+size_t sim_pick_bee(SimState *state, float world_x, float world_y, float radius_world) {
+    size_t index = sim_find_bee_near(state, world_x, world_y, radius_world);
+    if (index != SIZE_MAX || !state || state->pooled_count == 0 ||
+        !sim_tile_inside_hive(state, sim_locate_tile(state, world_x, world_y))) {
+        return index;
+    }
+    return sim_unpool_bee(state);
+}
+
+size_t sim_query_radius(const SimState *state,
+                        float world_x,
+                        float world_y,
+                        float radius_world,
+                        size_t *out_indices,
+                        size_t max_out) {
+    if (!state) {
+        return 0;
+    }
+    return sim_spatial_query_radius(sim_spatial_current(state), world_x, world_y, radius_world, out_indices, max_out);
+}
+
+size_t sim_query_rect(const SimState *state,
+                      float min_x,
+                      float min_y,
+                      float max_x,
+                      float max_y,
+                      size_t *out_indices,
+                      size_t max_out) {
+    if (!state) {
+        return 0;
+    }
+    return sim_spatial_query_rect(sim_spatial_current(state), min_x, min_y, max_x, max_y, out_indices, max_out);
+}
+
+size_t sim_query_nearest(const SimState *state,
+                         float world_x,
+                         float world_y,
+                         float max_radius_world,
+                         size_t k,
+                         size_t *out_indices,
+                         float *out_dist_sq) {
+    if (!state) {
+        return 0;
+    }
+    return sim_spatial_query_nearest(sim_spatial_current(state), world_x, world_y, max_radius_world, k, out_indices, out_dist_sq);
 }
 
 bool sim_get_bee_info(const SimState *state, size_t index, BeeDebugInfo *out_info) {
-    if (!state || !out_info || index >= state->count) {
+    if (!state || !out_info || index >= state->count || sim_bee_flag(state, index, SIM_BEE_DEAD)) {
         return false;
     }
     BeeDebugInfo info = {0};
@@ -1326,27 +3569,29 @@ bool sim_get_bee_info(const SimState *state, size_t index, BeeDebugInfo *out_inf
     info.vel_x = state->vx[index];
     info.vel_y = state->vy[index];
     info.speed = sqrtf(state->vx[index] * state->vx[index] + state->vy[index] * state->vy[index]);
-    info.radius = state->radius[index];
+    info.radius = sim_bee_radius(state, index);
     info.age_days = state->age_days[index];
     info.state_time = state->t_state[index];
-    info.energy = state->energy[index];
-    info.load_nectar = state->load_nectar[index];
-    info.capacity_uL = state->capacity_uL[index];
-    info.harvest_rate_uLps = state->harvest_rate_uLps[index];
+    info.energy = sim_bee_energy(state, index);
+    if (state->parked[index]) {
+        sim_parked_values(state, index, &info.energy, &info.state_time, &info.age_days);
+    }
+    info.load_nectar = sim_bee_load(state, index);
+    info.capacity_uL = sim_bee_capacity(state, index);
+    info.harvest_rate_uLps = sim_bee_harvest_rate(state, index);
     info.target_pos_x = state->target_pos_x[index];
     info.target_pos_y = state->target_pos_y[index];
     info.target_id = state->target_id[index];
     info.topic_id = state->topic_id[index];
     info.topic_confidence = state->topic_confidence[index];
-   info.role = state->role[index];
-   info.mode = state->mode[index];
-   info.intent = state->intent[index];
+    info.role = sim_bee_role(state, index);
+    info.mode = sim_bee_mode(state, index);
+    info.intent = sim_bee_intent(state, index);
     info.path_final_x = state->target_pos_x[index];
     info.path_final_y = state->target_pos_y[index];
-    uint8_t path_valid = (state->path_valid) ? state->path_valid[index] : 0u;
+    uint8_t path_valid = sim_bee_flag(state, index, SIM_BEE_PATH_VALID) ? 1u : 0u;
     info.path_valid = path_valid;
-    uint8_t has_waypoint = (path_valid && state->path_has_waypoint) ? state->path_has_waypoint[index] : 0u;
-    info.path_has_waypoint = has_waypoint;
+    info.path_has_waypoint = sim_bee_flag(state, index, SIM_BEE_PATH_WAYPOINT) ? 1u : 0u;
     if (path_valid && state->path_waypoint_x && state->path_waypoint_y) {
         info.path_waypoint_x = state->path_waypoint_x[index];
         info.path_waypoint_y = state->path_waypoint_y[index];
@@ -1355,7 +3600,7 @@ bool sim_get_bee_info(const SimState *state, size_t index, BeeDebugInfo *out_inf
         info.path_waypoint_y = info.path_final_y;
     }
 
-    info.inside_hive = sim_point_inside_hive(state, info.pos_x, info.pos_y);
+    info.inside_hive = sim_tile_inside_hive(state, state->tile_index[index]);
 
     *out_info = info;
     return true;
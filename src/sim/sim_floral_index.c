@@ -0,0 +1,491 @@
+#include "sim_floral_index.h"
+
+#include <float.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "util/log.h"
+
+#define SIM_FLORAL_LEAF_TILES 8u
+#define SIM_FLORAL_NONE UINT32_MAX
+#define SIM_FLORAL_MIN_STOCK 0.5f
+#define SIM_FLORAL_JITTER_MIN 0.95f
+#define SIM_FLORAL_STACK_DEPTH 64u
+
+static bool sim_floral_tile_eligible(const HexWorld *world, size_t tile_index) {
+    return world->tiles[tile_index].terrain == HEX_TERRAIN_FLOWERS && world->nectar_capacity[tile_index] > 0.0f;
+}
+
+static float sim_floral_weight(const HexWorld *world, size_t tile_index, float stock) {
+    float quality = world->flower_quality[tile_index];
+    if (quality < 0.05f) {
+        quality = 0.05f;
+    }
+    float capacity = world->nectar_capacity[tile_index];
+    float stock_ratio = (capacity > 0.0f) ? (stock / capacity) : 0.0f;
+    return 1.0f + quality * 0.75f + stock_ratio * 0.5f;
+}
+
+static float sim_floral_tile_weight(const HexWorld *world, size_t tile_index) {
+    return sim_floral_weight(world, tile_index, hex_world_tile_nectar_stock(world, tile_index));
+}
+
+// Stock the node aggregates are built from. Under lazy recharge a tile's stock
+// rises without a touch, so a recharging tile counts at full capacity; the
+// aggregates then stay upper bounds until the next harvest touches the leaf.
+static float sim_floral_tile_stock_bound(const HexWorld *world, size_t tile_index) {
+    if (hex_world_nectar_lazy(world) && world->nectar_recharge_rate[tile_index] > 0.0f) {
+        return world->nectar_capacity[tile_index];
+    }
+    return hex_world_tile_nectar_stock(world, tile_index);
+}
+
+float sim_floral_tile_score(const HexWorld *world, size_t tile_index, float from_x, float from_y) {
+    const float *centers = world->centers_world_xy;
+    float cx = centers[tile_index * 2 + 0];
+    float cy = centers[tile_index * 2 + 1];
+    float dx = cx - from_x;
+    float dy = cy - from_y;
+    float distance_sq = dx * dx + dy * dy;
+    return distance_sq / sim_floral_tile_weight(world, tile_index);
+}
+
+// Candidate jitter in [0.95, 1.05]. One RNG block serves four consecutive tile
+// indices, so the caller caches the last block.
+typedef struct SimFloralJitter {
+    SimRngKey key;
+    uint32_t bee;
+    uint64_t tick;
+    size_t block_id;
+    uint32_t block[4];
+} SimFloralJitter;
+
+static float sim_floral_jitter(SimFloralJitter *jitter, size_t tile_index) {
+    size_t block_id = tile_index >> 2;
+    if (block_id != jitter->block_id) {
+        sim_rng_block(jitter->key,
+                      jitter->bee,
+                      jitter->tick,
+                      SIM_RNG_SLOT(SIM_RNG_STREAM_FLORAL_CHOICE, block_id),
+                      jitter->block);
+        jitter->block_id = block_id;
+    }
+    return SIM_FLORAL_JITTER_MIN + 0.1f * sim_rng_word_to_unit(jitter->block[tile_index & 3u]);
+}
+
+int32_t sim_floral_choose_linear(const HexWorld *world,
+                                 const size_t *floral_tiles,
+                                 size_t floral_count,
+                                 float from_x,
+                                 float from_y,
+                                 SimRngKey rng_key,
+                                 uint32_t bee,
+                                 uint64_t tick) {
+    if (!world || !floral_tiles || floral_count == 0) {
+        return -1;
+    }
+    size_t best_index = SIZE_MAX;
+    float best_score = FLT_MAX;
+    size_t fallback_index = SIZE_MAX;
+    float fallback_stock = 0.0f;
+    SimFloralJitter jitter = {.key = rng_key, .bee = bee, .tick = tick, .block_id = SIZE_MAX};
+
+    for (size_t i = 0; i < floral_count; ++i) {
+        size_t tile_index = floral_tiles[i];
+        if (tile_index >= world->tile_count) {
+            continue;
+        }
+        if (!sim_floral_tile_eligible(world, tile_index)) {
+            continue;
+        }
+        float stock = hex_world_tile_nectar_stock(world, tile_index);
+        if (stock > fallback_stock) {
+            fallback_stock = stock;
+            fallback_index = tile_index;
+        }
+        if (stock <= SIM_FLORAL_MIN_STOCK) {
+            continue;
+        }
+        float score = sim_floral_tile_score(world, tile_index, from_x, from_y);
+        score *= sim_floral_jitter(&jitter, tile_index);
+        if (score < best_score) {
+            best_score = score;
+            best_index = tile_index;
+        }
+    }
+
+    if (best_index != SIZE_MAX) {
+        return best_index > (size_t)INT32_MAX ? -1 : (int32_t)best_index;
+    }
+    if (fallback_index != SIZE_MAX && fallback_stock > 0.0f) {
+        return fallback_index > (size_t)INT32_MAX ? -1 : (int32_t)fallback_index;
+    }
+    return -1;
+}
+
+typedef struct SimFloralBuildItem {
+    float x;
+    float y;
+    uint32_t tile;
+} SimFloralBuildItem;
+
+static int sim_floral_cmp_x(const void *a, const void *b) {
+    const SimFloralBuildItem *ia = (const SimFloralBuildItem *)a;
+    const SimFloralBuildItem *ib = (const SimFloralBuildItem *)b;
+    if (ia->x != ib->x) {
+        return ia->x < ib->x ? -1 : 1;
+    }
+    return ia->tile < ib->tile ? -1 : (ia->tile > ib->tile);
+}
+
+static int sim_floral_cmp_y(const void *a, const void *b) {
+    const SimFloralBuildItem *ia = (const SimFloralBuildItem *)a;
+    const SimFloralBuildItem *ib = (const SimFloralBuildItem *)b;
+    if (ia->y != ib->y) {
+        return ia->y < ib->y ? -1 : 1;
+    }
+    return ia->tile < ib->tile ? -1 : (ia->tile > ib->tile);
+}
+
+static int sim_floral_cmp_tile(const void *a, const void *b) {
+    const SimFloralBuildItem *ia = (const SimFloralBuildItem *)a;
+    const SimFloralBuildItem *ib = (const SimFloralBuildItem *)b;
+    return ia->tile < ib->tile ? -1 : (ia->tile > ib->tile);
+}
+
+// Median split on the longer axis of the centers' bounding box, emitting
+// nodes in preorder. Leaf tiles are kept in tile index order so the jitter
+// block cache hits for neighbouring tiles.
+static uint32_t sim_floral_build_node(SimFloralIndex *index,
+                                      SimFloralBuildItem *items,
+                                      size_t begin,
+                                      size_t end,
+                                      uint32_t parent) {
+    uint32_t node_id = (uint32_t)index->node_count++;
+    SimFloralNode *node = &index->nodes[node_id];
+    node->min_x = FLT_MAX;
+    node->min_y = FLT_MAX;
+    node->max_x = -FLT_MAX;
+    node->max_y = -FLT_MAX;
+    for (size_t k = begin; k < end; ++k) {
+        if (items[k].x < node->min_x) node->min_x = items[k].x;
+        if (items[k].y < node->min_y) node->min_y = items[k].y;
+        if (items[k].x > node->max_x) node->max_x = items[k].x;
+        if (items[k].y > node->max_y) node->max_y = items[k].y;
+    }
+    node->parent = parent;
+    node->right = SIM_FLORAL_NONE;
+    node->first = 0;
+    node->count = 0;
+
+    size_t count = end - begin;
+    if (count <= SIM_FLORAL_LEAF_TILES) {
+        qsort(items + begin, count, sizeof(SimFloralBuildItem), sim_floral_cmp_tile);
+        node->first = (uint32_t)begin;
+        node->count = (uint32_t)count;
+        for (size_t k = begin; k < end; ++k) {
+            index->tiles[k] = items[k].tile;
+            index->leaf_of_tile[items[k].tile] = node_id;
+        }
+        return node_id;
+    }
+
+    bool split_x = (node->max_x - node->min_x) >= (node->max_y - node->min_y);
+    qsort(items + begin, count, sizeof(SimFloralBuildItem), split_x ? sim_floral_cmp_x : sim_floral_cmp_y);
+    size_t mid = begin + count / 2u;
+    sim_floral_build_node(index, items, begin, mid, node_id);
+    uint32_t right = sim_floral_build_node(index, items, mid, end, node_id);
+    index->nodes[node_id].right = right;
+    return node_id;
+}
+
+static void sim_floral_refresh_leaf(SimFloralIndex *index, const HexWorld *world, SimFloralNode *node) {
+    float max_weight = 0.0f;
+    float max_stock = 0.0f;
+    uint32_t max_stock_tile = SIM_FLORAL_NONE;
+    for (uint32_t k = 0; k < node->count; ++k) {
+        uint32_t tile_index = index->tiles[node->first + k];
+        if (!sim_floral_tile_eligible(world, tile_index)) {
+            continue;
+        }
+        float stock = sim_floral_tile_stock_bound(world, tile_index);
+        float weight = sim_floral_weight(world, tile_index, stock);
+        if (weight > max_weight) {
+            max_weight = weight;
+        }
+        // Leaf tiles are in index order, so the first maximum is the lowest.
+        if (stock > max_stock) {
+            max_stock = stock;
+            max_stock_tile = tile_index;
+        }
+    }
+    node->max_weight = max_weight;
+    node->max_stock = max_stock;
+    node->max_stock_tile = max_stock_tile;
+}
+
+static void sim_floral_refresh_internal(SimFloralIndex *index, SimFloralNode *node, uint32_t node_id) {
+    const SimFloralNode *left = &index->nodes[node_id + 1u];
+    const SimFloralNode *right = &index->nodes[node->right];
+    node->max_weight = left->max_weight > right->max_weight ? left->max_weight : right->max_weight;
+    const SimFloralNode *pick = left;
+    if (right->max_stock > left->max_stock ||
+        (right->max_stock == left->max_stock && right->max_stock > 0.0f && right->max_stock_tile < left->max_stock_tile)) {
+        pick = right;
+    }
+    node->max_stock = pick->max_stock;
+    node->max_stock_tile = pick->max_stock_tile;
+}
+
+void sim_floral_index_free(SimFloralIndex *index) {
+    if (!index) {
+        return;
+    }
+    free(index->nodes);
+    free(index->tiles);
+    free(index->leaf_of_tile);
+    free(index->node_dirty);
+    free(index->dirty_nodes);
+    memset(index, 0, sizeof *index);
+}
+
+bool sim_floral_index_build(SimFloralIndex *index, const HexWorld *world, const size_t *floral_tiles, size_t floral_count) {
+    if (!index) {
+        return false;
+    }
+    sim_floral_index_free(index);
+    if (!world || !floral_tiles || floral_count == 0 || world->tile_count >= SIM_FLORAL_NONE) {
+        return false;
+    }
+
+    // Every split leaves more than SIM_FLORAL_LEAF_TILES / 2 tiles per side.
+    size_t leaf_bound = floral_count / (SIM_FLORAL_LEAF_TILES / 2u) + 1u;
+    size_t node_bound = 2u * leaf_bound;
+    SimFloralBuildItem *items = (SimFloralBuildItem *)malloc(floral_count * sizeof(SimFloralBuildItem));
+    index->nodes = (SimFloralNode *)calloc(node_bound, sizeof(SimFloralNode));
+    index->tiles = (uint32_t *)malloc(floral_count * sizeof(uint32_t));
+    index->leaf_of_tile = (uint32_t *)malloc(world->tile_count * sizeof(uint32_t));
+    index->node_dirty = (uint8_t *)calloc(node_bound, sizeof(uint8_t));
+    index->dirty_nodes = (uint32_t *)malloc(node_bound * sizeof(uint32_t));
+    if (!items || !index->nodes || !index->tiles || !index->leaf_of_tile || !index->node_dirty ||
+        !index->dirty_nodes) {
+        LOG_ERROR("sim: failed to allocate floral tree for %zu tiles", floral_count);
+        free(items);
+        sim_floral_index_free(index);
+        return false;
+    }
+
+    for (size_t t = 0; t < world->tile_count; ++t) {
+        index->leaf_of_tile[t] = SIM_FLORAL_NONE;
+    }
+    size_t item_count = 0;
+    for (size_t i = 0; i < floral_count; ++i) {
+        size_t tile_index = floral_tiles[i];
+        if (tile_index >= world->tile_count) {
+            continue;
+        }
+        items[item_count].x = world->centers_world_xy[tile_index * 2 + 0];
+        items[item_count].y = world->centers_world_xy[tile_index * 2 + 1];
+        items[item_count].tile = (uint32_t)tile_index;
+        ++item_count;
+    }
+    if (item_count == 0) {
+        free(items);
+        sim_floral_index_free(index);
+        return false;
+    }
+    index->tile_count = item_count;
+    index->world_tile_count = world->tile_count;
+    sim_floral_build_node(index, items, 0, item_count, SIM_FLORAL_NONE);
+    free(items);
+
+    for (size_t n = index->node_count; n-- > 0;) {
+        SimFloralNode *node = &index->nodes[n];
+        if (node->count > 0) {
+            sim_floral_refresh_leaf(index, world, node);
+        } else {
+            sim_floral_refresh_internal(index, node, (uint32_t)n);
+        }
+    }
+    return true;
+}
+
+void sim_floral_index_touch(SimFloralIndex *index, size_t tile_index) {
+    if (!index || !index->nodes || tile_index >= index->world_tile_count) {
+        return;
+    }
+    uint32_t leaf = index->leaf_of_tile[tile_index];
+    if (leaf == SIM_FLORAL_NONE || index->node_dirty[leaf]) {
+        return;
+    }
+    index->node_dirty[leaf] = 1u;
+    index->dirty_nodes[index->dirty_count++] = leaf;
+}
+
+void sim_floral_index_touch_bits(SimFloralIndex *index, const uint64_t *changed, size_t tile_count) {
+    if (!index || !index->nodes || !changed) {
+        return;
+    }
+    if (tile_count > index->world_tile_count) {
+        tile_count = index->world_tile_count;
+    }
+    size_t word_count = (tile_count + 63u) / 64u;
+    for (size_t w = 0; w < word_count; ++w) {
+        uint64_t bits = changed[w];
+        for (size_t tile = w * 64u; bits != 0; ++tile, bits >>= 1) {
+            if ((bits & 1u) && tile < tile_count) {
+                sim_floral_index_touch(index, tile);
+            }
+        }
+    }
+}
+
+static int sim_floral_cmp_node_desc(const void *a, const void *b) {
+    uint32_t na = *(const uint32_t *)a;
+    uint32_t nb = *(const uint32_t *)b;
+    return na > nb ? -1 : (na < nb);
+}
+
+void sim_floral_index_refresh(SimFloralIndex *index, const HexWorld *world) {
+    if (!index || !index->nodes || !world || index->dirty_count == 0) {
+        return;
+    }
+    // Mark every ancestor of a stale leaf once.
+    size_t leaf_count = index->dirty_count;
+    for (size_t d = 0; d < leaf_count; ++d) {
+        uint32_t parent = index->nodes[index->dirty_nodes[d]].parent;
+        while (parent != SIM_FLORAL_NONE && !index->node_dirty[parent]) {
+            index->node_dirty[parent] = 1u;
+            index->dirty_nodes[index->dirty_count++] = parent;
+            parent = index->nodes[parent].parent;
+        }
+    }
+
+    // Children follow their parent in preorder, so descending node order
+    // recomputes every child before its parent. A sweep beats sorting once a
+    // large share of the tree is stale (e.g. daytime recharge).
+    if (index->dirty_count * 8u > index->node_count) {
+        for (size_t n = index->node_count; n-- > 0;) {
+            if (!index->node_dirty[n]) {
+                continue;
+            }
+            SimFloralNode *node = &index->nodes[n];
+            if (node->count > 0) {
+                sim_floral_refresh_leaf(index, world, node);
+            } else {
+                sim_floral_refresh_internal(index, node, (uint32_t)n);
+            }
+            index->node_dirty[n] = 0u;
+        }
+    } else {
+        qsort(index->dirty_nodes, index->dirty_count, sizeof(uint32_t), sim_floral_cmp_node_desc);
+        for (size_t d = 0; d < index->dirty_count; ++d) {
+            uint32_t n = index->dirty_nodes[d];
+            SimFloralNode *node = &index->nodes[n];
+            if (node->count > 0) {
+                sim_floral_refresh_leaf(index, world, node);
+            } else {
+                sim_floral_refresh_internal(index, node, n);
+            }
+            index->node_dirty[n] = 0u;
+        }
+    }
+    index->dirty_count = 0;
+}
+
+// Lowest score any tile under the node could reach. Built from the same
+// rounded operations as the real score applied to smaller-or-equal inputs, so
+// it never exceeds it.
+static float sim_floral_node_bound(const SimFloralNode *node, float from_x, float from_y) {
+    float dx = 0.0f;
+    if (from_x < node->min_x) {
+        dx = node->min_x - from_x;
+    } else if (from_x > node->max_x) {
+        dx = from_x - node->max_x;
+    }
+    float dy = 0.0f;
+    if (from_y < node->min_y) {
+        dy = node->min_y - from_y;
+    } else if (from_y > node->max_y) {
+        dy = from_y - node->max_y;
+    }
+    float distance_sq = dx * dx + dy * dy;
+    return (distance_sq / node->max_weight) * SIM_FLORAL_JITTER_MIN;
+}
+
+int32_t sim_floral_index_choose(const SimFloralIndex *index,
+                                const HexWorld *world,
+                                float from_x,
+                                float from_y,
+                                SimRngKey rng_key,
+                                uint32_t bee,
+                                uint64_t tick) {
+    if (!index || !index->nodes || index->node_count == 0 || !world) {
+        return -1;
+    }
+    const SimFloralNode *root = &index->nodes[0];
+    if (root->max_stock <= SIM_FLORAL_MIN_STOCK) {
+        // No candidate: fall back to the fullest tile, like the linear scan.
+        // Bounds built for lazy recharge cannot name it.
+        if (!hex_world_nectar_lazy(world) && root->max_stock > 0.0f && root->max_stock_tile <= (uint32_t)INT32_MAX) {
+            return (int32_t)root->max_stock_tile;
+        }
+        return -1;
+    }
+
+    uint32_t best_index = SIM_FLORAL_NONE;
+    float best_score = FLT_MAX;
+    SimFloralJitter jitter = {.key = rng_key, .bee = bee, .tick = tick, .block_id = SIZE_MAX};
+    uint32_t stack[SIM_FLORAL_STACK_DEPTH];
+    size_t stack_size = 0;
+    stack[stack_size++] = 0u;
+
+    // Ties on score go to the lowest tile index, as in the linear scan, so a
+    // node is only pruned when its bound is strictly worse than the best.
+    while (stack_size > 0) {
+        uint32_t node_id = stack[--stack_size];
+        const SimFloralNode *node = &index->nodes[node_id];
+        if (node->max_stock <= SIM_FLORAL_MIN_STOCK || sim_floral_node_bound(node, from_x, from_y) > best_score) {
+            continue;
+        }
+        if (node->count == 0) {
+            uint32_t left = node_id + 1u;
+            uint32_t right = node->right;
+            float left_bound = sim_floral_node_bound(&index->nodes[left], from_x, from_y);
+            float right_bound = sim_floral_node_bound(&index->nodes[right], from_x, from_y);
+            if (stack_size + 2u > SIM_FLORAL_STACK_DEPTH) {
+                continue;  // unreachable for median-split trees of < 2^60 tiles
+            }
+            // Visit the closer child first so the best score tightens early.
+            if (left_bound <= right_bound) {
+                stack[stack_size++] = right;
+                stack[stack_size++] = left;
+            } else {
+                stack[stack_size++] = left;
+                stack[stack_size++] = right;
+            }
+            continue;
+        }
+        for (uint32_t k = 0; k < node->count; ++k) {
+            uint32_t tile_index = index->tiles[node->first + k];
+            if (!sim_floral_tile_eligible(world, tile_index) ||
+                hex_world_tile_nectar_stock(world, tile_index) <= SIM_FLORAL_MIN_STOCK) {
+                continue;
+            }
+            float score = sim_floral_tile_score(world, tile_index, from_x, from_y);
+            if (score * SIM_FLORAL_JITTER_MIN > best_score) {
+                continue;
+            }
+            score *= sim_floral_jitter(&jitter, tile_index);
+            if (score < best_score || (score == best_score && tile_index < best_index)) {
+                best_score = score;
+                best_index = tile_index;
+            }
+        }
+    }
+
+    if (best_index == SIM_FLORAL_NONE || best_index > (uint32_t)INT32_MAX) {
+        return -1;
+    }
+    return (int32_t)best_index;
+}
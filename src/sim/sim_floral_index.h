@@ -0,0 +1,86 @@
+#ifndef SIM_SIM_FLORAL_INDEX_H
+#define SIM_SIM_FLORAL_INDEX_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "hex.h"
+#include "sim_rng.h"
+
+// Bounding-volume tree over the floral tiles for forage target selection.
+// Leaves hold a few spatially close tiles; every node keeps the bounding box
+// of its tile centers, an upper bound of the scoring weight and the largest
+// stock below it. A branch-and-bound query returns exactly the tile the linear
+// scan would pick, visiting only the nodes that could still beat the best
+// score found so far.
+
+typedef struct SimFloralNode {
+    float min_x;
+    float min_y;
+    float max_x;
+    float max_y;
+    float max_weight;         // >= sim_floral_tile_weight of every eligible tile
+    float max_stock;
+    uint32_t max_stock_tile;  // lowest tile index holding max_stock, UINT32_MAX if none
+    uint32_t parent;          // UINT32_MAX for the root
+    uint32_t right;           // internal: right child (left child is the next node)
+    uint32_t first;           // leaf: offset into tiles
+    uint32_t count;           // leaf: tile count; 0 for internal nodes
+} SimFloralNode;
+
+typedef struct SimFloralIndex {
+    SimFloralNode *nodes;  // preorder, so children always follow their parent
+    size_t node_count;
+    uint32_t *tiles;       // floral tile indices in leaf order
+    size_t tile_count;
+    uint32_t *leaf_of_tile;  // per world tile, UINT32_MAX when not indexed
+    size_t world_tile_count;
+    uint8_t *node_dirty;
+    uint32_t *dirty_nodes;
+    size_t dirty_count;
+} SimFloralIndex;
+
+float sim_floral_tile_score(const HexWorld *world, size_t tile_index, float from_x, float from_y);
+// Distance-squared over the quality/stock weight; lower is better.
+
+int32_t sim_floral_choose_linear(const HexWorld *world,
+                                 const size_t *floral_tiles,
+                                 size_t floral_count,
+                                 float from_x,
+                                 float from_y,
+                                 SimRngKey rng_key,
+                                 uint32_t bee,
+                                 uint64_t tick);
+// Reference selection: scores every floral tile (stock > 0.5) with a +-5%
+// jitter keyed by bee, tick and tile, and returns the best, or the fullest
+// tile when none qualifies, or -1.
+
+bool sim_floral_index_build(SimFloralIndex *index, const HexWorld *world, const size_t *floral_tiles, size_t floral_count);
+// Builds the tree over the given tiles and computes all aggregates. Returns
+// false (leaving the index empty) on allocation failure.
+
+void sim_floral_index_free(SimFloralIndex *index);
+
+void sim_floral_index_touch(SimFloralIndex *index, size_t tile_index);
+// Marks the leaf holding tile_index stale after its stock changed.
+
+void sim_floral_index_touch_bits(SimFloralIndex *index, const uint64_t *changed, size_t tile_count);
+// Same as touching every tile whose bit is set in the per-tile bitset.
+
+void sim_floral_index_refresh(SimFloralIndex *index, const HexWorld *world);
+// Recomputes the stale leaves and their ancestors.
+
+int32_t sim_floral_index_choose(const SimFloralIndex *index,
+                                const HexWorld *world,
+                                float from_x,
+                                float from_y,
+                                SimRngKey rng_key,
+                                uint32_t bee,
+                                uint64_t tick);
+// Same result as sim_floral_choose_linear over the indexed tiles, provided the
+// index has been refreshed since the last stock change. Under lazy recharge the
+// aggregates are only bounds: a tile above the threshold is still found, but
+// when none is, -1 is returned instead of the fullest tile.
+
+#endif  // SIM_SIM_FLORAL_INDEX_H
@@ -11,12 +11,82 @@
 #endif
 
 #include "hex.h"
+#include "sim.h"
+#include "sim_journal.h"
+#include "util/job_pool.h"
+#include "util/snapshot.h"
+#include "util/timer_wheel.h"
+#include "sim_floral_index.h"
+#include "sim_spatial.h"
 
 #define TWO_PI (2.0f * (float)M_PI)
 
+#define SIM_CACHE_LINE_BYTES 64u
+// Bees per sim_tick job. A multiple of 16 so every float column chunk starts
+// on its own cache line and neighbouring jobs never share one.
+#define SIM_TICK_CHUNK_BEES 256u
+// Cached tile index of a bee off the hex grid.
+#define SIM_TILE_NONE UINT32_MAX
+// Inscribed radius of a hex over its cell radius (sqrt(3)/2), less 1% so the
+// cached-tile test never disagrees with axial rounding near an edge.
+#define SIM_TILE_INNER_RADIUS 0.857f
+// Target mean occupancy of a spatial grid cell at full capacity.
+#define SIM_SPATIAL_BEES_PER_CELL 2.0f
+// sim_tick compacts away dead slots on ticks that are a multiple of this.
+#define SIM_COMPACT_INTERVAL_TICKS 256u
+// Multi-rate: a held FORAGING or UNLOADING bee is advanced every this many
+// ticks, a motionless IDLE one every SIM_RATE_IDLE_TICKS. Powers of two.
+#define SIM_RATE_HOLD_TICKS 4u
+#define SIM_RATE_IDLE_TICKS 8u
+// Level of detail: bees within this many hex cell radii of the detail region
+// still get full-fidelity steering.
+#define SIM_LOD_MARGIN_CELLS 3.0f
+// Half-width of the per-tick heading jitter of full-fidelity flight (radians).
+#define SIM_FLIGHT_JITTER_RAD 0.08f
+// Caste pools: the roles held (NURSE, HOUSEKEEPER, STORAGE) and the number of
+// whole-day age cohorts; bee_pick_role gives a bee of SIM_POOL_DAYS an
+// outside role.
+#define SIM_POOL_ROLES 3u
+#define SIM_POOL_DAYS 18u
+// sim_tick settles every park_tick stamp on ticks with these bits clear, so no
+// stamp is ever 2^31 or more ticks old.
+#define SIM_STAMP_REBASE_MASK ((UINT64_C(1) << 31) - 1u)
+// Upper bound on the number of per-bee arrays listed by sim_bee_columns.
+#define SIM_BEE_COLUMN_MAX 40u
+
+#define SIM_CHUNK_MASK_WORDS (SIM_TICK_CHUNK_BEES / 64u)
+
+// Per-chunk tick statistics, padded to two cache lines so workers never write
+// to the same line. Merged in chunk order after the parallel pass.
+typedef struct SimChunkStats {
+    double speed_sum;
+    float speed_min;
+    float speed_max;
+    uint64_t bounce_count;
+    uint32_t parked_count;        // hibernating bees in the chunk
+    uint32_t park_request_count;  // bees parked this tick, queued in park_requests
+    uint64_t parked_mask[SIM_CHUNK_MASK_WORDS];  // bit j: slot begin + j is parked
+    uint8_t pad[2u * SIM_CACHE_LINE_BYTES - 2u * sizeof(double) - 2u * sizeof(float) - 2u * sizeof(uint32_t) -
+                SIM_CHUNK_MASK_WORDS * sizeof(uint64_t)];
+} SimChunkStats;
+
+// A bee parked during the parallel pass; its wake-up is scheduled on the timer
+// wheel afterwards. due_tick is UINT64_MAX for bees only events can wake.
+typedef struct SimParkRequest {
+    uint64_t due_tick;
+    uint32_t bee;
+} SimParkRequest;
+
 typedef struct SimState {
-    size_t count;
-    size_t capacity;
+    size_t count;     // slots in use, live or dead; the tick loops run over [0, count)
+    size_t capacity;  // allocated slots; grows geometrically on spawn
+    size_t live_count;
+    // Dead slots below count, reused by the next spawns (LIFO) and squeezed out
+    // by the periodic stable compaction.
+    uint32_t *free_slots;
+    size_t free_count;
+    uint64_t compaction_epoch;  // compactions since sim_init
+    uint32_t *compaction_remap;  // last compaction: old slot -> new slot, UINT32_MAX if dead
     uint64_t seed;
     float world_w;
     float world_h;
@@ -33,30 +103,37 @@ typedef struct SimState {
     float *y;
     float *vx;
     float *vy;
-    float *heading;
-    float *radius;
-    uint32_t *color_rgba;
+    float *heading;        // NULL in compact mode (atan2 of the velocity)
+    float *radius;         // NULL in compact mode (default_radius, 0 when dead)
+    uint32_t *color_rgba;  // NULL in compact mode (bee_color_for role and mode)
     float *scratch_xy;
     float *age_days;
     float *t_state;
-    float *energy;
-    float *load_nectar;
+    float *energy;       // NULL in compact mode, see energy_q
+    float *load_nectar;  // NULL in compact mode, see load_q
     float *target_pos_x;
     float *target_pos_y;
     int32_t *target_id;
     int16_t *topic_id;
     uint8_t *topic_confidence;
-    uint8_t *role;
-    uint8_t *mode;
-    uint8_t *intent;
-    float *capacity_uL;
-    float *harvest_rate_uLps;
-    uint8_t *inside_hive_flag;
-    float *path_waypoint_x;
+    uint16_t *bee_flags;       // role, mode, intent and the SIM_BEE_* bits
+    float *capacity_uL;        // NULL in compact mode (uniform bee_capacity_uL)
+    float *harvest_rate_uLps;  // NULL in compact mode (uniform bee_harvest_rate_uLps)
+    uint32_t *tile_index;  // hex tile under the bee, SIM_TILE_NONE off the grid
+    float *path_waypoint_x;  // NULL unless inspection is on
     float *path_waypoint_y;
-    uint8_t *path_has_waypoint;
-    uint8_t *path_valid;
-    uint64_t rng_state;
+    int32_t *request_tile;  // tile the bee harvests from / deposits into this tick, -1 for none
+    float *request_uL;
+    // Compact mode: energy and load are stored as 16-bit fixed point (energy
+    // in 1/65535 steps, load in load_quantum_uL steps) and rounded
+    // stochastically on every store, so per-tick changes far below one step
+    // still accumulate correctly on average.
+    bool compact;
+    uint16_t *energy_q;
+    uint16_t *load_q;
+    float load_quantum_uL;
+    bool inspection;  // keep the debug-only path_waypoint columns
+    uint64_t tick_index;  // ticks advanced since the last fill; keys the counter RNG
     double log_accum_sec;
     uint64_t log_bounce_count;
     uint64_t log_sample_count;
@@ -67,9 +144,11 @@ typedef struct SimState {
     HexWorld *hex_world;
     size_t *floral_tile_indices;
     size_t floral_tile_count;
+    SimFloralIndex floral_tree;  // branch-and-bound target selection over floral_tile_indices
     float floral_clock_sec;
     float floral_day_period_sec;
     float floral_night_scale;
+    bool lazy_recharge;  // recharge nectar on access (tile_flower_set_lazy)
     float bee_capacity_uL;
     float bee_harvest_rate_uLps;
     float bee_unload_rate_uLps;
@@ -77,8 +156,166 @@ typedef struct SimState {
     float bee_speed_mps;
     float bee_seek_accel;
     float bee_arrive_tol_world;
+
+    JobPool *job_pool;
+    size_t worker_count;
+    SimKinematicsKernel kinematics_kernel;  // resolved, never AUTO
+    bool mode_buckets;                      // per-mode fast paths in sim_tick
+    bool hibernation;                       // park settled resting bees
+    bool multi_rate;                        // advance held and idle bees at sub-rates
+    // Level of detail: flight legs outside the detail region that provably
+    // miss the hive walls skip path planning and heading jitter.
+    bool detail_region;
+    float detail_min_x;
+    float detail_min_y;
+    float detail_max_x;
+    float detail_max_y;
+    // Caste pools: settled in-hive nurses, housekeepers and storage bees are
+    // held as counts per role and age cohort instead of in slots. A pooled
+    // bee's age is its cohort day plus the fraction of a day since
+    // pool_day_start_sec, which every cohort shares.
+    bool caste_pools;
+    double pool_day_start_sec;
+    uint32_t caste_pool[SIM_POOL_ROLES][SIM_POOL_DAYS];
+    size_t pooled_count;
+
+    // Hibernation: a parked bee is skipped by sim_tick. Its energy, t_state and
+    // age_days hold the values at its park_tick and advance in closed form when
+    // it is read or woken (by its wake_wheel timer or by sim_wake_all).
+    // A SIM_BEE_LAGGING bee was likewise last advanced at park_tick and
+    // catches up with one accumulated step on its next sub-rate tick.
+    // park_tick keeps the low 32 bits of tick_index, and every tick since an
+    // outstanding stamp was stamp_dt_sec long: sim_tick settles all stamps
+    // before a step of another length and every 2^31 ticks.
+    double sim_time_sec;
+    uint8_t *parked;
+    uint32_t *park_tick;
+    float stamp_dt_sec;
+    SimParkRequest *park_requests;  // per chunk, at the chunk's first bee index
+    TimerWheel *wake_wheel;
+    SimChunkStats *chunk_stats;
+    size_t chunk_capacity;
+
+    // Bee positions bucketed by grid cell for the neighbour and pick queries.
+    // Only the queries read it, so it is rebuilt by the first query after the
+    // positions changed (spatial_stale) rather than every tick.
+    SimSpatialGrid spatial;
+    bool spatial_stale;
+
+    // Per-tick request buckets: requests are counting-sorted by tile (bee
+    // order within a tile) and handed to the hex world resolve functions.
+    uint32_t *tile_request_count;  // per world tile; all zero between ticks
+    size_t tile_request_capacity;
+    uint32_t *touched_tiles;
+    uint32_t *request_bee;
+    HexTileRequest *requests;
+    float *request_granted_uL;
+
+    // Checkpoint the persistent bee columns were bound from by
+    // sim_snapshot_load. Columns inside its mapping are never freed; they are
+    // replaced by heap copies when capacity grows.
+    SnapshotReader *snapshot;
+    SimJournal *journal;  // not owned; receives every externally driven change
+
+    // Compact mode: radii and colors derived for sim_build_view, allocated by
+    // its first call.
+    float *view_radius;
+    uint32_t *view_color_rgba;
+    size_t view_capacity;
 } SimState;
 
+// bee_flags layout: three 3-bit fields followed by single-bit states.
+#define SIM_BEE_ROLE_SHIFT 0u
+#define SIM_BEE_MODE_SHIFT 3u
+#define SIM_BEE_INTENT_SHIFT 6u
+#define SIM_BEE_FIELD_MASK 0x7u
+#define SIM_BEE_INSIDE_HIVE (1u << 9)
+#define SIM_BEE_PATH_VALID (1u << 10)
+#define SIM_BEE_PATH_WAYPOINT (1u << 11)
+#define SIM_BEE_DEAD (1u << 12)  // free slot: skipped by the tick, never returned by queries
+#define SIM_BEE_LAGGING (1u << 13)  // skipped by multi-rate since park_tick
+
+_Static_assert(BEE_ROLE_QUEEN <= SIM_BEE_FIELD_MASK && BEE_MODE_UNLOADING <= SIM_BEE_FIELD_MASK &&
+                   BEE_INTENT_EXPLORE <= SIM_BEE_FIELD_MASK,
+               "bee enums no longer fit the bee_flags fields");
+_Static_assert(BEE_ROLE_NURSE == 0 && BEE_ROLE_HOUSEKEEPER == 1 && BEE_ROLE_STORAGE == SIM_POOL_ROLES - 1u,
+               "caste pools index cohorts by the in-hive roles");
+
+#define SIM_ENERGY_STEPS 65535.0f
+
+static inline uint8_t sim_bee_field(const SimState *state, size_t i, unsigned shift) {
+    return (uint8_t)((state->bee_flags[i] >> shift) & SIM_BEE_FIELD_MASK);
+}
+
+static inline void sim_bee_set_field(SimState *state, size_t i, unsigned shift, uint8_t value) {
+    uint16_t flags = (uint16_t)(state->bee_flags[i] & ~(SIM_BEE_FIELD_MASK << shift));
+    state->bee_flags[i] = (uint16_t)(flags | ((value & SIM_BEE_FIELD_MASK) << shift));
+}
+
+static inline uint8_t sim_bee_role(const SimState *state, size_t i) {
+    return sim_bee_field(state, i, SIM_BEE_ROLE_SHIFT);
+}
+
+static inline uint8_t sim_bee_mode(const SimState *state, size_t i) {
+    return sim_bee_field(state, i, SIM_BEE_MODE_SHIFT);
+}
+
+static inline uint8_t sim_bee_intent(const SimState *state, size_t i) {
+    return sim_bee_field(state, i, SIM_BEE_INTENT_SHIFT);
+}
+
+static inline bool sim_bee_flag(const SimState *state, size_t i, uint16_t bit) {
+    return (state->bee_flags[i] & bit) != 0;
+}
+
+static inline void sim_bee_set_flag(SimState *state, size_t i, uint16_t bit, bool on) {
+    state->bee_flags[i] = (uint16_t)(on ? (state->bee_flags[i] | bit) : (state->bee_flags[i] & ~bit));
+}
+
+static inline float sim_bee_energy(const SimState *state, size_t i) {
+    return state->compact ? (float)state->energy_q[i] * (1.0f / SIM_ENERGY_STEPS) : state->energy[i];
+}
+
+static inline float sim_bee_load(const SimState *state, size_t i) {
+    return state->compact ? (float)state->load_q[i] * state->load_quantum_uL : state->load_nectar[i];
+}
+
+static inline float sim_bee_radius(const SimState *state, size_t i) {
+    if (state->radius) {
+        return state->radius[i];
+    }
+    return sim_bee_flag(state, i, SIM_BEE_DEAD) ? 0.0f : state->default_radius;
+}
+
+// One per-bee array of SimState, for code that handles the columns uniformly
+// (capacity growth, compaction). Optional columns have *data == NULL. Scratch
+// columns carry nothing from one tick to the next.
+typedef struct SimBeeColumn {
+    void **data;
+    size_t elem_size;
+    const char *name;
+    bool scratch;
+} SimBeeColumn;
+
+size_t sim_bee_columns(SimState *state, SimBeeColumn out[SIM_BEE_COLUMN_MAX]);
+// Lists the per-bee arrays; returns the count written.
+
+// Checkpoint format version; bump whenever a column or the meta layout
+// changes. Column element sizes are checked separately on load.
+#define SIM_SNAPSHOT_VERSION 5u
+
+bool sim_snapshot_write_state(const SimState *state, SnapshotWriter *writer);
+// Writes every persistent column of state and its bound world (which must be
+// set). Returns false on allocation or write failure.
+
+bool sim_snapshot_restore(SimState **out_state,
+                          HexWorld *out_world,
+                          size_t worker_count,
+                          SnapshotReader *reader,
+                          const char *path);
+// Body of sim_snapshot_load over an open reader, which it takes ownership of
+// (it is closed on failure). path only labels log messages.
+
 static inline float clampf(float v, float lo, float hi) {
     if (v < lo) {
         return lo;
@@ -89,22 +326,4 @@ static inline float clampf(float v, float lo, float hi) {
     return v;
 }
 
-static inline uint64_t xorshift64(uint64_t *state) {
-    uint64_t x = *state;
-    x ^= x << 13;
-    x ^= x >> 7;
-    x ^= x << 17;
-    *state = x;
-    return x;
-}
-
-static inline float rand_uniform01(uint64_t *state) {
-    uint64_t x = xorshift64(state);
-    return (float)((x >> 11) * (1.0 / 9007199254740992.0));
-}
-
-static inline float rand_symmetric(uint64_t *state) {
-    return rand_uniform01(state) * 2.0f - 1.0f;
-}
-
 #endif  // SIM_SIM_INTERNAL_H
@@ -0,0 +1,607 @@
+#include "sim_journal.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sim_internal.h"
+#include "sim_rewind.h"
+#include "util/log.h"
+
+#define SIM_JOURNAL_MAGIC "BEEJRNL"
+// Bump whenever a record payload changes. Params is stored raw, so its size
+// is checked separately.
+#define SIM_JOURNAL_VERSION 2u
+#define SIM_JOURNAL_PATH_MAX 4096u
+
+typedef struct SimJournalHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t params_bytes;
+    uint64_t hash_interval;
+} SimJournalHeader;
+
+typedef struct SimJournalRecord {
+    uint32_t event;
+    uint32_t payload_bytes;
+    uint64_t tick;  // state tick_index when the event was applied
+} SimJournalRecord;
+
+typedef struct SimJournalTicks {
+    uint64_t count;
+    float dt_sec;
+    uint32_t pad;
+} SimJournalTicks;
+
+typedef struct SimJournalOptionValue {
+    uint32_t option;
+    uint32_t enabled;
+} SimJournalOptionValue;
+
+typedef struct SimJournalSpawn {
+    uint32_t role;
+    float x;
+    float y;
+    uint32_t pad;
+} SimJournalSpawn;
+
+typedef struct SimJournalDetailRegion {
+    uint32_t enabled;
+    float min_x;
+    float min_y;
+    float max_x;
+    float max_y;
+    uint32_t pad;
+} SimJournalDetailRegion;
+
+typedef struct SimJournalRewind {
+    uint64_t interval_ticks;
+    uint64_t max_keyframes;
+    uint64_t max_bytes;
+} SimJournalRewind;
+
+typedef struct SimJournalSeek {
+    uint64_t tick;
+    float dt_sec;
+    uint32_t pad;
+} SimJournalSeek;
+
+_Static_assert(sizeof(SimJournalHeader) == 24u, "journal header layout is part of the file format");
+_Static_assert(sizeof(SimJournalRecord) == 16u, "journal record layout is part of the file format");
+
+struct SimJournal {
+    FILE *file;
+    uint64_t hash_interval;
+    uint64_t run_tick;  // first tick of the pending TICKS run
+    uint64_t run_count;
+    float run_dt;
+    bool ok;
+};
+
+static void sim_journal_put(SimJournal *journal, uint32_t event, uint64_t tick, const void *payload, size_t bytes) {
+    if (!journal->ok) {
+        return;
+    }
+    SimJournalRecord record = {event, (uint32_t)bytes, tick};
+    if (fwrite(&record, sizeof record, 1, journal->file) != 1 ||
+        (bytes > 0 && fwrite(payload, 1, bytes, journal->file) != bytes)) {
+        LOG_ERROR("sim_journal: write failed; recording stopped");
+        journal->ok = false;
+    }
+}
+
+static void sim_journal_flush_run(SimJournal *journal) {
+    if (journal->run_count == 0) {
+        return;
+    }
+    SimJournalTicks ticks = {journal->run_count, journal->run_dt, 0u};
+    sim_journal_put(journal, SIM_JOURNAL_TICKS, journal->run_tick, &ticks, sizeof ticks);
+    journal->run_count = 0;
+}
+
+static void sim_journal_put_hash(SimJournal *journal, const SimState *state) {
+    uint64_t hash = sim_state_hash(state);
+    sim_journal_put(journal, SIM_JOURNAL_HASH, state->tick_index, &hash, sizeof hash);
+    // A crashed session still leaves a journal that replays up to here.
+    if (journal->ok && fflush(journal->file) != 0) {
+        journal->ok = false;
+    }
+}
+
+// Every event other than a tick ends the pending run first, so records stay
+// in tick order.
+static void sim_journal_event(SimJournal *journal,
+                              const SimState *state,
+                              SimJournalEvent event,
+                              const void *payload,
+                              size_t bytes) {
+    if (!journal || !state) {
+        return;
+    }
+    sim_journal_flush_run(journal);
+    sim_journal_put(journal, (uint32_t)event, state->tick_index, payload, bytes);
+}
+
+bool sim_journal_open(SimJournal **out_journal, const char *path, uint64_t hash_interval) {
+    if (!out_journal || !path) {
+        return false;
+    }
+    SimJournal *journal = (SimJournal *)calloc(1, sizeof(SimJournal));
+    if (!journal) {
+        LOG_ERROR("sim_journal: allocation failed");
+        return false;
+    }
+    journal->file = fopen(path, "wb");
+    if (!journal->file) {
+        LOG_ERROR("sim_journal: cannot create '%s'", path);
+        free(journal);
+        return false;
+    }
+    journal->hash_interval = hash_interval > 0 ? hash_interval : SIM_JOURNAL_DEFAULT_HASH_INTERVAL;
+    journal->ok = true;
+    SimJournalHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SIM_JOURNAL_MAGIC, sizeof(SIM_JOURNAL_MAGIC));
+    header.version = SIM_JOURNAL_VERSION;
+    header.params_bytes = (uint32_t)sizeof(Params);
+    header.hash_interval = journal->hash_interval;
+    if (fwrite(&header, sizeof header, 1, journal->file) != 1) {
+        LOG_ERROR("sim_journal: cannot write '%s'", path);
+        fclose(journal->file);
+        free(journal);
+        return false;
+    }
+    *out_journal = journal;
+    return true;
+}
+
+bool sim_journal_close(SimJournal *journal, const SimState *state) {
+    if (!journal) {
+        return true;
+    }
+    sim_journal_flush_run(journal);
+    if (state) {
+        sim_journal_put_hash(journal, state);
+    }
+    sim_journal_put(journal, SIM_JOURNAL_END, state ? state->tick_index : 0u, NULL, 0);
+    bool ok = journal->ok;
+    if (fclose(journal->file) != 0) {
+        ok = false;
+    }
+    free(journal);
+    return ok;
+}
+
+void sim_journal_note(SimJournal *journal, const SimState *state, SimJournalEvent event) {
+    sim_journal_event(journal, state, event, NULL, 0);
+}
+
+void sim_journal_note_params(SimJournal *journal, const SimState *state, SimJournalEvent event, const Params *params) {
+    if (params) {
+        sim_journal_event(journal, state, event, params, sizeof(*params));
+    }
+}
+
+void sim_journal_note_value(SimJournal *journal, const SimState *state, SimJournalEvent event, uint64_t value) {
+    sim_journal_event(journal, state, event, &value, sizeof value);
+}
+
+void sim_journal_note_option(SimJournal *journal, const SimState *state, SimJournalOption option, bool enabled) {
+    SimJournalOptionValue value = {(uint32_t)option, enabled ? 1u : 0u};
+    sim_journal_event(journal, state, SIM_JOURNAL_SET_OPTION, &value, sizeof value);
+}
+
+void sim_journal_note_spawn(SimJournal *journal, const SimState *state, BeeRole role, float x, float y) {
+    SimJournalSpawn spawn = {(uint32_t)role, x, y, 0u};
+    sim_journal_event(journal, state, SIM_JOURNAL_SPAWN, &spawn, sizeof spawn);
+}
+
+void sim_journal_note_detail_region(SimJournal *journal,
+                                    const SimState *state,
+                                    bool enabled,
+                                    float min_x,
+                                    float min_y,
+                                    float max_x,
+                                    float max_y) {
+    SimJournalDetailRegion region = {enabled ? 1u : 0u, min_x, min_y, max_x, max_y, 0u};
+    sim_journal_event(journal, state, SIM_JOURNAL_SET_DETAIL_REGION, &region, sizeof region);
+}
+
+void sim_journal_note_rewind_restart(SimJournal *journal,
+                                    const SimState *state,
+                                    uint64_t interval_ticks,
+                                    size_t max_keyframes,
+                                    size_t max_bytes) {
+    SimJournalRewind rewind = {interval_ticks, (uint64_t)max_keyframes, (uint64_t)max_bytes};
+    sim_journal_event(journal, state, SIM_JOURNAL_REWIND_RESTART, &rewind, sizeof rewind);
+}
+
+void sim_journal_note_rewind_seek(SimJournal *journal, const SimState *state, uint64_t tick, float dt_sec) {
+    SimJournalSeek seek = {tick, dt_sec, 0u};
+    sim_journal_event(journal, state, SIM_JOURNAL_REWIND_SEEK, &seek, sizeof seek);
+}
+
+void sim_journal_note_load(SimJournal *journal, const SimState *state, const char *path) {
+    if (!journal || !state || !path) {
+        return;
+    }
+    // Absolute, so a replay started from another directory finds the file.
+#ifdef _WIN32
+    char *absolute = _fullpath(NULL, path, 0);
+#else
+    char *absolute = realpath(path, NULL);
+#endif
+    const char *recorded = absolute ? absolute : path;
+    size_t bytes = strlen(recorded) + 1u;
+    if (bytes > SIM_JOURNAL_PATH_MAX) {
+        LOG_ERROR("sim_journal: checkpoint path too long");
+        free(absolute);
+        return;
+    }
+    sim_journal_event(journal, state, SIM_JOURNAL_LOAD, recorded, bytes);
+    free(absolute);
+    // Lets replay tell a checkpoint rewritten since from a divergence.
+    sim_journal_put_hash(journal, state);
+}
+
+void sim_journal_note_tick(SimJournal *journal, const SimState *state, float dt_sec) {
+    if (!journal || !state || state->tick_index == 0) {
+        return;
+    }
+    uint64_t tick = state->tick_index - 1u;
+    if (journal->run_count > 0 &&
+        (memcmp(&journal->run_dt, &dt_sec, sizeof dt_sec) != 0 || journal->run_tick + journal->run_count != tick)) {
+        sim_journal_flush_run(journal);
+    }
+    if (journal->run_count == 0) {
+        journal->run_tick = tick;
+        journal->run_dt = dt_sec;
+    }
+    journal->run_count++;
+    if (state->tick_index % journal->hash_interval == 0) {
+        sim_journal_flush_run(journal);
+        sim_journal_put_hash(journal, state);
+    }
+}
+
+typedef struct SimReplay {
+    FILE *file;
+    size_t worker_count;
+    HexWorld world;
+    bool world_live;
+    SimState *sim;
+    SimRewind *rewind;  // mirrors the recording side's ring, NULL if it had none
+    SimJournalRewind rewind_config;
+    SimReplayReport *report;
+    char loaded_path[SIM_JOURNAL_PATH_MAX];  // set from a LOAD until the HASH that follows it
+} SimReplay;
+
+static void sim_replay_diverged(SimReplay *replay, uint64_t tick) {
+    if (tick < replay->report->first_divergence_tick) {
+        replay->report->first_divergence_tick = tick;
+    }
+}
+
+static void sim_replay_release(SimReplay *replay) {
+    sim_rewind_destroy(replay->rewind);
+    replay->rewind = NULL;
+    sim_shutdown(replay->sim);
+    replay->sim = NULL;
+    if (replay->world_live) {
+        hex_world_shutdown(&replay->world);
+        replay->world_live = false;
+    }
+    memset(&replay->world, 0, sizeof(replay->world));
+}
+
+static bool sim_replay_init(SimReplay *replay, const Params *recorded) {
+    Params params = *recorded;
+    if (replay->worker_count > 0) {
+        params.sim_worker_count = replay->worker_count;
+    }
+    sim_replay_release(replay);
+    if (!hex_world_init(&replay->world, &params)) {
+        LOG_ERROR("sim_journal: replay hex world initialization failed");
+        return false;
+    }
+    replay->world_live = true;
+    if (!sim_init(&replay->sim, &params)) {
+        LOG_ERROR("sim_journal: replay simulation initialization failed");
+        return false;
+    }
+    sim_bind_hex_world(replay->sim, &replay->world);
+    return true;
+}
+
+static bool sim_replay_load(SimReplay *replay, const char *path) {
+    Params params;
+    params_init_defaults(&params);
+    if (replay->worker_count > 0) {
+        params.sim_worker_count = replay->worker_count;
+    }
+    sim_replay_release(replay);
+    if (!sim_snapshot_load(&replay->sim, &replay->world, &params, path)) {
+        LOG_ERROR("sim_journal: replay cannot load checkpoint '%s'", path);
+        return false;
+    }
+    replay->world_live = true;
+    return true;
+}
+
+static bool sim_replay_reinit(SimReplay *replay, const Params *recorded) {
+    Params params = *recorded;
+    if (replay->worker_count > 0) {
+        params.sim_worker_count = replay->worker_count;
+    }
+    SimState *fresh = NULL;
+    if (!sim_init(&fresh, &params)) {
+        LOG_ERROR("sim_journal: replay reinit failed");
+        return false;
+    }
+    sim_shutdown(replay->sim);
+    replay->sim = fresh;
+    sim_bind_hex_world(replay->sim, &replay->world);
+    return true;
+}
+
+// Keeps the replay's ring in step with the recorded one. A seek the recording
+// side could not make fails here too and leaves the state as it was. Returns
+// false on a malformed payload.
+static bool sim_replay_rewind(SimReplay *replay, SimJournalEvent event, const void *payload, size_t bytes) {
+    if (event == SIM_JOURNAL_REWIND_RESTART) {
+        SimJournalRewind config;
+        if (bytes != sizeof config) {
+            return false;
+        }
+        memcpy(&config, payload, sizeof config);
+        if (!replay->rewind || memcmp(&config, &replay->rewind_config, sizeof config) != 0) {
+            sim_rewind_destroy(replay->rewind);
+            replay->rewind = NULL;
+            if (!sim_rewind_create(&replay->rewind, config.interval_ticks, (size_t)config.max_keyframes,
+                                   (size_t)config.max_bytes)) {
+                LOG_ERROR("sim_journal: replay cannot create the rewind ring; seeks will fail");
+                return true;
+            }
+            replay->rewind_config = config;
+        }
+        sim_rewind_clear(replay->rewind);
+        sim_rewind_capture(replay->rewind, replay->sim);
+        return true;
+    }
+    SimJournalSeek seek;
+    if (bytes != sizeof seek) {
+        return false;
+    }
+    memcpy(&seek, payload, sizeof seek);
+    size_t worker_count = replay->worker_count > 0 ? replay->worker_count : replay->sim->worker_count;
+    if (!sim_rewind_seek(replay->rewind, &replay->sim, &replay->world, seek.tick, seek.dt_sec, worker_count)) {
+        LOG_WARN("sim_journal: replay cannot rewind to tick %llu", (unsigned long long)seek.tick);
+    }
+    return true;
+}
+
+// Applies one record to the replayed state. Returns false on a malformed
+// record or a failure that makes the rest of the journal meaningless.
+static bool sim_replay_apply(SimReplay *replay, const SimJournalRecord *record, const void *payload) {
+    SimJournalEvent event = (SimJournalEvent)record->event;
+    size_t bytes = record->payload_bytes;
+    bool starts_state = event == SIM_JOURNAL_INIT || event == SIM_JOURNAL_LOAD;
+    bool verifies_load = replay->loaded_path[0] != '\0' && event == SIM_JOURNAL_HASH;
+    if (event != SIM_JOURNAL_HASH) {
+        replay->loaded_path[0] = '\0';
+    }
+    if (!starts_state) {
+        if (!replay->sim) {
+            LOG_ERROR("sim_journal: event %u before INIT or LOAD", record->event);
+            return false;
+        }
+        if (event != SIM_JOURNAL_REINIT && record->tick != replay->sim->tick_index) {
+            sim_replay_diverged(replay, replay->sim->tick_index);
+        }
+    }
+
+    switch (event) {
+    case SIM_JOURNAL_INIT:
+    case SIM_JOURNAL_REINIT:
+    case SIM_JOURNAL_HEX_REBUILD:
+    case SIM_JOURNAL_APPLY_PARAMS: {
+        if (bytes != sizeof(Params)) {
+            break;
+        }
+        Params params;
+        memcpy(&params, payload, sizeof params);
+        if (event == SIM_JOURNAL_INIT) {
+            return sim_replay_init(replay, &params);
+        }
+        if (event == SIM_JOURNAL_REINIT) {
+            return sim_replay_reinit(replay, &params);
+        }
+        if (event == SIM_JOURNAL_HEX_REBUILD) {
+            if (hex_world_rebuild(&replay->world, &params)) {
+                sim_bind_hex_world(replay->sim, &replay->world);
+            }
+            return true;
+        }
+        sim_apply_runtime_params(replay->sim, &params);
+        return true;
+    }
+    case SIM_JOURNAL_LOAD:
+        if (bytes == 0 || bytes > SIM_JOURNAL_PATH_MAX || ((const char *)payload)[bytes - 1u] != '\0') {
+            break;
+        }
+        if (!sim_replay_load(replay, (const char *)payload)) {
+            return false;
+        }
+        memcpy(replay->loaded_path, payload, bytes);
+        return true;
+    case SIM_JOURNAL_TICKS: {
+        if (bytes != sizeof(SimJournalTicks)) {
+            break;
+        }
+        SimJournalTicks ticks;
+        memcpy(&ticks, payload, sizeof ticks);
+        for (uint64_t t = 0; t < ticks.count; ++t) {
+            sim_tick(replay->sim, ticks.dt_sec);
+            sim_rewind_capture(replay->rewind, replay->sim);
+        }
+        replay->report->ticks += ticks.count;
+        return true;
+    }
+    case SIM_JOURNAL_HASH: {
+        if (bytes != sizeof(uint64_t)) {
+            break;
+        }
+        uint64_t expected;
+        memcpy(&expected, payload, sizeof expected);
+        replay->report->hashes_checked++;
+        if (verifies_load) {
+            if (sim_state_hash(replay->sim) != expected) {
+                replay->report->hashes_mismatched++;
+                sim_replay_diverged(replay, record->tick);
+                LOG_ERROR("sim_journal: checkpoint '%s' changed since it was recorded", replay->loaded_path);
+                return false;
+            }
+            replay->loaded_path[0] = '\0';
+            return true;
+        }
+        if (sim_state_hash(replay->sim) != expected) {
+            replay->report->hashes_mismatched++;
+            sim_replay_diverged(replay, record->tick);
+            LOG_WARN("sim_journal: replay diverged at tick %llu", (unsigned long long)record->tick);
+        }
+        return true;
+    }
+    case SIM_JOURNAL_SET_POPULATION:
+    case SIM_JOURNAL_RESET:
+    case SIM_JOURNAL_DESPAWN: {
+        if (bytes != sizeof(uint64_t)) {
+            break;
+        }
+        uint64_t value;
+        memcpy(&value, payload, sizeof value);
+        if (event == SIM_JOURNAL_SET_POPULATION) {
+            sim_set_population(replay->sim, (size_t)value);
+        } else if (event == SIM_JOURNAL_RESET) {
+            sim_reset(replay->sim, value);
+        } else {
+            sim_despawn_bee(replay->sim, (size_t)value);
+        }
+        return true;
+    }
+    case SIM_JOURNAL_SET_OPTION: {
+        if (bytes != sizeof(SimJournalOptionValue)) {
+            break;
+        }
+        SimJournalOptionValue value;
+        memcpy(&value, payload, sizeof value);
+        bool enabled = value.enabled != 0;
+        if (value.option == SIM_JOURNAL_OPTION_MODE_BUCKETS) {
+            sim_set_mode_buckets(replay->sim, enabled);
+        } else if (value.option == SIM_JOURNAL_OPTION_HIBERNATION) {
+            sim_set_hibernation(replay->sim, enabled);
+        } else if (value.option == SIM_JOURNAL_OPTION_LAZY_RECHARGE) {
+            sim_set_lazy_recharge(replay->sim, enabled);
+        } else if (value.option == SIM_JOURNAL_OPTION_MULTI_RATE) {
+            sim_set_multi_rate(replay->sim, enabled);
+        } else if (value.option == SIM_JOURNAL_OPTION_CASTE_POOLS) {
+            sim_set_caste_pools(replay->sim, enabled);
+        } else {
+            break;
+        }
+        return true;
+    }
+    case SIM_JOURNAL_SPAWN: {
+        if (bytes != sizeof(SimJournalSpawn)) {
+            break;
+        }
+        SimJournalSpawn spawn;
+        memcpy(&spawn, payload, sizeof spawn);
+        sim_spawn_bee(replay->sim, (BeeRole)spawn.role, spawn.x, spawn.y);
+        return true;
+    }
+    case SIM_JOURNAL_SET_DETAIL_REGION: {
+        if (bytes != sizeof(SimJournalDetailRegion)) {
+            break;
+        }
+        SimJournalDetailRegion region;
+        memcpy(&region, payload, sizeof region);
+        if (region.enabled) {
+            sim_set_detail_region(replay->sim, region.min_x, region.min_y, region.max_x, region.max_y);
+        } else {
+            sim_clear_detail_region(replay->sim);
+        }
+        return true;
+    }
+    case SIM_JOURNAL_COMPACT:
+        sim_compact(replay->sim);
+        return true;
+    case SIM_JOURNAL_UNPOOL:
+        sim_unpool_bee(replay->sim);
+        return true;
+    case SIM_JOURNAL_REWIND_RESTART:
+    case SIM_JOURNAL_REWIND_SEEK:
+        if (sim_replay_rewind(replay, event, payload, bytes)) {
+            return true;
+        }
+        break;
+    case SIM_JOURNAL_PAUSE:
+    case SIM_JOURNAL_RESUME:
+    case SIM_JOURNAL_STEP:
+    case SIM_JOURNAL_END:
+        return true;
+    }
+    LOG_ERROR("sim_journal: malformed record (event %u, %zu bytes)", record->event, bytes);
+    return false;
+}
+
+bool sim_journal_replay(const char *path, size_t worker_count, SimReplayReport *out_report) {
+    if (!path || !out_report) {
+        return false;
+    }
+    memset(out_report, 0, sizeof(*out_report));
+    out_report->first_divergence_tick = UINT64_MAX;
+
+    SimReplay replay;
+    memset(&replay, 0, sizeof(replay));
+    replay.worker_count = worker_count;
+    replay.report = out_report;
+    replay.file = fopen(path, "rb");
+    if (!replay.file) {
+        LOG_ERROR("sim_journal: cannot open '%s'", path);
+        return false;
+    }
+    SimJournalHeader header;
+    if (fread(&header, sizeof header, 1, replay.file) != 1 ||
+        memcmp(header.magic, SIM_JOURNAL_MAGIC, sizeof(SIM_JOURNAL_MAGIC)) != 0 ||
+        header.version != SIM_JOURNAL_VERSION || header.params_bytes != sizeof(Params)) {
+        LOG_ERROR("sim_journal: '%s' is not a compatible journal", path);
+        fclose(replay.file);
+        return false;
+    }
+
+    // Params is the largest fixed payload; paths are bounded separately.
+    char payload[SIM_JOURNAL_PATH_MAX > sizeof(Params) ? SIM_JOURNAL_PATH_MAX : sizeof(Params)];
+    bool ok = true;
+    bool ended = false;
+    SimJournalRecord record;
+    while (ok && !ended && fread(&record, sizeof record, 1, replay.file) == 1) {
+        if (record.payload_bytes > sizeof payload ||
+            (record.payload_bytes > 0 && fread(payload, 1, record.payload_bytes, replay.file) != record.payload_bytes)) {
+            LOG_ERROR("sim_journal: truncated record in '%s'", path);
+            ok = false;
+            break;
+        }
+        ok = sim_replay_apply(&replay, &record, payload);
+        out_report->events++;
+        ended = record.event == SIM_JOURNAL_END;
+    }
+    if (ok && !ended) {
+        LOG_WARN("sim_journal: '%s' has no END record; replayed up to the last complete one", path);
+    }
+    if (replay.sim) {
+        out_report->final_hash = sim_state_hash(replay.sim);
+    }
+    sim_replay_release(&replay);
+    fclose(replay.file);
+    return ok;
+}
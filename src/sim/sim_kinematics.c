@@ -0,0 +1,349 @@
+#include "sim_kinematics.h"
+
+#include <math.h>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define SIM_KINEMATICS_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(SIM_KINEMATICS_X86) && (defined(__GNUC__) || defined(__clang__))
+#define SIM_TARGET_SSE2 __attribute__((target("sse2")))
+#define SIM_TARGET_AVX2 __attribute__((target("avx2")))
+#else
+#define SIM_TARGET_SSE2
+#define SIM_TARGET_AVX2
+#endif
+
+static uint64_t sim_kinematics_scalar(const SimKinematicsParams *params, const SimKinematicsLanes *lanes, size_t begin) {
+    const float dt_sec = params->dt_sec;
+    const float max_delta = params->max_delta_v;
+    const float max_speed = params->max_speed;
+    const float world_w = params->world_w;
+    const float world_h = params->world_h;
+    const float bounce_margin = params->bounce_margin;
+    uint64_t bounces = 0;
+
+    for (size_t j = begin; j < lanes->count; ++j) {
+        float vx = lanes->vx[j];
+        float vy = lanes->vy[j];
+        if (lanes->damp[j] > 0.0f) {
+            vx *= 0.65f;
+            vy *= 0.65f;
+            if (fabsf(vx) < 1e-3f) vx = 0.0f;
+            if (fabsf(vy) < 1e-3f) vy = 0.0f;
+        }
+
+        float dvx = lanes->desired_vx[j] - vx;
+        float dvy = lanes->desired_vy[j] - vy;
+        float delta_v = sqrtf(dvx * dvx + dvy * dvy);
+        if (delta_v > max_delta && delta_v > 1e-6f) {
+            float scale = max_delta / delta_v;
+            dvx *= scale;
+            dvy *= scale;
+        }
+        vx += dvx;
+        vy += dvy;
+
+        float speed = sqrtf(vx * vx + vy * vy);
+        if (speed > max_speed && speed > 1e-6f) {
+            float scale = max_speed / speed;
+            vx *= scale;
+            vy *= scale;
+        }
+
+        float new_x = lanes->x[j] + vx * dt_sec;
+        float new_y = lanes->y[j] + vy * dt_sec;
+        float radius = lanes->radius[j];
+
+        float min_x = radius + bounce_margin;
+        float max_x = world_w - radius - bounce_margin;
+        if (min_x > max_x) {
+            float mid = world_w * 0.5f;
+            min_x = max_x = mid;
+        }
+        if (new_x < min_x) {
+            new_x = min_x;
+            vx = -vx * 0.3f;
+            ++bounces;
+        } else if (new_x > max_x) {
+            new_x = max_x;
+            vx = -vx * 0.3f;
+            ++bounces;
+        }
+
+        float min_y = radius + bounce_margin;
+        float max_y = world_h - radius - bounce_margin;
+        if (min_y > max_y) {
+            float mid = world_h * 0.5f;
+            min_y = max_y = mid;
+        }
+        if (new_y < min_y) {
+            new_y = min_y;
+            vy = -vy * 0.3f;
+            ++bounces;
+        } else if (new_y > max_y) {
+            new_y = max_y;
+            vy = -vy * 0.3f;
+            ++bounces;
+        }
+
+        lanes->vx[j] = vx;
+        lanes->vy[j] = vy;
+        lanes->new_x[j] = new_x;
+        lanes->new_y[j] = new_y;
+    }
+    return bounces;
+}
+
+#if defined(SIM_KINEMATICS_X86)
+
+static unsigned sim_popcount4(int mask) {
+    unsigned m = (unsigned)mask;
+    m = m - ((m >> 1) & 0x5u);
+    return (m & 0x3u) + ((m >> 2) & 0x3u);
+}
+
+static unsigned sim_popcount8(int mask) {
+    return sim_popcount4(mask & 0xF) + sim_popcount4((mask >> 4) & 0xF);
+}
+
+SIM_TARGET_SSE2
+static inline __m128 sim_select4(__m128 mask, __m128 if_true, __m128 if_false) {
+    return _mm_or_ps(_mm_and_ps(mask, if_true), _mm_andnot_ps(mask, if_false));
+}
+
+SIM_TARGET_SSE2
+static uint64_t sim_kinematics_sse2(const SimKinematicsParams *params, const SimKinematicsLanes *lanes, size_t *out_done) {
+    const __m128 dt = _mm_set1_ps(params->dt_sec);
+    const __m128 max_delta = _mm_set1_ps(params->max_delta_v);
+    const __m128 max_speed = _mm_set1_ps(params->max_speed);
+    const __m128 world_w = _mm_set1_ps(params->world_w);
+    const __m128 world_h = _mm_set1_ps(params->world_h);
+    const __m128 mid_x = _mm_set1_ps(params->world_w * 0.5f);
+    const __m128 mid_y = _mm_set1_ps(params->world_h * 0.5f);
+    const __m128 margin = _mm_set1_ps(params->bounce_margin);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 damping = _mm_set1_ps(0.65f);
+    const __m128 snap = _mm_set1_ps(1e-3f);
+    const __m128 tiny = _mm_set1_ps(1e-6f);
+    const __m128 restitution = _mm_set1_ps(0.3f);
+    const __m128 sign = _mm_set1_ps(-0.0f);
+    uint64_t bounces = 0;
+
+    size_t j = 0;
+    for (; j + 4 <= lanes->count; j += 4) {
+        __m128 vx = _mm_loadu_ps(lanes->vx + j);
+        __m128 vy = _mm_loadu_ps(lanes->vy + j);
+        __m128 damp = _mm_cmpgt_ps(_mm_loadu_ps(lanes->damp + j), zero);
+        __m128 dvx0 = _mm_mul_ps(vx, damping);
+        __m128 dvy0 = _mm_mul_ps(vy, damping);
+        dvx0 = _mm_andnot_ps(_mm_cmplt_ps(_mm_andnot_ps(sign, dvx0), snap), dvx0);
+        dvy0 = _mm_andnot_ps(_mm_cmplt_ps(_mm_andnot_ps(sign, dvy0), snap), dvy0);
+        vx = sim_select4(damp, dvx0, vx);
+        vy = sim_select4(damp, dvy0, vy);
+
+        __m128 dvx = _mm_sub_ps(_mm_loadu_ps(lanes->desired_vx + j), vx);
+        __m128 dvy = _mm_sub_ps(_mm_loadu_ps(lanes->desired_vy + j), vy);
+        __m128 delta_v = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(dvx, dvx), _mm_mul_ps(dvy, dvy)));
+        __m128 limit = _mm_and_ps(_mm_cmpgt_ps(delta_v, max_delta), _mm_cmpgt_ps(delta_v, tiny));
+        __m128 scale = _mm_div_ps(max_delta, delta_v);
+        dvx = sim_select4(limit, _mm_mul_ps(dvx, scale), dvx);
+        dvy = sim_select4(limit, _mm_mul_ps(dvy, scale), dvy);
+        vx = _mm_add_ps(vx, dvx);
+        vy = _mm_add_ps(vy, dvy);
+
+        __m128 speed = _mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(vx, vx), _mm_mul_ps(vy, vy)));
+        __m128 clamp = _mm_and_ps(_mm_cmpgt_ps(speed, max_speed), _mm_cmpgt_ps(speed, tiny));
+        scale = _mm_div_ps(max_speed, speed);
+        vx = sim_select4(clamp, _mm_mul_ps(vx, scale), vx);
+        vy = sim_select4(clamp, _mm_mul_ps(vy, scale), vy);
+
+        __m128 new_x = _mm_add_ps(_mm_loadu_ps(lanes->x + j), _mm_mul_ps(vx, dt));
+        __m128 new_y = _mm_add_ps(_mm_loadu_ps(lanes->y + j), _mm_mul_ps(vy, dt));
+        __m128 radius = _mm_loadu_ps(lanes->radius + j);
+
+        __m128 min_x = _mm_add_ps(radius, margin);
+        __m128 max_x = _mm_sub_ps(_mm_sub_ps(world_w, radius), margin);
+        __m128 degenerate = _mm_cmpgt_ps(min_x, max_x);
+        min_x = sim_select4(degenerate, mid_x, min_x);
+        max_x = sim_select4(degenerate, mid_x, max_x);
+        __m128 below = _mm_cmplt_ps(new_x, min_x);
+        __m128 above = _mm_andnot_ps(below, _mm_cmpgt_ps(new_x, max_x));
+        __m128 hit_x = _mm_or_ps(below, above);
+        new_x = sim_select4(below, min_x, sim_select4(above, max_x, new_x));
+        vx = sim_select4(hit_x, _mm_mul_ps(_mm_xor_ps(vx, sign), restitution), vx);
+
+        __m128 min_y = _mm_add_ps(radius, margin);
+        __m128 max_y = _mm_sub_ps(_mm_sub_ps(world_h, radius), margin);
+        degenerate = _mm_cmpgt_ps(min_y, max_y);
+        min_y = sim_select4(degenerate, mid_y, min_y);
+        max_y = sim_select4(degenerate, mid_y, max_y);
+        below = _mm_cmplt_ps(new_y, min_y);
+        above = _mm_andnot_ps(below, _mm_cmpgt_ps(new_y, max_y));
+        __m128 hit_y = _mm_or_ps(below, above);
+        new_y = sim_select4(below, min_y, sim_select4(above, max_y, new_y));
+        vy = sim_select4(hit_y, _mm_mul_ps(_mm_xor_ps(vy, sign), restitution), vy);
+
+        bounces += sim_popcount4(_mm_movemask_ps(hit_x)) + sim_popcount4(_mm_movemask_ps(hit_y));
+        _mm_storeu_ps(lanes->vx + j, vx);
+        _mm_storeu_ps(lanes->vy + j, vy);
+        _mm_storeu_ps(lanes->new_x + j, new_x);
+        _mm_storeu_ps(lanes->new_y + j, new_y);
+    }
+    *out_done = j;
+    return bounces;
+}
+
+SIM_TARGET_AVX2
+static inline __m256 sim_select8(__m256 mask, __m256 if_true, __m256 if_false) {
+    return _mm256_blendv_ps(if_false, if_true, mask);
+}
+
+SIM_TARGET_AVX2
+static uint64_t sim_kinematics_avx2(const SimKinematicsParams *params, const SimKinematicsLanes *lanes, size_t *out_done) {
+    const __m256 dt = _mm256_set1_ps(params->dt_sec);
+    const __m256 max_delta = _mm256_set1_ps(params->max_delta_v);
+    const __m256 max_speed = _mm256_set1_ps(params->max_speed);
+    const __m256 world_w = _mm256_set1_ps(params->world_w);
+    const __m256 world_h = _mm256_set1_ps(params->world_h);
+    const __m256 mid_x = _mm256_set1_ps(params->world_w * 0.5f);
+    const __m256 mid_y = _mm256_set1_ps(params->world_h * 0.5f);
+    const __m256 margin = _mm256_set1_ps(params->bounce_margin);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 damping = _mm256_set1_ps(0.65f);
+    const __m256 snap = _mm256_set1_ps(1e-3f);
+    const __m256 tiny = _mm256_set1_ps(1e-6f);
+    const __m256 restitution = _mm256_set1_ps(0.3f);
+    const __m256 sign = _mm256_set1_ps(-0.0f);
+    uint64_t bounces = 0;
+
+    size_t j = 0;
+    for (; j + 8 <= lanes->count; j += 8) {
+        __m256 vx = _mm256_loadu_ps(lanes->vx + j);
+        __m256 vy = _mm256_loadu_ps(lanes->vy + j);
+        __m256 damp = _mm256_cmp_ps(_mm256_loadu_ps(lanes->damp + j), zero, _CMP_GT_OQ);
+        __m256 dvx0 = _mm256_mul_ps(vx, damping);
+        __m256 dvy0 = _mm256_mul_ps(vy, damping);
+        dvx0 = _mm256_andnot_ps(_mm256_cmp_ps(_mm256_andnot_ps(sign, dvx0), snap, _CMP_LT_OQ), dvx0);
+        dvy0 = _mm256_andnot_ps(_mm256_cmp_ps(_mm256_andnot_ps(sign, dvy0), snap, _CMP_LT_OQ), dvy0);
+        vx = sim_select8(damp, dvx0, vx);
+        vy = sim_select8(damp, dvy0, vy);
+
+        __m256 dvx = _mm256_sub_ps(_mm256_loadu_ps(lanes->desired_vx + j), vx);
+        __m256 dvy = _mm256_sub_ps(_mm256_loadu_ps(lanes->desired_vy + j), vy);
+        __m256 delta_v = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(dvx, dvx), _mm256_mul_ps(dvy, dvy)));
+        __m256 limit = _mm256_and_ps(_mm256_cmp_ps(delta_v, max_delta, _CMP_GT_OQ),
+                                     _mm256_cmp_ps(delta_v, tiny, _CMP_GT_OQ));
+        __m256 scale = _mm256_div_ps(max_delta, delta_v);
+        dvx = sim_select8(limit, _mm256_mul_ps(dvx, scale), dvx);
+        dvy = sim_select8(limit, _mm256_mul_ps(dvy, scale), dvy);
+        vx = _mm256_add_ps(vx, dvx);
+        vy = _mm256_add_ps(vy, dvy);
+
+        __m256 speed = _mm256_sqrt_ps(_mm256_add_ps(_mm256_mul_ps(vx, vx), _mm256_mul_ps(vy, vy)));
+        __m256 clamp = _mm256_and_ps(_mm256_cmp_ps(speed, max_speed, _CMP_GT_OQ),
+                                     _mm256_cmp_ps(speed, tiny, _CMP_GT_OQ));
+        scale = _mm256_div_ps(max_speed, speed);
+        vx = sim_select8(clamp, _mm256_mul_ps(vx, scale), vx);
+        vy = sim_select8(clamp, _mm256_mul_ps(vy, scale), vy);
+
+        __m256 new_x = _mm256_add_ps(_mm256_loadu_ps(lanes->x + j), _mm256_mul_ps(vx, dt));
+        __m256 new_y = _mm256_add_ps(_mm256_loadu_ps(lanes->y + j), _mm256_mul_ps(vy, dt));
+        __m256 radius = _mm256_loadu_ps(lanes->radius + j);
+
+        __m256 min_x = _mm256_add_ps(radius, margin);
+        __m256 max_x = _mm256_sub_ps(_mm256_sub_ps(world_w, radius), margin);
+        __m256 degenerate = _mm256_cmp_ps(min_x, max_x, _CMP_GT_OQ);
+        min_x = sim_select8(degenerate, mid_x, min_x);
+        max_x = sim_select8(degenerate, mid_x, max_x);
+        __m256 below = _mm256_cmp_ps(new_x, min_x, _CMP_LT_OQ);
+        __m256 above = _mm256_andnot_ps(below, _mm256_cmp_ps(new_x, max_x, _CMP_GT_OQ));
+        __m256 hit_x = _mm256_or_ps(below, above);
+        new_x = sim_select8(below, min_x, sim_select8(above, max_x, new_x));
+        vx = sim_select8(hit_x, _mm256_mul_ps(_mm256_xor_ps(vx, sign), restitution), vx);
+
+        __m256 min_y = _mm256_add_ps(radius, margin);
+        __m256 max_y = _mm256_sub_ps(_mm256_sub_ps(world_h, radius), margin);
+        degenerate = _mm256_cmp_ps(min_y, max_y, _CMP_GT_OQ);
+        min_y = sim_select8(degenerate, mid_y, min_y);
+        max_y = sim_select8(degenerate, mid_y, max_y);
+        below = _mm256_cmp_ps(new_y, min_y, _CMP_LT_OQ);
+        above = _mm256_andnot_ps(below, _mm256_cmp_ps(new_y, max_y, _CMP_GT_OQ));
+        __m256 hit_y = _mm256_or_ps(below, above);
+        new_y = sim_select8(below, min_y, sim_select8(above, max_y, new_y));
+        vy = sim_select8(hit_y, _mm256_mul_ps(_mm256_xor_ps(vy, sign), restitution), vy);
+
+        bounces += sim_popcount8(_mm256_movemask_ps(hit_x)) + sim_popcount8(_mm256_movemask_ps(hit_y));
+        _mm256_storeu_ps(lanes->vx + j, vx);
+        _mm256_storeu_ps(lanes->vy + j, vy);
+        _mm256_storeu_ps(lanes->new_x + j, new_x);
+        _mm256_storeu_ps(lanes->new_y + j, new_y);
+    }
+    *out_done = j;
+    return bounces;
+}
+
+static bool sim_cpu_has_avx2(void) {
+#if defined(_MSC_VER)
+    int info[4] = {0};
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    __cpuid(info, 1);
+    bool osxsave = (info[2] & (1 << 27)) != 0;
+    bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6) {
+        return false;
+    }
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2") != 0;
+#endif
+}
+
+#endif  // SIM_KINEMATICS_X86
+
+SimKinematicsKernel sim_kinematics_resolve(SimKinematicsKernel requested) {
+#if defined(SIM_KINEMATICS_X86)
+    bool has_avx2 = sim_cpu_has_avx2();
+    switch (requested) {
+        case SIM_KINEMATICS_AUTO: return has_avx2 ? SIM_KINEMATICS_AVX2 : SIM_KINEMATICS_SSE2;
+        case SIM_KINEMATICS_AVX2: return has_avx2 ? SIM_KINEMATICS_AVX2 : SIM_KINEMATICS_SCALAR;
+        case SIM_KINEMATICS_SSE2: return SIM_KINEMATICS_SSE2;
+        case SIM_KINEMATICS_SCALAR:
+        default:
+            return SIM_KINEMATICS_SCALAR;
+    }
+#else
+    (void)requested;
+    return SIM_KINEMATICS_SCALAR;
+#endif
+}
+
+uint64_t sim_kinematics_run(SimKinematicsKernel kernel,
+                            const SimKinematicsParams *params,
+                            const SimKinematicsLanes *lanes) {
+    if (!params || !lanes || lanes->count == 0) {
+        return 0;
+    }
+    uint64_t bounces = 0;
+    size_t done = 0;
+#if defined(SIM_KINEMATICS_X86)
+    if (kernel == SIM_KINEMATICS_AVX2) {
+        bounces += sim_kinematics_avx2(params, lanes, &done);
+    } else if (kernel == SIM_KINEMATICS_SSE2) {
+        bounces += sim_kinematics_sse2(params, lanes, &done);
+    }
+#else
+    (void)kernel;
+#endif
+    bounces += sim_kinematics_scalar(params, lanes, done);
+    return bounces;
+}
@@ -0,0 +1,47 @@
+#ifndef SIM_SIM_KINEMATICS_H
+#define SIM_SIM_KINEMATICS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "sim.h"
+
+// Arithmetic core of the bee tick: damping, acceleration limit, max-speed
+// clamp, integration and wall bounce over SoA lanes. Every implementation
+// performs the same IEEE operations in the same order, so SSE2/AVX2 results
+// are bit-identical to the scalar reference.
+
+typedef struct SimKinematicsParams {
+    float dt_sec;
+    float max_delta_v;  // seek_accel * dt_sec
+    float max_speed;
+    float world_w;
+    float world_h;
+    float bounce_margin;
+} SimKinematicsParams;
+
+typedef struct SimKinematicsLanes {
+    const float *x;           // current position
+    const float *y;
+    const float *radius;
+    const float *desired_vx;  // steering target velocity (0 when not flying)
+    const float *desired_vy;
+    const float *damp;        // 1.0f: apply ground damping before steering
+    float *vx;                // in/out
+    float *vy;
+    float *new_x;             // out: integrated, wall-clamped position
+    float *new_y;
+    size_t count;
+} SimKinematicsLanes;
+
+SimKinematicsKernel sim_kinematics_resolve(SimKinematicsKernel requested);
+// Maps AUTO to the widest kernel the CPU supports; returns SCALAR for
+// explicit requests the CPU cannot run.
+
+uint64_t sim_kinematics_run(SimKinematicsKernel kernel,
+                            const SimKinematicsParams *params,
+                            const SimKinematicsLanes *lanes);
+// Runs the kernel (which must already be resolved) and returns the number of
+// wall bounces.
+
+#endif  // SIM_SIM_KINEMATICS_H
@@ -0,0 +1,293 @@
+#include "sim_rewind.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "sim_internal.h"
+#include "util/log.h"
+
+// Column data shared by every keyframe in which it did not change.
+typedef struct SimRewindBlob {
+    size_t refs;
+    size_t bytes;
+    uint8_t data[];
+} SimRewindBlob;
+
+typedef struct SimRewindColumn {
+    char name[SNAPSHOT_NAME_MAX];
+    size_t elem_size;
+    size_t count;
+    SimRewindBlob *blob;  // NULL for an empty column
+} SimRewindColumn;
+
+typedef struct SimRewindKeyframe {
+    uint64_t tick;
+    SimRewindColumn *columns;
+    size_t column_count;
+} SimRewindKeyframe;
+
+struct SimRewind {
+    uint64_t interval_ticks;
+    size_t max_keyframes;
+    size_t max_bytes;
+    SimRewindKeyframe *ring;  // max_keyframes slots, oldest at head
+    size_t head;
+    size_t count;
+    size_t bytes;  // unique blob bytes
+};
+
+static SimRewindKeyframe *sim_rewind_at(SimRewind *rewind, size_t age) {
+    return &rewind->ring[(rewind->head + age) % rewind->max_keyframes];
+}
+
+static void sim_rewind_release_blob(SimRewind *rewind, SimRewindBlob *blob) {
+    if (blob && --blob->refs == 0) {
+        rewind->bytes -= blob->bytes;
+        free(blob);
+    }
+}
+
+static void sim_rewind_release_keyframe(SimRewind *rewind, SimRewindKeyframe *keyframe) {
+    for (size_t c = 0; c < keyframe->column_count; ++c) {
+        sim_rewind_release_blob(rewind, keyframe->columns[c].blob);
+    }
+    free(keyframe->columns);
+    memset(keyframe, 0, sizeof(*keyframe));
+}
+
+static void sim_rewind_drop_oldest(SimRewind *rewind) {
+    sim_rewind_release_keyframe(rewind, sim_rewind_at(rewind, 0));
+    rewind->head = (rewind->head + 1u) % rewind->max_keyframes;
+    rewind->count--;
+}
+
+static void sim_rewind_drop_newest(SimRewind *rewind) {
+    sim_rewind_release_keyframe(rewind, sim_rewind_at(rewind, rewind->count - 1u));
+    rewind->count--;
+}
+
+bool sim_rewind_create(SimRewind **out_rewind, uint64_t interval_ticks, size_t max_keyframes, size_t max_bytes) {
+    if (!out_rewind || interval_ticks == 0 || max_keyframes == 0) {
+        return false;
+    }
+    SimRewind *rewind = (SimRewind *)calloc(1, sizeof(SimRewind));
+    SimRewindKeyframe *ring = (SimRewindKeyframe *)calloc(max_keyframes, sizeof(SimRewindKeyframe));
+    if (!rewind || !ring) {
+        LOG_ERROR("sim_rewind: allocation failed");
+        free(rewind);
+        free(ring);
+        return false;
+    }
+    rewind->interval_ticks = interval_ticks;
+    rewind->max_keyframes = max_keyframes;
+    rewind->max_bytes = max_bytes;
+    rewind->ring = ring;
+    *out_rewind = rewind;
+    return true;
+}
+
+void sim_rewind_destroy(SimRewind *rewind) {
+    if (!rewind) {
+        return;
+    }
+    sim_rewind_clear(rewind);
+    free(rewind->ring);
+    free(rewind);
+}
+
+void sim_rewind_clear(SimRewind *rewind) {
+    if (!rewind) {
+        return;
+    }
+    while (rewind->count > 0) {
+        sim_rewind_drop_oldest(rewind);
+    }
+    rewind->head = 0;
+}
+
+// The previous keyframe's column of the same name; columns are normally
+// written in the same order, so the same index is tried first.
+static const SimRewindColumn *sim_rewind_find_column(const SimRewindKeyframe *keyframe, size_t index, const char *name) {
+    if (!keyframe) {
+        return NULL;
+    }
+    if (index < keyframe->column_count && strcmp(keyframe->columns[index].name, name) == 0) {
+        return &keyframe->columns[index];
+    }
+    for (size_t c = 0; c < keyframe->column_count; ++c) {
+        if (strcmp(keyframe->columns[c].name, name) == 0) {
+            return &keyframe->columns[c];
+        }
+    }
+    return NULL;
+}
+
+// Copies the reader's columns into keyframe, sharing those unchanged since
+// previous. Returns false on allocation failure with the keyframe released.
+static bool sim_rewind_fill(SimRewind *rewind,
+                            SimRewindKeyframe *keyframe,
+                            const SimRewindKeyframe *previous,
+                            const SnapshotReader *reader) {
+    size_t column_count = snapshot_column_count(reader);
+    keyframe->columns = (SimRewindColumn *)calloc(column_count ? column_count : 1u, sizeof(SimRewindColumn));
+    if (!keyframe->columns) {
+        return false;
+    }
+    for (size_t c = 0; c < column_count; ++c) {
+        const char *name = NULL;
+        size_t elem_size = 0;
+        size_t count = 0;
+        const void *data = snapshot_column_at(reader, c, &name, &elem_size, &count);
+        SimRewindColumn *column = &keyframe->columns[keyframe->column_count++];
+        memcpy(column->name, name, SNAPSHOT_NAME_MAX);
+        column->elem_size = elem_size;
+        column->count = count;
+        size_t bytes = elem_size * count;
+        if (bytes == 0) {
+            continue;
+        }
+        const SimRewindColumn *prior = sim_rewind_find_column(previous, c, name);
+        if (prior && prior->blob && prior->elem_size == elem_size && prior->count == count &&
+            memcmp(prior->blob->data, data, bytes) == 0) {
+            column->blob = prior->blob;
+            column->blob->refs++;
+            continue;
+        }
+        SimRewindBlob *blob = (SimRewindBlob *)malloc(sizeof(SimRewindBlob) + bytes);
+        if (!blob) {
+            sim_rewind_release_keyframe(rewind, keyframe);
+            return false;
+        }
+        blob->refs = 1;
+        blob->bytes = bytes;
+        memcpy(blob->data, data, bytes);
+        rewind->bytes += bytes;
+        column->blob = blob;
+    }
+    return true;
+}
+
+bool sim_rewind_capture(SimRewind *rewind, const SimState *state) {
+    if (!rewind || !state || !state->hex_world) {
+        return false;
+    }
+    const SimRewindKeyframe *previous = NULL;
+    if (rewind->count > 0) {
+        previous = sim_rewind_at(rewind, rewind->count - 1u);
+        if (state->tick_index % rewind->interval_ticks != 0 || state->tick_index <= previous->tick) {
+            return true;
+        }
+    }
+
+    SnapshotWriter *writer = NULL;
+    SnapshotReader *reader = NULL;
+    if (!snapshot_writer_open_memory(&writer, SIM_SNAPSHOT_VERSION)) {
+        return false;
+    }
+    if (!sim_snapshot_write_state(state, writer)) {
+        snapshot_writer_finish_reader(writer, NULL);
+        return false;
+    }
+    if (!snapshot_writer_finish_reader(writer, &reader)) {
+        return false;
+    }
+    if (rewind->count == rewind->max_keyframes) {
+        sim_rewind_drop_oldest(rewind);
+        previous = rewind->count > 0 ? sim_rewind_at(rewind, rewind->count - 1u) : NULL;
+    }
+    SimRewindKeyframe *keyframe = sim_rewind_at(rewind, rewind->count);
+    keyframe->tick = state->tick_index;
+    bool ok = sim_rewind_fill(rewind, keyframe, previous, reader);
+    snapshot_reader_close(reader);
+    if (!ok) {
+        LOG_ERROR("sim_rewind: failed to store keyframe at tick %llu", (unsigned long long)state->tick_index);
+        return false;
+    }
+    rewind->count++;
+    while (rewind->max_bytes > 0 && rewind->bytes > rewind->max_bytes && rewind->count > 1) {
+        sim_rewind_drop_oldest(rewind);
+    }
+    return true;
+}
+
+bool sim_rewind_seek(SimRewind *rewind,
+                     SimState **state,
+                     HexWorld *world,
+                     uint64_t tick,
+                     float dt_sec,
+                     size_t worker_count) {
+    if (!rewind || !state || !*state || !world || (*state)->hex_world != world || !(dt_sec > 0.0f)) {
+        return false;
+    }
+    if (tick > (*state)->tick_index) {
+        return false;
+    }
+    if (tick == (*state)->tick_index) {
+        return true;
+    }
+    size_t age = rewind->count;
+    while (age > 0 && sim_rewind_at(rewind, age - 1u)->tick > tick) {
+        --age;
+    }
+    if (age == 0) {
+        LOG_WARN("sim_rewind: tick %llu is older than the oldest keyframe", (unsigned long long)tick);
+        return false;
+    }
+    const SimRewindKeyframe *keyframe = sim_rewind_at(rewind, age - 1u);
+
+    SnapshotWriter *writer = NULL;
+    SnapshotReader *reader = NULL;
+    if (!snapshot_writer_open_memory(&writer, SIM_SNAPSHOT_VERSION)) {
+        return false;
+    }
+    for (size_t c = 0; c < keyframe->column_count; ++c) {
+        const SimRewindColumn *column = &keyframe->columns[c];
+        snapshot_write(writer, column->name, column->blob ? column->blob->data : NULL, column->elem_size, column->count);
+    }
+    if (!snapshot_writer_finish_reader(writer, &reader)) {
+        return false;
+    }
+
+    // The restored state binds to *world, so the current one is moved aside
+    // and put back if the restore fails.
+    HexWorld previous_world = *world;
+    memset(world, 0, sizeof(*world));
+    SimState *restored = NULL;
+    if (!sim_snapshot_restore(&restored, world, worker_count, reader, "rewind keyframe")) {
+        *world = previous_world;
+        return false;
+    }
+    for (uint64_t t = keyframe->tick; t < tick; ++t) {
+        sim_tick(restored, dt_sec);
+    }
+    sim_shutdown(*state);
+    hex_world_shutdown(&previous_world);
+    *state = restored;
+    while (rewind->count > age) {
+        sim_rewind_drop_newest(rewind);
+    }
+    return true;
+}
+
+void sim_rewind_get_stats(const SimRewind *rewind, SimRewindStats *out_stats) {
+    if (!out_stats) {
+        return;
+    }
+    memset(out_stats, 0, sizeof(*out_stats));
+    out_stats->oldest_tick = UINT64_MAX;
+    if (!rewind || rewind->count == 0) {
+        return;
+    }
+    size_t logical = 0;
+    for (size_t age = 0; age < rewind->count; ++age) {
+        const SimRewindKeyframe *keyframe = &rewind->ring[(rewind->head + age) % rewind->max_keyframes];
+        for (size_t c = 0; c < keyframe->column_count; ++c) {
+            logical += keyframe->columns[c].elem_size * keyframe->columns[c].count;
+        }
+    }
+    out_stats->keyframes = rewind->count;
+    out_stats->bytes = rewind->bytes;
+    out_stats->shared_bytes = logical - rewind->bytes;
+    out_stats->oldest_tick = rewind->ring[rewind->head].tick;
+    out_stats->newest_tick = rewind->ring[(rewind->head + rewind->count - 1u) % rewind->max_keyframes].tick;
+}
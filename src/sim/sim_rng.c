@@ -0,0 +1,114 @@
+#include "sim_rng.h"
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define SIM_RNG_HAVE_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SIM_RNG_HAVE_SSE2 1
+#endif
+
+#if defined(SIM_RNG_HAVE_AVX2)
+
+// 32x32->64 multiply of all eight lanes, split into low and high words.
+static inline void sim_rng_mulhilo8(__m256i a, __m256i m, __m256i *lo, __m256i *hi) {
+    __m256i p02 = _mm256_mul_epu32(a, m);
+    __m256i p13 = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), m);
+    p02 = _mm256_shuffle_epi32(p02, _MM_SHUFFLE(3, 1, 2, 0));
+    p13 = _mm256_shuffle_epi32(p13, _MM_SHUFFLE(3, 1, 2, 0));
+    *lo = _mm256_unpacklo_epi32(p02, p13);
+    *hi = _mm256_unpackhi_epi32(p02, p13);
+}
+
+static size_t sim_rng_fill_avx2(SimRngKey key, uint32_t first_bee, size_t count, uint64_t tick, uint32_t slot, float *out) {
+    const __m256i m0 = _mm256_set1_epi32((int)SIM_PHILOX_M0);
+    const __m256i m1 = _mm256_set1_epi32((int)SIM_PHILOX_M1);
+    const __m256i lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256 scale = _mm256_set1_ps(1.0f / 16777216.0f);
+    size_t j = 0;
+    for (; j + 8 <= count; j += 8) {
+        __m256i c0 = _mm256_add_epi32(_mm256_set1_epi32((int)(first_bee + (uint32_t)j)), lane);
+        __m256i c1 = _mm256_set1_epi32((int)(uint32_t)tick);
+        __m256i c2 = _mm256_set1_epi32((int)(uint32_t)(tick >> 32));
+        __m256i c3 = _mm256_set1_epi32((int)slot);
+        uint32_t k0 = key.k0;
+        uint32_t k1 = key.k1;
+        for (int round = 0; round < 10; ++round) {
+            __m256i lo0, hi0, lo1, hi1;
+            sim_rng_mulhilo8(c0, m0, &lo0, &hi0);
+            sim_rng_mulhilo8(c2, m1, &lo1, &hi1);
+            c0 = _mm256_xor_si256(_mm256_xor_si256(hi1, c1), _mm256_set1_epi32((int)k0));
+            c2 = _mm256_xor_si256(_mm256_xor_si256(hi0, c3), _mm256_set1_epi32((int)k1));
+            c1 = lo1;
+            c3 = lo0;
+            k0 += SIM_PHILOX_W0;
+            k1 += SIM_PHILOX_W1;
+        }
+        __m256 unit = _mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(c0, 8)), scale);
+        _mm256_storeu_ps(out + j, unit);
+    }
+    return j;
+}
+
+#elif defined(SIM_RNG_HAVE_SSE2)
+
+static inline void sim_rng_mulhilo4(__m128i a, __m128i m, __m128i *lo, __m128i *hi) {
+    __m128i p02 = _mm_mul_epu32(a, m);
+    __m128i p13 = _mm_mul_epu32(_mm_srli_epi64(a, 32), m);
+    p02 = _mm_shuffle_epi32(p02, _MM_SHUFFLE(3, 1, 2, 0));
+    p13 = _mm_shuffle_epi32(p13, _MM_SHUFFLE(3, 1, 2, 0));
+    *lo = _mm_unpacklo_epi32(p02, p13);
+    *hi = _mm_unpackhi_epi32(p02, p13);
+}
+
+static size_t sim_rng_fill_sse2(SimRngKey key, uint32_t first_bee, size_t count, uint64_t tick, uint32_t slot, float *out) {
+    const __m128i m0 = _mm_set1_epi32((int)SIM_PHILOX_M0);
+    const __m128i m1 = _mm_set1_epi32((int)SIM_PHILOX_M1);
+    const __m128i lane = _mm_setr_epi32(0, 1, 2, 3);
+    const __m128 scale = _mm_set1_ps(1.0f / 16777216.0f);
+    size_t j = 0;
+    for (; j + 4 <= count; j += 4) {
+        __m128i c0 = _mm_add_epi32(_mm_set1_epi32((int)(first_bee + (uint32_t)j)), lane);
+        __m128i c1 = _mm_set1_epi32((int)(uint32_t)tick);
+        __m128i c2 = _mm_set1_epi32((int)(uint32_t)(tick >> 32));
+        __m128i c3 = _mm_set1_epi32((int)slot);
+        uint32_t k0 = key.k0;
+        uint32_t k1 = key.k1;
+        for (int round = 0; round < 10; ++round) {
+            __m128i lo0, hi0, lo1, hi1;
+            sim_rng_mulhilo4(c0, m0, &lo0, &hi0);
+            sim_rng_mulhilo4(c2, m1, &lo1, &hi1);
+            c0 = _mm_xor_si128(_mm_xor_si128(hi1, c1), _mm_set1_epi32((int)k0));
+            c2 = _mm_xor_si128(_mm_xor_si128(hi0, c3), _mm_set1_epi32((int)k1));
+            c1 = lo1;
+            c3 = lo0;
+            k0 += SIM_PHILOX_W0;
+            k1 += SIM_PHILOX_W1;
+        }
+        __m128 unit = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(c0, 8)), scale);
+        _mm_storeu_ps(out + j, unit);
+    }
+    return j;
+}
+
+#endif
+
+void sim_rng_fill_uniform01(SimRngKey key,
+                            uint32_t first_bee,
+                            size_t count,
+                            uint64_t tick,
+                            uint32_t slot,
+                            float *out) {
+    if (!out || count == 0) {
+        return;
+    }
+    size_t done = 0;
+#if defined(SIM_RNG_HAVE_AVX2)
+    done = sim_rng_fill_avx2(key, first_bee, count, tick, slot, out);
+#elif defined(SIM_RNG_HAVE_SSE2)
+    done = sim_rng_fill_sse2(key, first_bee, count, tick, slot, out);
+#endif
+    for (size_t j = done; j < count; ++j) {
+        out[j] = sim_rng_uniform01(key, first_bee + (uint32_t)j, tick, slot);
+    }
+}
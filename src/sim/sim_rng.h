@@ -0,0 +1,91 @@
+#ifndef SIM_SIM_RNG_H
+#define SIM_SIM_RNG_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Stateless counter-based generator (Philox4x32-10). Every draw is a pure
+// function of (seed, bee, tick, slot), so bees can be advanced in any order or
+// on any thread and still see the same numbers.
+//
+// The 32-bit slot is split as (stream << 24) | sub: the stream names the
+// decision consuming the draw, and sub lets one decision index several blocks
+// (e.g. one per candidate tile). Each block yields four independent words.
+
+#define SIM_RNG_SLOT(stream, sub) (((uint32_t)(stream) << 24) | ((uint32_t)(sub) & 0x00FFFFFFu))
+
+enum {
+    SIM_RNG_STREAM_SPAWN = 1,
+    SIM_RNG_STREAM_FLORAL_CHOICE = 2,
+    SIM_RNG_STREAM_OUTBOUND_TARGET = 3,
+    SIM_RNG_STREAM_FLIGHT_JITTER = 4,
+    SIM_RNG_STREAM_QUANTIZE = 5,
+};
+
+typedef struct SimRngKey {
+    uint32_t k0;
+    uint32_t k1;
+} SimRngKey;
+
+#define SIM_PHILOX_M0 0xD2511F53u
+#define SIM_PHILOX_M1 0xCD9E8D57u
+#define SIM_PHILOX_W0 0x9E3779B9u
+#define SIM_PHILOX_W1 0xBB67AE85u
+
+static inline SimRngKey sim_rng_key(uint64_t seed) {
+    SimRngKey key = {(uint32_t)seed, (uint32_t)(seed >> 32)};
+    return key;
+}
+
+static inline void sim_rng_block(SimRngKey key, uint32_t bee, uint64_t tick, uint32_t slot, uint32_t out[4]) {
+    uint32_t c0 = bee;
+    uint32_t c1 = (uint32_t)tick;
+    uint32_t c2 = (uint32_t)(tick >> 32);
+    uint32_t c3 = slot;
+    uint32_t k0 = key.k0;
+    uint32_t k1 = key.k1;
+    for (int round = 0; round < 10; ++round) {
+        uint64_t p0 = (uint64_t)SIM_PHILOX_M0 * c0;
+        uint64_t p1 = (uint64_t)SIM_PHILOX_M1 * c2;
+        uint32_t n0 = (uint32_t)(p1 >> 32) ^ c1 ^ k0;
+        uint32_t n2 = (uint32_t)(p0 >> 32) ^ c3 ^ k1;
+        c1 = (uint32_t)p1;
+        c3 = (uint32_t)p0;
+        c0 = n0;
+        c2 = n2;
+        k0 += SIM_PHILOX_W0;
+        k1 += SIM_PHILOX_W1;
+    }
+    out[0] = c0;
+    out[1] = c1;
+    out[2] = c2;
+    out[3] = c3;
+}
+
+// Maps the top 24 bits of a word to [0, 1); exact in float, so scalar and SIMD
+// paths agree bit for bit.
+static inline float sim_rng_word_to_unit(uint32_t word) {
+    return (float)(word >> 8) * (1.0f / 16777216.0f);
+}
+
+static inline float sim_rng_uniform01(SimRngKey key, uint32_t bee, uint64_t tick, uint32_t slot) {
+    uint32_t block[4];
+    sim_rng_block(key, bee, tick, slot, block);
+    return sim_rng_word_to_unit(block[0]);
+}
+
+static inline float sim_rng_symmetric(SimRngKey key, uint32_t bee, uint64_t tick, uint32_t slot) {
+    return sim_rng_uniform01(key, bee, tick, slot) * 2.0f - 1.0f;
+}
+
+void sim_rng_fill_uniform01(SimRngKey key,
+                            uint32_t first_bee,
+                            size_t count,
+                            uint64_t tick,
+                            uint32_t slot,
+                            float *out);
+// Bulk form of sim_rng_uniform01 for bees [first_bee, first_bee + count):
+// out[j] == sim_rng_uniform01(key, first_bee + j, tick, slot). Uses AVX2 or
+// SSE2 lanes when the build targets them.
+
+#endif  // SIM_SIM_RNG_H
@@ -0,0 +1,299 @@
+#include "sim_spatial.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define SIM_SPATIAL_MAX_CELLS (1u << 22)
+
+static uint32_t sim_spatial_coord(float v, float inv_cell_size, uint32_t n) {
+    float f = v * inv_cell_size;
+    if (!(f >= 0.0f)) {
+        return 0;
+    }
+    if (f >= (float)n) {
+        return n - 1u;
+    }
+    return (uint32_t)f;
+}
+
+bool sim_spatial_init(SimSpatialGrid *grid, float world_w, float world_h, float cell_size, size_t capacity) {
+    if (!grid) {
+        return false;
+    }
+    memset(grid, 0, sizeof(*grid));
+    if (capacity >= UINT32_MAX) {
+        return false;
+    }
+    if (world_w < 1.0f) {
+        world_w = 1.0f;
+    }
+    if (world_h < 1.0f) {
+        world_h = 1.0f;
+    }
+    if (!(cell_size >= 1.0f)) {
+        cell_size = 1.0f;
+    }
+    double cols = ceil((double)world_w / cell_size);
+    double rows = ceil((double)world_h / cell_size);
+    while (cols * rows > (double)SIM_SPATIAL_MAX_CELLS) {
+        cell_size *= 2.0f;
+        cols = ceil((double)world_w / cell_size);
+        rows = ceil((double)world_h / cell_size);
+    }
+    grid->cell_size = cell_size;
+    grid->inv_cell_size = 1.0f / cell_size;
+    grid->cols = (uint32_t)cols;
+    grid->rows = (uint32_t)rows;
+    size_t cells = (size_t)grid->cols * grid->rows;
+    size_t alloc_count = capacity > 0 ? capacity : 1u;
+    grid->cell_start = (uint32_t *)calloc(cells + 1u, sizeof(uint32_t));
+    grid->cell_of = (uint32_t *)malloc(alloc_count * sizeof(uint32_t));
+    grid->bee = (uint32_t *)malloc(alloc_count * sizeof(uint32_t));
+    grid->x = (float *)malloc(alloc_count * sizeof(float));
+    grid->y = (float *)malloc(alloc_count * sizeof(float));
+    if (!grid->cell_start || !grid->cell_of || !grid->bee || !grid->x || !grid->y) {
+        sim_spatial_free(grid);
+        return false;
+    }
+    grid->capacity = capacity;
+    return true;
+}
+
+void sim_spatial_free(SimSpatialGrid *grid) {
+    if (!grid) {
+        return;
+    }
+    free(grid->cell_start);
+    free(grid->cell_of);
+    free(grid->bee);
+    free(grid->x);
+    free(grid->y);
+    memset(grid, 0, sizeof(*grid));
+}
+
+size_t sim_spatial_bytes_per_bee(void) {
+    return 2u * sizeof(uint32_t) + 2u * sizeof(float);
+}
+
+void sim_spatial_build(SimSpatialGrid *grid, const float *x, const float *y, size_t count) {
+    if (!grid || !grid->cell_start) {
+        return;
+    }
+    if (count > grid->capacity) {
+        count = grid->capacity;
+    }
+    size_t cells = (size_t)grid->cols * grid->rows;
+    uint32_t *start = grid->cell_start;
+    memset(start, 0, (cells + 1u) * sizeof(uint32_t));
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t col = sim_spatial_coord(x[i], grid->inv_cell_size, grid->cols);
+        uint32_t row = sim_spatial_coord(y[i], grid->inv_cell_size, grid->rows);
+        uint32_t cell = row * grid->cols + col;
+        grid->cell_of[i] = cell;
+        start[cell + 1u]++;
+    }
+    for (size_t c = 0; c < cells; ++c) {
+        start[c + 1u] += start[c];
+    }
+    // Scatter with start[c] as the cursor; afterwards start[c] holds the end
+    // of cell c, so shift by one to restore the offsets.
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t slot = start[grid->cell_of[i]]++;
+        grid->bee[slot] = (uint32_t)i;
+        grid->x[slot] = x[i];
+        grid->y[slot] = y[i];
+    }
+    for (size_t c = cells; c > 0; --c) {
+        start[c] = start[c - 1u];
+    }
+    start[0] = 0;
+    grid->count = count;
+}
+
+size_t sim_spatial_query_rect(const SimSpatialGrid *grid,
+                              float min_x,
+                              float min_y,
+                              float max_x,
+                              float max_y,
+                              size_t *out_indices,
+                              size_t max_out) {
+    if (!grid || grid->count == 0 || !(min_x <= max_x) || !(min_y <= max_y)) {
+        return 0;
+    }
+    uint32_t col0 = sim_spatial_coord(min_x, grid->inv_cell_size, grid->cols);
+    uint32_t col1 = sim_spatial_coord(max_x, grid->inv_cell_size, grid->cols);
+    uint32_t row0 = sim_spatial_coord(min_y, grid->inv_cell_size, grid->rows);
+    uint32_t row1 = sim_spatial_coord(max_y, grid->inv_cell_size, grid->rows);
+    size_t found = 0;
+    for (uint32_t row = row0; row <= row1; ++row) {
+        uint32_t begin = grid->cell_start[row * grid->cols + col0];
+        uint32_t end = grid->cell_start[row * grid->cols + col1 + 1u];
+        for (uint32_t s = begin; s < end; ++s) {
+            float px = grid->x[s];
+            float py = grid->y[s];
+            if (px >= min_x && px <= max_x && py >= min_y && py <= max_y) {
+                if (found < max_out && out_indices) {
+                    out_indices[found] = grid->bee[s];
+                }
+                ++found;
+            }
+        }
+    }
+    return found;
+}
+
+size_t sim_spatial_query_radius(const SimSpatialGrid *grid,
+                                float center_x,
+                                float center_y,
+                                float radius,
+                                size_t *out_indices,
+                                size_t max_out) {
+    if (!grid || grid->count == 0 || !(radius >= 0.0f)) {
+        return 0;
+    }
+    uint32_t col0 = sim_spatial_coord(center_x - radius, grid->inv_cell_size, grid->cols);
+    uint32_t col1 = sim_spatial_coord(center_x + radius, grid->inv_cell_size, grid->cols);
+    uint32_t row0 = sim_spatial_coord(center_y - radius, grid->inv_cell_size, grid->rows);
+    uint32_t row1 = sim_spatial_coord(center_y + radius, grid->inv_cell_size, grid->rows);
+    float radius_sq = radius * radius;
+    size_t found = 0;
+    for (uint32_t row = row0; row <= row1; ++row) {
+        uint32_t begin = grid->cell_start[row * grid->cols + col0];
+        uint32_t end = grid->cell_start[row * grid->cols + col1 + 1u];
+        for (uint32_t s = begin; s < end; ++s) {
+            float dx = grid->x[s] - center_x;
+            float dy = grid->y[s] - center_y;
+            if (dx * dx + dy * dy <= radius_sq) {
+                if (found < max_out && out_indices) {
+                    out_indices[found] = grid->bee[s];
+                }
+                ++found;
+            }
+        }
+    }
+    return found;
+}
+
+typedef struct SimSpatialNearest {
+    const SimSpatialGrid *grid;
+    float center_x;
+    float center_y;
+    float max_dist_sq;
+    size_t k;
+    size_t found;
+    size_t *indices;
+    float *dist_sq;
+} SimSpatialNearest;
+
+// Offers the bees of cells [col0, col1] in one row to the sorted k-best list.
+static void sim_spatial_nearest_span(SimSpatialNearest *q, int64_t row, int64_t col0, int64_t col1) {
+    const SimSpatialGrid *grid = q->grid;
+    if (row < 0 || row >= (int64_t)grid->rows) {
+        return;
+    }
+    if (col0 < 0) {
+        col0 = 0;
+    }
+    if (col1 >= (int64_t)grid->cols) {
+        col1 = (int64_t)grid->cols - 1;
+    }
+    if (col0 > col1) {
+        return;
+    }
+    uint32_t begin = grid->cell_start[(size_t)row * grid->cols + (size_t)col0];
+    uint32_t end = grid->cell_start[(size_t)row * grid->cols + (size_t)col1 + 1u];
+    for (uint32_t s = begin; s < end; ++s) {
+        float dx = grid->x[s] - q->center_x;
+        float dy = grid->y[s] - q->center_y;
+        float d = dx * dx + dy * dy;
+        if (!(d <= q->max_dist_sq)) {
+            continue;
+        }
+        size_t bee = grid->bee[s];
+        size_t pos;
+        if (q->found == q->k) {
+            float worst = q->dist_sq[q->k - 1u];
+            if (d > worst || (d == worst && bee > q->indices[q->k - 1u])) {
+                continue;
+            }
+            pos = q->k - 1u;
+        } else {
+            pos = q->found++;
+        }
+        while (pos > 0 && (q->dist_sq[pos - 1u] > d || (q->dist_sq[pos - 1u] == d && q->indices[pos - 1u] > bee))) {
+            q->dist_sq[pos] = q->dist_sq[pos - 1u];
+            q->indices[pos] = q->indices[pos - 1u];
+            --pos;
+        }
+        q->dist_sq[pos] = d;
+        q->indices[pos] = bee;
+    }
+}
+
+size_t sim_spatial_query_nearest(const SimSpatialGrid *grid,
+                                 float center_x,
+                                 float center_y,
+                                 float max_radius,
+                                 size_t k,
+                                 size_t *out_indices,
+                                 float *out_dist_sq) {
+    if (!grid || grid->count == 0 || k == 0 || !out_indices || !out_dist_sq || !(max_radius >= 0.0f)) {
+        return 0;
+    }
+    SimSpatialNearest q = {
+        .grid = grid,
+        .center_x = center_x,
+        .center_y = center_y,
+        .max_dist_sq = max_radius * max_radius,
+        .k = k,
+        .found = 0,
+        .indices = out_indices,
+        .dist_sq = out_dist_sq,
+    };
+    int64_t cx = sim_spatial_coord(center_x, grid->inv_cell_size, grid->cols);
+    int64_t cy = sim_spatial_coord(center_y, grid->inv_cell_size, grid->rows);
+    int64_t last_col = (int64_t)grid->cols - 1;
+    int64_t last_row = (int64_t)grid->rows - 1;
+    for (int64_t r = 0;; ++r) {
+        sim_spatial_nearest_span(&q, cy - r, cx - r, cx + r);
+        if (r > 0) {
+            sim_spatial_nearest_span(&q, cy + r, cx - r, cx + r);
+            for (int64_t row = cy - r + 1; row <= cy + r - 1; ++row) {
+                sim_spatial_nearest_span(&q, row, cx - r, cx - r);
+                sim_spatial_nearest_span(&q, row, cx + r, cx + r);
+            }
+        }
+
+        // Every unvisited cell lies at least gap away from the center (less a
+        // margin for bees rounded into a neighbouring cell at a boundary).
+        float gap = INFINITY;
+        if (cx - r > 0) {
+            gap = fminf(gap, center_x - (float)(cx - r) * grid->cell_size);
+        }
+        if (cx + r < last_col) {
+            gap = fminf(gap, (float)(cx + r + 1) * grid->cell_size - center_x);
+        }
+        if (cy - r > 0) {
+            gap = fminf(gap, center_y - (float)(cy - r) * grid->cell_size);
+        }
+        if (cy + r < last_row) {
+            gap = fminf(gap, (float)(cy + r + 1) * grid->cell_size - center_y);
+        }
+        if (gap == INFINITY) {
+            break;
+        }
+        gap -= grid->cell_size * 1e-4f;
+        if (gap < 0.0f) {
+            gap = 0.0f;
+        }
+        float gap_sq = gap * gap;
+        if (gap_sq > q.max_dist_sq) {
+            break;
+        }
+        if (q.found == q.k && q.dist_sq[q.k - 1u] < gap_sq) {
+            break;
+        }
+    }
+    return q.found;
+}
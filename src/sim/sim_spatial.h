@@ -0,0 +1,70 @@
+#ifndef SIM_SIM_SPATIAL_H
+#define SIM_SIM_SPATIAL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+// Uniform grid over bee positions, rebuilt with a counting sort whenever the
+// positions change. Bees are stored grouped by cell (row-major, bee order
+// within a cell) with their coordinates copied alongside, so a query walks one
+// contiguous span per grid row it overlaps. Positions outside the world box
+// land in the border cells; NaN positions are stored but never match a query.
+
+typedef struct SimSpatialGrid {
+    float cell_size;
+    float inv_cell_size;
+    uint32_t cols;
+    uint32_t rows;
+    uint32_t *cell_start;  // cols * rows + 1 offsets into bee/x/y
+    uint32_t *cell_of;     // per bee, scratch for the sort
+    uint32_t *bee;         // bee indices grouped by cell
+    float *x;              // positions in bee[] order
+    float *y;
+    size_t count;
+    size_t capacity;
+} SimSpatialGrid;
+
+bool sim_spatial_init(SimSpatialGrid *grid, float world_w, float world_h, float cell_size, size_t capacity);
+// Sizes the grid for the world box [0, world_w] x [0, world_h] and up to
+// capacity bees. Returns false (leaving the grid empty) on allocation failure.
+
+void sim_spatial_free(SimSpatialGrid *grid);
+
+size_t sim_spatial_bytes_per_bee(void);
+// Bytes the grid allocates per bee of capacity (cell_of, bee, x and y).
+
+void sim_spatial_build(SimSpatialGrid *grid, const float *x, const float *y, size_t count);
+// Re-sorts count bees into the cells. Does not allocate.
+
+size_t sim_spatial_query_rect(const SimSpatialGrid *grid,
+                              float min_x,
+                              float min_y,
+                              float max_x,
+                              float max_y,
+                              size_t *out_indices,
+                              size_t max_out);
+// Bees whose center lies in the closed rectangle. Returns the number of
+// matches; only the first max_out are written.
+
+size_t sim_spatial_query_radius(const SimSpatialGrid *grid,
+                                float center_x,
+                                float center_y,
+                                float radius,
+                                size_t *out_indices,
+                                size_t max_out);
+// Bees whose center lies within radius (inclusive) of the point. Returns the
+// number of matches; only the first max_out are written.
+
+size_t sim_spatial_query_nearest(const SimSpatialGrid *grid,
+                                 float center_x,
+                                 float center_y,
+                                 float max_radius,
+                                 size_t k,
+                                 size_t *out_indices,
+                                 float *out_dist_sq);
+// Up to k bees within max_radius of the point, closest first (equal distances
+// by bee index). Searches rings of cells outward and stops once no unvisited
+// cell can hold a closer bee. Returns the number written.
+
+#endif  // SIM_SIM_SPATIAL_H
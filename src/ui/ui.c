@@ -177,6 +177,12 @@ typedef struct {
     bool action_reset;
     bool action_reinit;
     bool action_focus_queen;
+    bool action_slower;
+    bool action_faster;
+
+    float speed_target;    // 0: unbounded fast-forward
+    float speed_achieved;
+    float ticks_per_frame;
 
     GLuint program;
     GLuint vao;
@@ -690,6 +696,12 @@ void ui_set_selected_bee(const BeeDebugInfo *info, bool valid) {
     }
 }
 
+void ui_set_sim_speed(float target_multiple, float achieved_multiple, float ticks_per_frame) {
+    g_ui.speed_target = target_multiple;
+    g_ui.speed_achieved = achieved_multiple;
+    g_ui.ticks_per_frame = ticks_per_frame;
+}
+
 void ui_set_selected_hex(const HexTileDebugInfo *info, bool valid) {
     if (valid && info) {
         g_ui.selected_hex = *info;
@@ -1194,6 +1206,8 @@ static void ui_begin_frame(const Input *input) {
     g_ui.action_reset = false;
     g_ui.action_reinit = false;
     g_ui.action_focus_queen = false;
+    g_ui.action_slower = false;
+    g_ui.action_faster = false;
     g_ui.wants_mouse = false;
     g_ui.wants_keyboard = false;
     g_ui.info_panel_next_y = UI_PANEL_MARGIN;
@@ -1593,6 +1607,39 @@ static void ui_begin_frame(const Input *input) {
     }
     cursor_y += 40.0f;
 
+    UiRect slower_rect = {text_x, cursor_y - scroll, pause_rect.w, 28.0f};
+    UiRect faster_rect = {step_rect.x, cursor_y - scroll, step_rect.w, 28.0f};
+    bool speed_visible = ui_range_intersects(slower_rect.y, slower_rect.h, view_top, view_bottom);
+    if (speed_visible) {
+        UiColor speed_button = ui_color_rgba(0.3f, 0.3f, 0.35f, 1.0f);
+        ui_add_rect(slower_rect.x, slower_rect.y, slower_rect.w, slower_rect.h, speed_button);
+        ui_add_rect(faster_rect.x, faster_rect.y, faster_rect.w, faster_rect.h, speed_button);
+    }
+    if (speed_visible && ui_range_intersects(slower_rect.y + 6.0f, UI_CHAR_HEIGHT, view_top, view_bottom)) {
+        ui_draw_text(slower_rect.x + 8.0f, slower_rect.y + 6.0f, "SLOWER", text);
+        ui_draw_text(faster_rect.x + 8.0f, faster_rect.y + 6.0f, "FASTER", text);
+    }
+    if (mouse_pressed && ui_rect_contains(&slower_rect, g_ui.mouse_x, g_ui.mouse_y)) {
+        g_ui.action_slower = true;
+    }
+    if (mouse_pressed && ui_rect_contains(&faster_rect, g_ui.mouse_x, g_ui.mouse_y)) {
+        g_ui.action_faster = true;
+    }
+    cursor_y += 36.0f;
+
+    if (ui_range_intersects(cursor_y - scroll, UI_CHAR_HEIGHT, view_top, view_bottom)) {
+        char speed_line[64];
+        if (g_ui.speed_target > 0.0f) {
+            snprintf(speed_line, sizeof(speed_line), "SPEED %gX: %.1fX %.1f T/F",
+                     g_ui.speed_target, g_ui.speed_achieved, g_ui.ticks_per_frame);
+        } else {
+            snprintf(speed_line, sizeof(speed_line), "SPEED MAX: %.1fX %.1f T/F",
+                     g_ui.speed_achieved, g_ui.ticks_per_frame);
+        }
+        ui_draw_text(text_x, cursor_y - scroll, speed_line, text);
+    }
+    cursor_y += 28.0f;
+
     UiRect queen_rect = {text_x, cursor_y - scroll, content_width, 28.0f};
     bool queen_visible = ui_range_intersects(queen_rect.y, queen_rect.h, view_top, view_bottom);
     UiColor queen_button = ui_color_rgba(0.95f, 0.30f, 0.85f, 1.0f);
@@ -1631,8 +1678,7 @@ static void ui_begin_frame(const Input *input) {
         dirty_now = true;
     }
     g_ui.dirty = dirty_now;
-    g_ui.reinit_required = (runtime->bee_count != baseline->bee_count) ||
-                           fabsf(runtime->world_width_px - baseline->world_width_px) > 0.0001f ||
+    g_ui.reinit_required = fabsf(runtime->world_width_px - baseline->world_width_px) > 0.0001f ||
                            fabsf(runtime->world_height_px - baseline->world_height_px) > 0.0001f;
 
     float apply_content_y = cursor_y;
@@ -1727,6 +1773,12 @@ UiActions ui_update(const Input *input, bool sim_paused, float dt_sec) {
     if (g_ui.action_focus_queen) {
         actions.focus_queen = true;
     }
+    if (g_ui.action_slower) {
+        actions.speed_down = true;
+    }
+    if (g_ui.action_faster) {
+        actions.speed_up = true;
+    }
 
     return actions;
 }
@@ -0,0 +1,275 @@
+#include "util/job_pool.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+#include "util/log.h"
+
+#ifdef _WIN32
+typedef HANDLE JobThread;
+typedef CRITICAL_SECTION JobMutex;
+typedef CONDITION_VARIABLE JobCond;
+#else
+typedef pthread_t JobThread;
+typedef pthread_mutex_t JobMutex;
+typedef pthread_cond_t JobCond;
+#endif
+
+struct JobPool {
+    size_t worker_count;
+    size_t thread_count;
+    JobThread *threads;
+    JobMutex mutex;
+    JobCond work_cond;
+    JobCond done_cond;
+    JobPoolFn fn;
+    void *user_data;
+    size_t job_count;
+    size_t next_job;
+    size_t jobs_done;
+    bool shutdown;
+};
+
+static void job_mutex_init(JobMutex *mutex) {
+#ifdef _WIN32
+    InitializeCriticalSection(mutex);
+#else
+    pthread_mutex_init(mutex, NULL);
+#endif
+}
+
+static void job_mutex_destroy(JobMutex *mutex) {
+#ifdef _WIN32
+    DeleteCriticalSection(mutex);
+#else
+    pthread_mutex_destroy(mutex);
+#endif
+}
+
+static void job_mutex_lock(JobMutex *mutex) {
+#ifdef _WIN32
+    EnterCriticalSection(mutex);
+#else
+    pthread_mutex_lock(mutex);
+#endif
+}
+
+static void job_mutex_unlock(JobMutex *mutex) {
+#ifdef _WIN32
+    LeaveCriticalSection(mutex);
+#else
+    pthread_mutex_unlock(mutex);
+#endif
+}
+
+static void job_cond_init(JobCond *cond) {
+#ifdef _WIN32
+    InitializeConditionVariable(cond);
+#else
+    pthread_cond_init(cond, NULL);
+#endif
+}
+
+static void job_cond_destroy(JobCond *cond) {
+#ifdef _WIN32
+    (void)cond;
+#else
+    pthread_cond_destroy(cond);
+#endif
+}
+
+static void job_cond_wait(JobCond *cond, JobMutex *mutex) {
+#ifdef _WIN32
+    SleepConditionVariableCS(cond, mutex, INFINITE);
+#else
+    pthread_cond_wait(cond, mutex);
+#endif
+}
+
+static void job_cond_signal(JobCond *cond) {
+#ifdef _WIN32
+    WakeConditionVariable(cond);
+#else
+    pthread_cond_signal(cond);
+#endif
+}
+
+static void job_cond_broadcast(JobCond *cond) {
+#ifdef _WIN32
+    WakeAllConditionVariable(cond);
+#else
+    pthread_cond_broadcast(cond);
+#endif
+}
+
+// Claims the next job under the lock. Returns false once every job of the
+// current batch has been handed out.
+static bool job_pool_claim_locked(JobPool *pool, JobPoolFn *out_fn, void **out_user, size_t *out_index) {
+    if (pool->next_job >= pool->job_count) {
+        return false;
+    }
+    *out_fn = pool->fn;
+    *out_user = pool->user_data;
+    *out_index = pool->next_job++;
+    return true;
+}
+
+static void job_pool_finish_locked(JobPool *pool) {
+    pool->jobs_done++;
+    if (pool->jobs_done == pool->job_count) {
+        job_cond_signal(&pool->done_cond);
+    }
+}
+
+static void job_pool_worker_loop(JobPool *pool) {
+    job_mutex_lock(&pool->mutex);
+    for (;;) {
+        JobPoolFn fn = NULL;
+        void *user = NULL;
+        size_t index = 0;
+        while (!pool->shutdown && !job_pool_claim_locked(pool, &fn, &user, &index)) {
+            job_cond_wait(&pool->work_cond, &pool->mutex);
+        }
+        if (pool->shutdown) {
+            break;
+        }
+        job_mutex_unlock(&pool->mutex);
+        fn(user, index);
+        job_mutex_lock(&pool->mutex);
+        job_pool_finish_locked(pool);
+    }
+    job_mutex_unlock(&pool->mutex);
+}
+
+#ifdef _WIN32
+static DWORD WINAPI job_pool_thread_main(LPVOID arg) {
+    job_pool_worker_loop((JobPool *)arg);
+    return 0;
+}
+#else
+static void *job_pool_thread_main(void *arg) {
+    job_pool_worker_loop((JobPool *)arg);
+    return NULL;
+}
+#endif
+
+static void job_pool_join(JobPool *pool, size_t started) {
+    job_mutex_lock(&pool->mutex);
+    pool->shutdown = true;
+    job_cond_broadcast(&pool->work_cond);
+    job_mutex_unlock(&pool->mutex);
+    for (size_t i = 0; i < started; ++i) {
+#ifdef _WIN32
+        WaitForSingleObject(pool->threads[i], INFINITE);
+        CloseHandle(pool->threads[i]);
+#else
+        pthread_join(pool->threads[i], NULL);
+#endif
+    }
+}
+
+bool job_pool_create(JobPool **out_pool, size_t worker_count) {
+    if (!out_pool || worker_count == 0) {
+        LOG_ERROR("job_pool_create: invalid arguments");
+        return false;
+    }
+    JobPool *pool = (JobPool *)calloc(1, sizeof(JobPool));
+    if (!pool) {
+        LOG_ERROR("job_pool_create: failed to allocate pool");
+        return false;
+    }
+    pool->worker_count = worker_count;
+    pool->thread_count = worker_count - 1u;
+    if (pool->thread_count > 0) {
+        pool->threads = (JobThread *)calloc(pool->thread_count, sizeof(JobThread));
+        if (!pool->threads) {
+            LOG_ERROR("job_pool_create: failed to allocate %zu thread handles", pool->thread_count);
+            free(pool);
+            return false;
+        }
+    }
+    job_mutex_init(&pool->mutex);
+    job_cond_init(&pool->work_cond);
+    job_cond_init(&pool->done_cond);
+
+    for (size_t i = 0; i < pool->thread_count; ++i) {
+#ifdef _WIN32
+        pool->threads[i] = CreateThread(NULL, 0, job_pool_thread_main, pool, 0, NULL);
+        bool ok = pool->threads[i] != NULL;
+#else
+        bool ok = pthread_create(&pool->threads[i], NULL, job_pool_thread_main, pool) == 0;
+#endif
+        if (!ok) {
+            LOG_ERROR("job_pool_create: failed to start worker thread %zu", i);
+            job_pool_join(pool, i);
+            job_cond_destroy(&pool->done_cond);
+            job_cond_destroy(&pool->work_cond);
+            job_mutex_destroy(&pool->mutex);
+            free(pool->threads);
+            free(pool);
+            return false;
+        }
+    }
+
+    *out_pool = pool;
+    return true;
+}
+
+void job_pool_destroy(JobPool *pool) {
+    if (!pool) {
+        return;
+    }
+    job_pool_join(pool, pool->thread_count);
+    job_cond_destroy(&pool->done_cond);
+    job_cond_destroy(&pool->work_cond);
+    job_mutex_destroy(&pool->mutex);
+    free(pool->threads);
+    free(pool);
+}
+
+size_t job_pool_worker_count(const JobPool *pool) {
+    return pool ? pool->worker_count : 1u;
+}
+
+void job_pool_run(JobPool *pool, size_t job_count, JobPoolFn fn, void *user_data) {
+    if (!fn || job_count == 0) {
+        return;
+    }
+    if (!pool || pool->thread_count == 0 || job_count == 1) {
+        for (size_t i = 0; i < job_count; ++i) {
+            fn(user_data, i);
+        }
+        return;
+    }
+
+    job_mutex_lock(&pool->mutex);
+    pool->fn = fn;
+    pool->user_data = user_data;
+    pool->job_count = job_count;
+    pool->next_job = 0;
+    pool->jobs_done = 0;
+    job_cond_broadcast(&pool->work_cond);
+
+    JobPoolFn claimed_fn = NULL;
+    void *claimed_user = NULL;
+    size_t index = 0;
+    while (job_pool_claim_locked(pool, &claimed_fn, &claimed_user, &index)) {
+        job_mutex_unlock(&pool->mutex);
+        claimed_fn(claimed_user, index);
+        job_mutex_lock(&pool->mutex);
+        job_pool_finish_locked(pool);
+    }
+    while (pool->jobs_done < pool->job_count) {
+        job_cond_wait(&pool->done_cond, &pool->mutex);
+    }
+    pool->fn = NULL;
+    pool->user_data = NULL;
+    job_mutex_unlock(&pool->mutex);
+}
@@ -0,0 +1,492 @@
+#include "util/snapshot.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _MSC_VER
+#include <malloc.h>
+#endif
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "util/log.h"
+
+#define SNAPSHOT_MAGIC "BEESNAP"
+#define SNAPSHOT_BYTE_ORDER UINT32_C(0x01020304)
+
+typedef struct SnapshotHeader {
+    char magic[8];
+    uint32_t byte_order;
+    uint32_t version;
+    uint64_t table_offset;
+    uint64_t column_count;
+    uint64_t file_bytes;
+    uint8_t pad[24];
+} SnapshotHeader;
+
+typedef struct SnapshotEntry {
+    char name[SNAPSHOT_NAME_MAX];
+    uint64_t offset;
+    uint64_t count;
+    uint64_t elem_size;
+    uint64_t reserved;
+} SnapshotEntry;
+
+_Static_assert(sizeof(SnapshotHeader) == SNAPSHOT_ALIGN, "snapshot header must fill one aligned block");
+_Static_assert(sizeof(SnapshotEntry) == 64u, "snapshot table entries are fixed size");
+
+struct SnapshotWriter {
+    FILE *file;     // NULL for a memory writer
+    uint8_t *image;  // memory writer: the checkpoint so far, SNAPSHOT_ALIGN aligned
+    size_t image_capacity;
+    char *path;
+    uint32_t version;
+    uint64_t offset;
+    SnapshotEntry *entries;
+    size_t entry_count;
+    size_t entry_capacity;
+    bool ok;
+};
+
+struct SnapshotReader {
+    uint8_t *base;
+    size_t bytes;
+    bool heap;  // base is a memory writer's image rather than a mapping
+    const SnapshotEntry *entries;
+    size_t entry_count;
+};
+
+static uint8_t *snapshot_image_alloc(size_t bytes) {
+#if defined(_MSC_VER)
+    return (uint8_t *)_aligned_malloc(bytes, SNAPSHOT_ALIGN);
+#else
+    void *ptr = NULL;
+    return posix_memalign(&ptr, SNAPSHOT_ALIGN, bytes) == 0 ? (uint8_t *)ptr : NULL;
+#endif
+}
+
+static void snapshot_image_free(uint8_t *image) {
+#if defined(_MSC_VER)
+    _aligned_free(image);
+#else
+    free(image);
+#endif
+}
+
+// Grows a memory writer's image geometrically. Aligned blocks cannot be
+// realloc'd, so the image is copied.
+static bool snapshot_image_reserve(SnapshotWriter *writer, size_t bytes) {
+    if (bytes <= writer->image_capacity) {
+        return true;
+    }
+    size_t new_cap = writer->image_capacity ? writer->image_capacity : 4096u;
+    while (new_cap < bytes) {
+        if (new_cap > SIZE_MAX / 2u) {
+            return false;
+        }
+        new_cap *= 2u;
+    }
+    uint8_t *image = snapshot_image_alloc(new_cap);
+    if (!image) {
+        return false;
+    }
+    if (writer->image) {
+        memcpy(image, writer->image, (size_t)writer->offset);
+        snapshot_image_free(writer->image);
+    }
+    writer->image = image;
+    writer->image_capacity = new_cap;
+    return true;
+}
+
+static bool snapshot_put(SnapshotWriter *writer, const void *data, size_t bytes) {
+    if (!writer->ok || bytes == 0) {
+        return writer->ok;
+    }
+    if (writer->file) {
+        if (fwrite(data, 1, bytes, writer->file) != bytes) {
+            writer->ok = false;
+            return false;
+        }
+    } else {
+        if (bytes > SIZE_MAX - (size_t)writer->offset || !snapshot_image_reserve(writer, (size_t)writer->offset + bytes)) {
+            LOG_ERROR("snapshot: allocation failed");
+            writer->ok = false;
+            return false;
+        }
+        memcpy(writer->image + writer->offset, data, bytes);
+    }
+    writer->offset += bytes;
+    return true;
+}
+
+static bool snapshot_pad(SnapshotWriter *writer) {
+    static const uint8_t zeros[SNAPSHOT_ALIGN] = {0};
+    size_t rem = (size_t)(writer->offset % SNAPSHOT_ALIGN);
+    return rem == 0 || snapshot_put(writer, zeros, SNAPSHOT_ALIGN - rem);
+}
+
+bool snapshot_writer_open(SnapshotWriter **out_writer, const char *path, uint32_t version) {
+    if (!out_writer || !path) {
+        return false;
+    }
+    SnapshotWriter *writer = (SnapshotWriter *)calloc(1, sizeof(SnapshotWriter));
+    size_t path_len = strlen(path);
+    char *path_copy = (char *)malloc(path_len + 1u);
+    if (!writer || !path_copy) {
+        LOG_ERROR("snapshot: allocation failed");
+        free(writer);
+        free(path_copy);
+        return false;
+    }
+    memcpy(path_copy, path, path_len + 1u);
+    writer->file = fopen(path, "wb");
+    if (!writer->file) {
+        LOG_ERROR("snapshot: cannot create '%s'", path);
+        free(path_copy);
+        free(writer);
+        return false;
+    }
+    writer->path = path_copy;
+    writer->version = version;
+    writer->ok = true;
+    SnapshotHeader placeholder;
+    memset(&placeholder, 0, sizeof(placeholder));
+    snapshot_put(writer, &placeholder, sizeof(placeholder));
+    *out_writer = writer;
+    return true;
+}
+
+bool snapshot_writer_open_memory(SnapshotWriter **out_writer, uint32_t version) {
+    if (!out_writer) {
+        return false;
+    }
+    SnapshotWriter *writer = (SnapshotWriter *)calloc(1, sizeof(SnapshotWriter));
+    if (!writer) {
+        LOG_ERROR("snapshot: allocation failed");
+        return false;
+    }
+    writer->version = version;
+    writer->ok = true;
+    SnapshotHeader placeholder;
+    memset(&placeholder, 0, sizeof(placeholder));
+    snapshot_put(writer, &placeholder, sizeof(placeholder));
+    *out_writer = writer;
+    return true;
+}
+
+bool snapshot_write(SnapshotWriter *writer, const char *name, const void *data, size_t elem_size, size_t count) {
+    if (!writer || !writer->ok) {
+        return false;
+    }
+    if (!name || strlen(name) >= SNAPSHOT_NAME_MAX || elem_size == 0 || (count > 0 && !data) ||
+        count > SIZE_MAX / elem_size) {
+        LOG_ERROR("snapshot: invalid column '%s'", name ? name : "(null)");
+        writer->ok = false;
+        return false;
+    }
+    for (size_t e = 0; e < writer->entry_count; ++e) {
+        if (strcmp(writer->entries[e].name, name) == 0) {
+            LOG_ERROR("snapshot: duplicate column '%s'", name);
+            writer->ok = false;
+            return false;
+        }
+    }
+    if (writer->entry_count == writer->entry_capacity) {
+        size_t new_cap = writer->entry_capacity ? writer->entry_capacity * 2u : 64u;
+        SnapshotEntry *entries = (SnapshotEntry *)realloc(writer->entries, new_cap * sizeof(SnapshotEntry));
+        if (!entries) {
+            LOG_ERROR("snapshot: allocation failed");
+            writer->ok = false;
+            return false;
+        }
+        writer->entries = entries;
+        writer->entry_capacity = new_cap;
+    }
+    if (!snapshot_pad(writer)) {
+        return false;
+    }
+    SnapshotEntry *entry = &writer->entries[writer->entry_count++];
+    memset(entry, 0, sizeof(*entry));
+    strcpy(entry->name, name);
+    entry->offset = writer->offset;
+    entry->count = count;
+    entry->elem_size = elem_size;
+    return snapshot_put(writer, data, elem_size * count);
+}
+
+// Appends the column table and returns the final header.
+static SnapshotHeader snapshot_seal(SnapshotWriter *writer) {
+    snapshot_pad(writer);
+    SnapshotHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    header.byte_order = SNAPSHOT_BYTE_ORDER;
+    header.version = writer->version;
+    header.table_offset = writer->offset;
+    header.column_count = writer->entry_count;
+    snapshot_put(writer, writer->entries, writer->entry_count * sizeof(SnapshotEntry));
+    header.file_bytes = writer->offset;
+    return header;
+}
+
+static void snapshot_writer_free(SnapshotWriter *writer) {
+    snapshot_image_free(writer->image);
+    free(writer->entries);
+    free(writer->path);
+    free(writer);
+}
+
+bool snapshot_writer_finish(SnapshotWriter *writer) {
+    if (!writer) {
+        return false;
+    }
+    if (!writer->file) {
+        snapshot_writer_free(writer);
+        return false;
+    }
+    SnapshotHeader header = snapshot_seal(writer);
+    if (writer->ok && (fseek(writer->file, 0, SEEK_SET) != 0 || fwrite(&header, sizeof(header), 1, writer->file) != 1)) {
+        writer->ok = false;
+    }
+    if (fclose(writer->file) != 0) {
+        writer->ok = false;
+    }
+    bool ok = writer->ok;
+    if (!ok) {
+        LOG_ERROR("snapshot: failed to write '%s'", writer->path);
+        remove(writer->path);
+    }
+    snapshot_writer_free(writer);
+    return ok;
+}
+
+// Maps the whole file copy-on-write: pages are read on first touch, and
+// writes go to private copies, never back to the file.
+static uint8_t *snapshot_map(const char *path, size_t *out_bytes) {
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (file == INVALID_HANDLE_VALUE) {
+        return NULL;
+    }
+    void *base = NULL;
+    LARGE_INTEGER size;
+    if (GetFileSizeEx(file, &size) && size.QuadPart > 0 && (unsigned long long)size.QuadPart <= SIZE_MAX) {
+        HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+        if (mapping) {
+            base = MapViewOfFile(mapping, FILE_MAP_COPY, 0, 0, 0);
+            CloseHandle(mapping);  // the view keeps the mapping alive
+        }
+        *out_bytes = (size_t)size.QuadPart;
+    }
+    CloseHandle(file);
+    return (uint8_t *)base;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return NULL;
+    }
+    struct stat st;
+    void *base = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size > 0 && (unsigned long long)st.st_size <= SIZE_MAX) {
+        base = mmap(NULL, (size_t)st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        *out_bytes = (size_t)st.st_size;
+    }
+    close(fd);
+    return base == MAP_FAILED ? NULL : (uint8_t *)base;
+#endif
+}
+
+static void snapshot_unmap(uint8_t *base, size_t bytes) {
+#ifdef _WIN32
+    (void)bytes;
+    UnmapViewOfFile(base);
+#else
+    munmap(base, bytes);
+#endif
+}
+
+static bool snapshot_validate(const SnapshotReader *reader, uint32_t version, const char *path);
+
+bool snapshot_writer_finish_reader(SnapshotWriter *writer, SnapshotReader **out_reader) {
+    if (!writer) {
+        return false;
+    }
+    SnapshotReader *reader = NULL;
+    if (!writer->file && out_reader) {
+        SnapshotHeader header = snapshot_seal(writer);
+        reader = writer->ok ? (SnapshotReader *)calloc(1, sizeof(SnapshotReader)) : NULL;
+        if (reader) {
+            memcpy(writer->image, &header, sizeof(header));
+            reader->base = writer->image;
+            reader->bytes = (size_t)writer->offset;
+            reader->heap = true;
+            reader->entries = (const SnapshotEntry *)(reader->base + header.table_offset);
+            reader->entry_count = (size_t)header.column_count;
+            writer->image = NULL;
+        } else if (writer->ok) {
+            LOG_ERROR("snapshot: allocation failed");
+        }
+    }
+    snapshot_writer_free(writer);
+    if (!reader) {
+        return false;
+    }
+    *out_reader = reader;
+    return true;
+}
+
+static bool snapshot_validate(const SnapshotReader *reader, uint32_t version, const char *path) {
+    const SnapshotHeader *header = (const SnapshotHeader *)reader->base;
+    if (reader->bytes < sizeof(SnapshotHeader) || memcmp(header->magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0) {
+        LOG_ERROR("snapshot: '%s' is not a checkpoint", path);
+        return false;
+    }
+    if (header->byte_order != SNAPSHOT_BYTE_ORDER) {
+        LOG_ERROR("snapshot: '%s' was written on a machine with a different byte order", path);
+        return false;
+    }
+    if (header->version != version) {
+        LOG_ERROR("snapshot: '%s' has format version %u, expected %u", path, header->version, version);
+        return false;
+    }
+    uint64_t table_end = header->table_offset + header->column_count * sizeof(SnapshotEntry);
+    if (header->file_bytes != reader->bytes || header->table_offset % SNAPSHOT_ALIGN != 0 ||
+        header->column_count > reader->bytes / sizeof(SnapshotEntry) || table_end < header->table_offset ||
+        table_end > reader->bytes) {
+        LOG_ERROR("snapshot: '%s' is truncated or corrupt", path);
+        return false;
+    }
+    const SnapshotEntry *entries = (const SnapshotEntry *)(reader->base + header->table_offset);
+    for (uint64_t e = 0; e < header->column_count; ++e) {
+        const SnapshotEntry *entry = &entries[e];
+        bool ok = memchr(entry->name, '\0', SNAPSHOT_NAME_MAX) != NULL && entry->elem_size > 0 &&
+                  entry->offset % SNAPSHOT_ALIGN == 0 && entry->offset <= header->table_offset &&
+                  entry->count <= (header->table_offset - entry->offset) / entry->elem_size;
+        if (!ok) {
+            LOG_ERROR("snapshot: '%s' has a corrupt column table", path);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool snapshot_reader_open(SnapshotReader **out_reader, const char *path, uint32_t version) {
+    if (!out_reader || !path) {
+        return false;
+    }
+    SnapshotReader *reader = (SnapshotReader *)calloc(1, sizeof(SnapshotReader));
+    if (!reader) {
+        LOG_ERROR("snapshot: allocation failed");
+        return false;
+    }
+    reader->base = snapshot_map(path, &reader->bytes);
+    if (!reader->base) {
+        LOG_ERROR("snapshot: cannot read '%s'", path);
+        free(reader);
+        return false;
+    }
+    if (!snapshot_validate(reader, version, path)) {
+        snapshot_reader_close(reader);
+        return false;
+    }
+    const SnapshotHeader *header = (const SnapshotHeader *)reader->base;
+    reader->entries = (const SnapshotEntry *)(reader->base + header->table_offset);
+    reader->entry_count = (size_t)header->column_count;
+    *out_reader = reader;
+    return true;
+}
+
+void *snapshot_column(const SnapshotReader *reader, const char *name, size_t elem_size, size_t *out_count) {
+    if (out_count) {
+        *out_count = 0;
+    }
+    if (!reader || !name) {
+        return NULL;
+    }
+    for (size_t e = 0; e < reader->entry_count; ++e) {
+        const SnapshotEntry *entry = &reader->entries[e];
+        if (strcmp(entry->name, name) != 0) {
+            continue;
+        }
+        if (entry->elem_size != elem_size) {
+            LOG_ERROR("snapshot: column '%s' has %llu-byte elements, expected %zu",
+                      name,
+                      (unsigned long long)entry->elem_size,
+                      elem_size);
+            return NULL;
+        }
+        if (out_count) {
+            *out_count = (size_t)entry->count;
+        }
+        return entry->count > 0 ? reader->base + entry->offset : NULL;
+    }
+    return NULL;
+}
+
+size_t snapshot_column_count(const SnapshotReader *reader) {
+    return reader ? reader->entry_count : 0;
+}
+
+void *snapshot_column_at(const SnapshotReader *reader,
+                         size_t index,
+                         const char **out_name,
+                         size_t *out_elem_size,
+                         size_t *out_count) {
+    if (!reader || index >= reader->entry_count) {
+        return NULL;
+    }
+    const SnapshotEntry *entry = &reader->entries[index];
+    if (out_name) {
+        *out_name = entry->name;
+    }
+    if (out_elem_size) {
+        *out_elem_size = (size_t)entry->elem_size;
+    }
+    if (out_count) {
+        *out_count = (size_t)entry->count;
+    }
+    return entry->count > 0 ? reader->base + entry->offset : NULL;
+}
+
+bool snapshot_read(const SnapshotReader *reader, const char *name, void *out, size_t elem_size, size_t count) {
+    size_t found = 0;
+    const void *data = snapshot_column(reader, name, elem_size, &found);
+    if (found != count || (count > 0 && (!data || !out))) {
+        LOG_ERROR("snapshot: column '%s' is missing or has %zu elements, expected %zu", name, found, count);
+        return false;
+    }
+    if (count > 0) {
+        memcpy(out, data, elem_size * count);
+    }
+    return true;
+}
+
+bool snapshot_reader_owns(const SnapshotReader *reader, const void *ptr) {
+    if (!reader || !ptr) {
+        return false;
+    }
+    const uint8_t *p = (const uint8_t *)ptr;
+    return p >= reader->base && p < reader->base + reader->bytes;
+}
+
+void snapshot_reader_close(SnapshotReader *reader) {
+    if (!reader) {
+        return;
+    }
+    if (reader->heap) {
+        snapshot_image_free(reader->base);
+    } else if (reader->base) {
+        snapshot_unmap(reader->base, reader->bytes);
+    }
+    free(reader);
+}
@@ -0,0 +1,184 @@
+#include "util/spsc.h"
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <stdatomic.h>
+#endif
+
+#include "util/log.h"
+
+// Interlocked calls are full barriers, so they serve as both the acquire loads
+// and the release stores below.
+#ifdef _WIN32
+typedef volatile LONG64 SpscCounter;
+typedef volatile LONG SpscWord;
+
+static uint64_t spsc_load_acquire(SpscCounter *counter) {
+    return (uint64_t)InterlockedCompareExchange64(counter, 0, 0);
+}
+
+static void spsc_store_release(SpscCounter *counter, uint64_t value) {
+    InterlockedExchange64(counter, (LONG64)value);
+}
+
+static unsigned spsc_word_load(SpscWord *word) {
+    return (unsigned)InterlockedCompareExchange(word, 0, 0);
+}
+
+static unsigned spsc_word_exchange(SpscWord *word, unsigned value) {
+    return (unsigned)InterlockedExchange(word, (LONG)value);
+}
+#else
+typedef _Atomic uint64_t SpscCounter;
+typedef _Atomic unsigned SpscWord;
+
+static uint64_t spsc_load_acquire(SpscCounter *counter) {
+    return atomic_load_explicit(counter, memory_order_acquire);
+}
+
+static void spsc_store_release(SpscCounter *counter, uint64_t value) {
+    atomic_store_explicit(counter, value, memory_order_release);
+}
+
+static unsigned spsc_word_load(SpscWord *word) {
+    return atomic_load_explicit(word, memory_order_acquire);
+}
+
+static unsigned spsc_word_exchange(SpscWord *word, unsigned value) {
+    return atomic_exchange_explicit(word, value, memory_order_acq_rel);
+}
+#endif
+
+#define SPSC_CACHE_LINE_BYTES 64u
+
+// head is written only by the consumer and tail only by the producer; each
+// sits on its own cache line next to the other side's cached copy.
+struct SpscQueue {
+    SpscCounter head;
+    uint64_t tail_cache;  // consumer's last view of tail
+    uint8_t pad0[SPSC_CACHE_LINE_BYTES - sizeof(SpscCounter) - sizeof(uint64_t)];
+    SpscCounter tail;
+    uint64_t head_cache;  // producer's last view of head
+    uint8_t pad1[SPSC_CACHE_LINE_BYTES - sizeof(SpscCounter) - sizeof(uint64_t)];
+    size_t elem_size;
+    uint64_t mask;
+    uint8_t *slots;
+};
+
+bool spsc_queue_create(SpscQueue **out_queue, size_t elem_size, size_t capacity) {
+    if (!out_queue || elem_size == 0 || capacity == 0 || capacity > ((size_t)1 << 30)) {
+        return false;
+    }
+    size_t rounded = 1;
+    while (rounded < capacity) {
+        rounded <<= 1;
+    }
+    SpscQueue *queue = (SpscQueue *)calloc(1, sizeof(SpscQueue));
+    uint8_t *slots = (uint8_t *)malloc(rounded * elem_size);
+    if (!queue || !slots) {
+        LOG_ERROR("spsc: allocation failed");
+        free(queue);
+        free(slots);
+        return false;
+    }
+    queue->elem_size = elem_size;
+    queue->mask = rounded - 1u;
+    queue->slots = slots;
+    *out_queue = queue;
+    return true;
+}
+
+void spsc_queue_destroy(SpscQueue *queue) {
+    if (!queue) {
+        return;
+    }
+    free(queue->slots);
+    free(queue);
+}
+
+bool spsc_queue_push(SpscQueue *queue, const void *elem) {
+    uint64_t tail = queue->tail;  // only this thread writes tail
+    if (tail - queue->head_cache > queue->mask) {
+        queue->head_cache = spsc_load_acquire(&queue->head);
+        if (tail - queue->head_cache > queue->mask) {
+            return false;
+        }
+    }
+    memcpy(queue->slots + (size_t)(tail & queue->mask) * queue->elem_size, elem, queue->elem_size);
+    spsc_store_release(&queue->tail, tail + 1u);
+    return true;
+}
+
+bool spsc_queue_pop(SpscQueue *queue, void *out_elem) {
+    uint64_t head = queue->head;  // only this thread writes head
+    if (head == queue->tail_cache) {
+        queue->tail_cache = spsc_load_acquire(&queue->tail);
+        if (head == queue->tail_cache) {
+            return false;
+        }
+    }
+    memcpy(out_elem, queue->slots + (size_t)(head & queue->mask) * queue->elem_size, queue->elem_size);
+    spsc_store_release(&queue->head, head + 1u);
+    return true;
+}
+
+// The shared word holds the middle slot index, plus SPSC_FRESH when it was
+// published after the consumer last took one.
+#define SPSC_FRESH 4u
+#define SPSC_SLOT_MASK 3u
+
+struct SpscTripleBuffer {
+    SpscWord middle;
+    uint8_t pad[SPSC_CACHE_LINE_BYTES - sizeof(SpscWord)];
+    unsigned back;   // producer's slot
+    uint8_t pad1[SPSC_CACHE_LINE_BYTES - sizeof(unsigned)];
+    unsigned front;  // consumer's slot
+};
+
+bool spsc_triple_buffer_create(SpscTripleBuffer **out_buffer) {
+    if (!out_buffer) {
+        return false;
+    }
+    SpscTripleBuffer *buffer = (SpscTripleBuffer *)calloc(1, sizeof(SpscTripleBuffer));
+    if (!buffer) {
+        LOG_ERROR("spsc: allocation failed");
+        return false;
+    }
+    buffer->back = 0;
+    spsc_word_exchange(&buffer->middle, 1u);
+    buffer->front = 2;
+    *out_buffer = buffer;
+    return true;
+}
+
+void spsc_triple_buffer_destroy(SpscTripleBuffer *buffer) {
+    free(buffer);
+}
+
+unsigned spsc_triple_buffer_write_slot(const SpscTripleBuffer *buffer) {
+    return buffer->back;
+}
+
+void spsc_triple_buffer_publish(SpscTripleBuffer *buffer) {
+    unsigned previous = spsc_word_exchange(&buffer->middle, buffer->back | SPSC_FRESH);
+    buffer->back = previous & SPSC_SLOT_MASK;
+}
+
+bool spsc_triple_buffer_acquire(SpscTripleBuffer *buffer) {
+    if ((spsc_word_load(&buffer->middle) & SPSC_FRESH) == 0) {
+        return false;
+    }
+    unsigned previous = spsc_word_exchange(&buffer->middle, buffer->front);
+    buffer->front = previous & SPSC_SLOT_MASK;
+    return true;
+}
+
+unsigned spsc_triple_buffer_read_slot(const SpscTripleBuffer *buffer) {
+    return buffer->front;
+}
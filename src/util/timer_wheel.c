@@ -0,0 +1,195 @@
+#include "util/timer_wheel.h"
+
+#include <stdlib.h>
+
+#define TIMER_WHEEL_LEVELS 4u
+#define TIMER_WHEEL_SLOT_BITS 6u
+#define TIMER_WHEEL_SLOTS (1u << TIMER_WHEEL_SLOT_BITS)
+#define TIMER_WHEEL_SLOT_MASK (TIMER_WHEEL_SLOTS - 1u)
+#define TIMER_WHEEL_NONE UINT32_MAX
+#define TIMER_WHEEL_UNSCHEDULED UINT16_MAX
+
+struct TimerWheel {
+    size_t capacity;
+    uint64_t now;
+    size_t scheduled_count;
+    uint64_t *due;
+    uint32_t *next;
+    uint32_t *prev;
+    uint16_t *bucket;  // level * TIMER_WHEEL_SLOTS + slot, or TIMER_WHEEL_UNSCHEDULED
+    uint32_t heads[TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS];
+};
+
+static void timer_wheel_link(TimerWheel *wheel, uint32_t id) {
+    uint64_t due = wheel->due[id];
+    uint64_t delta = due > wheel->now ? due - wheel->now : 0u;
+    unsigned level = 0;
+    while (level + 1u < TIMER_WHEEL_LEVELS && delta >= (UINT64_C(1) << (TIMER_WHEEL_SLOT_BITS * (level + 1u)))) {
+        ++level;
+    }
+    unsigned slot = (unsigned)(due >> (TIMER_WHEEL_SLOT_BITS * level)) & TIMER_WHEEL_SLOT_MASK;
+    uint16_t bucket = (uint16_t)(level * TIMER_WHEEL_SLOTS + slot);
+    uint32_t head = wheel->heads[bucket];
+    wheel->next[id] = head;
+    wheel->prev[id] = TIMER_WHEEL_NONE;
+    if (head != TIMER_WHEEL_NONE) {
+        wheel->prev[head] = id;
+    }
+    wheel->heads[bucket] = id;
+    wheel->bucket[id] = bucket;
+}
+
+static void timer_wheel_unlink(TimerWheel *wheel, uint32_t id) {
+    uint16_t bucket = wheel->bucket[id];
+    uint32_t next = wheel->next[id];
+    uint32_t prev = wheel->prev[id];
+    if (prev != TIMER_WHEEL_NONE) {
+        wheel->next[prev] = next;
+    } else {
+        wheel->heads[bucket] = next;
+    }
+    if (next != TIMER_WHEEL_NONE) {
+        wheel->prev[next] = prev;
+    }
+    wheel->bucket[id] = TIMER_WHEEL_UNSCHEDULED;
+}
+
+// Re-files every entry of one upper-level slot relative to the current tick.
+static void timer_wheel_cascade(TimerWheel *wheel, unsigned level) {
+    unsigned slot = (unsigned)(wheel->now >> (TIMER_WHEEL_SLOT_BITS * level)) & TIMER_WHEEL_SLOT_MASK;
+    uint16_t bucket = (uint16_t)(level * TIMER_WHEEL_SLOTS + slot);
+    uint32_t id = wheel->heads[bucket];
+    wheel->heads[bucket] = TIMER_WHEEL_NONE;
+    while (id != TIMER_WHEEL_NONE) {
+        uint32_t next = wheel->next[id];
+        timer_wheel_link(wheel, id);
+        id = next;
+    }
+}
+
+bool timer_wheel_create(TimerWheel **out_wheel, size_t capacity, uint64_t now) {
+    if (!out_wheel || capacity >= TIMER_WHEEL_NONE) {
+        return false;
+    }
+    TimerWheel *wheel = (TimerWheel *)calloc(1, sizeof(TimerWheel));
+    if (!wheel) {
+        return false;
+    }
+    size_t alloc_count = capacity > 0 ? capacity : 1u;
+    wheel->capacity = capacity;
+    wheel->due = (uint64_t *)calloc(alloc_count, sizeof(uint64_t));
+    wheel->next = (uint32_t *)calloc(alloc_count, sizeof(uint32_t));
+    wheel->prev = (uint32_t *)calloc(alloc_count, sizeof(uint32_t));
+    wheel->bucket = (uint16_t *)calloc(alloc_count, sizeof(uint16_t));
+    if (!wheel->due || !wheel->next || !wheel->prev || !wheel->bucket) {
+        timer_wheel_destroy(wheel);
+        return false;
+    }
+    timer_wheel_reset(wheel, now);
+    *out_wheel = wheel;
+    return true;
+}
+
+void timer_wheel_destroy(TimerWheel *wheel) {
+    if (!wheel) {
+        return;
+    }
+    free(wheel->due);
+    free(wheel->next);
+    free(wheel->prev);
+    free(wheel->bucket);
+    free(wheel);
+}
+
+void timer_wheel_reset(TimerWheel *wheel, uint64_t now) {
+    if (!wheel) {
+        return;
+    }
+    for (size_t b = 0; b < TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS; ++b) {
+        wheel->heads[b] = TIMER_WHEEL_NONE;
+    }
+    for (size_t i = 0; i < wheel->capacity; ++i) {
+        wheel->bucket[i] = TIMER_WHEEL_UNSCHEDULED;
+    }
+    wheel->now = now;
+    wheel->scheduled_count = 0;
+}
+
+void timer_wheel_schedule(TimerWheel *wheel, uint32_t id, uint64_t due_tick) {
+    if (!wheel || id >= wheel->capacity) {
+        return;
+    }
+    if (wheel->bucket[id] != TIMER_WHEEL_UNSCHEDULED) {
+        timer_wheel_unlink(wheel, id);
+    } else {
+        wheel->scheduled_count++;
+    }
+    if (due_tick <= wheel->now) {
+        due_tick = wheel->now + 1u;
+    }
+    if (due_tick - wheel->now >= TIMER_WHEEL_SPAN) {
+        due_tick = wheel->now + TIMER_WHEEL_SPAN - 1u;
+    }
+    wheel->due[id] = due_tick;
+    timer_wheel_link(wheel, id);
+}
+
+void timer_wheel_cancel(TimerWheel *wheel, uint32_t id) {
+    if (!wheel || id >= wheel->capacity || wheel->bucket[id] == TIMER_WHEEL_UNSCHEDULED) {
+        return;
+    }
+    timer_wheel_unlink(wheel, id);
+    wheel->scheduled_count--;
+}
+
+size_t timer_wheel_capacity(const TimerWheel *wheel) {
+    return wheel ? wheel->capacity : 0u;
+}
+
+size_t timer_wheel_bytes_per_entry(void) {
+    return sizeof(uint64_t) + 2u * sizeof(uint32_t) + sizeof(uint16_t);  // due, next, prev, bucket
+}
+
+bool timer_wheel_scheduled(const TimerWheel *wheel, uint32_t id) {
+    return wheel && id < wheel->capacity && wheel->bucket[id] != TIMER_WHEEL_UNSCHEDULED;
+}
+
+uint64_t timer_wheel_due(const TimerWheel *wheel, uint32_t id) {
+    return timer_wheel_scheduled(wheel, id) ? wheel->due[id] : UINT64_MAX;
+}
+
+size_t timer_wheel_advance(TimerWheel *wheel, uint64_t now, TimerWheelFn fn, void *user_data) {
+    if (!wheel) {
+        return 0;
+    }
+    size_t fired = 0;
+    while (wheel->now < now) {
+        if (wheel->scheduled_count == 0) {
+            wheel->now = now;
+            break;
+        }
+        uint64_t t = ++wheel->now;
+        if ((t & TIMER_WHEEL_SLOT_MASK) == 0) {
+            for (unsigned level = TIMER_WHEEL_LEVELS - 1u; level > 0; --level) {
+                uint64_t level_mask = (UINT64_C(1) << (TIMER_WHEEL_SLOT_BITS * level)) - 1u;
+                if ((t & level_mask) == 0) {
+                    timer_wheel_cascade(wheel, level);
+                }
+            }
+        }
+        uint16_t bucket = (uint16_t)(t & TIMER_WHEEL_SLOT_MASK);
+        uint32_t id = wheel->heads[bucket];
+        wheel->heads[bucket] = TIMER_WHEEL_NONE;
+        while (id != TIMER_WHEEL_NONE) {
+            uint32_t next = wheel->next[id];
+            wheel->bucket[id] = TIMER_WHEEL_UNSCHEDULED;
+            wheel->scheduled_count--;
+            ++fired;
+            if (fn) {
+                fn(user_data, id);
+            }
+            id = next;
+        }
+    }
+    return fired;
+}
@@ -6,8 +6,12 @@
 #include <string.h>
 
 #include "util/log.h"
+#include "util/snapshot.h"
 #include "world/tiles/tile_flower.h"
-#include <corecrt_math_defines.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
 
 typedef struct HiveStorageTilePayload {
     size_t tile_index;
@@ -162,17 +166,18 @@ static int compare_candidate_desc(const void *lhs, const void *rhs) {
     return 0;
 }
 
-static void assign_tile_properties(HexTile *tile, HexTerrain terrain) {
-    if (!tile) {
+static void assign_tile_properties(HexWorld *world, size_t index, HexTerrain terrain) {
+    if (!world || index >= world->tile_count) {
         return;
     }
+    HexTile *tile = &world->tiles[index];
     tile->terrain = terrain;
-    tile->nectar_stock = 0.0f;
-    tile->nectar_capacity = 0.0f;
-    tile->nectar_recharge_rate = 0.0f;
-    tile->nectar_recharge_multiplier = 1.0f;
-    tile->flower_quality = 0.0f;
-    tile->flower_viscosity = 1.0f;
+    world->nectar_stock[index] = 0.0f;
+    world->nectar_capacity[index] = 0.0f;
+    world->nectar_recharge_rate[index] = 0.0f;
+    world->nectar_recharge_multiplier[index] = 1.0f;
+    world->flower_quality[index] = 0.0f;
+    world->flower_viscosity[index] = 1.0f;
     tile->patch_id = -1;
     tile->flow_capacity = 10.0f;
     tile->flower_archetype_id = 0;
@@ -212,11 +217,11 @@ static void assign_tile_properties(HexTile *tile, HexTerrain terrain) {
             tile->base_cost = 0.7f;
             break;
         case HEX_TERRAIN_FLOWERS:
-            tile->nectar_capacity = 180.0f;
-            tile->nectar_stock = 120.0f;
-            tile->nectar_recharge_rate = 12.0f;
-            tile->flower_quality = 0.75f;
-            tile->flower_viscosity = 1.0f;
+            world->nectar_capacity[index] = 180.0f;
+            world->nectar_stock[index] = 120.0f;
+            world->nectar_recharge_rate[index] = 12.0f;
+            world->flower_quality[index] = 0.75f;
+            world->flower_viscosity[index] = 1.0f;
             tile->flow_capacity = 18.0f;
             break;
         case HEX_TERRAIN_OPEN:
@@ -226,6 +231,8 @@ static void assign_tile_properties(HexTile *tile, HexTerrain terrain) {
     }
 }
 
+static void hex_world_floral_recount(HexWorld *world);
+
 static bool hex_world_build(HexWorld *world, const Params *params) {
     if (!world || !params) {
         return false;
@@ -258,10 +265,12 @@ static bool hex_world_build(HexWorld *world, const Params *params) {
     HexTile *tiles = (HexTile *)calloc(tile_count, sizeof(HexTile));
     float *centers = (float *)malloc(center_bytes);
     uint32_t *colors = (uint32_t *)malloc(tile_count * sizeof(uint32_t));
-    if (!tiles || !centers || !colors) {
+    uint8_t *flags = (uint8_t *)calloc(tile_count, sizeof(uint8_t));
+    if (!tiles || !centers || !colors || !flags) {
         free(tiles);
         free(centers);
         free(colors);
+        free(flags);
         LOG_ERROR("hex: allocation failed for %zu tiles", tile_count);
         return false;
     }
@@ -274,6 +283,7 @@ static bool hex_world_build(HexWorld *world, const Params *params) {
             free(tiles);
             free(centers);
             free(colors);
+            free(flags);
             LOG_ERROR("hex: failed to allocate flower system");
             return false;
         }
@@ -298,6 +308,7 @@ static bool hex_world_build(HexWorld *world, const Params *params) {
     world->tiles = tiles;
     world->centers_world_xy = centers;
     world->fill_rgba = colors;
+    world->tile_flags = flags;
 
     hex_world_setup_palette(world);
 
@@ -306,6 +317,19 @@ static bool hex_world_build(HexWorld *world, const Params *params) {
     if (flower_entry && flower_entry->vtable && flower_entry->vtable->on_world_reset) {
         flower_entry->vtable->on_world_reset(flower_entry->user_data, world, tile_count);
     }
+    FlowerSystem *flowers = world->flower_system;
+    if (!flowers->stock || flowers->tile_capacity < tile_count) {
+        LOG_ERROR("hex: flower system has no nectar columns for %zu tiles", tile_count);
+        return false;
+    }
+    // The hot per-tile nectar columns are owned by the flower system (one
+    // allocation behind stock); the world only aliases them.
+    world->nectar_stock = flowers->stock;
+    world->nectar_capacity = flowers->capacity;
+    world->nectar_recharge_rate = flowers->recharge_rate;
+    world->nectar_recharge_multiplier = flowers->recharge_multiplier;
+    world->flower_quality = flowers->quality;
+    world->flower_viscosity = flowers->viscosity;
 
     HiveSystem *hive = NULL;
     HiveEntranceCandidate *entrance_candidates = NULL;
@@ -459,7 +483,7 @@ static bool hex_world_build(HexWorld *world, const Params *params) {
                 }
             }
 
-            assign_tile_properties(tile, terrain);
+            assign_tile_properties(world, index, terrain);
             if (terrain == HEX_TERRAIN_HIVE_STORAGE) {
                 tile->hive_honey_capacity = 900.0f;
                 size_t slot_index = storage_index_count;
@@ -521,7 +545,7 @@ static bool hex_world_build(HexWorld *world, const Params *params) {
                 }
                 hive->entrance_tile_indices[i] = idx;
                 HexTile *tile = &tiles[idx];
-                assign_tile_properties(tile, HEX_TERRAIN_HIVE_ENTRANCE);
+                assign_tile_properties(world, idx, HEX_TERRAIN_HIVE_ENTRANCE);
                 uint32_t base_color = world->palette[tile->terrain];
                 colors[idx] = base_color;
             }
@@ -562,6 +586,10 @@ static bool hex_world_build(HexWorld *world, const Params *params) {
     free(entrance_candidates);
 
     hex_world_apply_palette(world, false);
+    for (size_t i = 0; i < tile_count; ++i) {
+        hex_world_tile_refresh_flags(world, i);
+    }
+    hex_world_floral_recount(world);
 
     LOG_INFO("hex: built grid %d x %d (%zu tiles) radius=%.1f", width, height, tile_count, radius);
     return true;
@@ -610,9 +638,223 @@ void hex_world_shutdown(HexWorld *world) {
     free(world->tiles);
     free(world->centers_world_xy);
     free(world->fill_rgba);
+    free(world->tile_flags);
     memset(world, 0, sizeof(*world));
 }
 
+typedef struct HexSnapshotMeta {
+    uint64_t tile_count;
+    uint64_t floral_available_count;
+    float origin_x;
+    float origin_y;
+    float cell_radius;
+    float sqrt3;
+    float inv_cell_radius;
+    int32_t q_min;
+    int32_t q_max;
+    int32_t r_min;
+    int32_t r_max;
+    int32_t width;
+    int32_t height;
+    uint32_t has_hive;
+} HexSnapshotMeta;
+
+typedef struct HiveSnapshotMeta {
+    float center_x;
+    float center_y;
+    float honey_total_uL;
+    float pollen_total_uL;
+    int32_t center_q;
+    int32_t center_r;
+    int32_t radius_tiles;
+    int32_t storage_radius_tiles;
+    uint32_t enabled;
+} HiveSnapshotMeta;
+
+bool hex_world_snapshot_write(const HexWorld *world, SnapshotWriter *writer) {
+    if (!world || !writer || !world->tiles || !world->flower_system) {
+        return false;
+    }
+    size_t n = world->tile_count;
+    const HiveSystem *hive = world->hive_system;
+    HexSnapshotMeta meta = {
+        .tile_count = n,
+        .floral_available_count = world->floral_available_count,
+        .origin_x = world->origin_x,
+        .origin_y = world->origin_y,
+        .cell_radius = world->cell_radius,
+        .sqrt3 = world->sqrt3,
+        .inv_cell_radius = world->inv_cell_radius,
+        .q_min = world->q_min,
+        .q_max = world->q_max,
+        .r_min = world->r_min,
+        .r_max = world->r_max,
+        .width = world->width,
+        .height = world->height,
+        .has_hive = hive ? 1u : 0u,
+    };
+    bool ok = snapshot_write(writer, "hex.meta", &meta, sizeof(meta), 1);
+    ok = ok && snapshot_write(writer, "hex.tiles", world->tiles, sizeof(HexTile), n);
+    ok = ok && snapshot_write(writer, "hex.centers_world_xy", world->centers_world_xy, sizeof(float), 2u * n);
+    ok = ok && snapshot_write(writer, "hex.fill_rgba", world->fill_rgba, sizeof(uint32_t), n);
+    ok = ok && snapshot_write(writer, "hex.tile_flags", world->tile_flags, sizeof(uint8_t), n);
+    ok = ok && snapshot_write(writer, "hex.palette", world->palette, sizeof(uint32_t), HEX_TERRAIN_COUNT);
+    ok = ok && snapshot_write(writer,
+                              "hex.floral_by_archetype",
+                              world->floral_available_by_archetype,
+                              sizeof(size_t),
+                              TILE_FLOWER_ARCHETYPE_COUNT);
+    ok = ok && tile_flower_snapshot_write(world->flower_system, writer);
+    if (ok && hive) {
+        HiveSnapshotMeta hive_meta = {
+            .center_x = hive->center_x,
+            .center_y = hive->center_y,
+            .honey_total_uL = hive->honey_total_uL,
+            .pollen_total_uL = hive->pollen_total_uL,
+            .center_q = hive->center_q,
+            .center_r = hive->center_r,
+            .radius_tiles = hive->radius_tiles,
+            .storage_radius_tiles = hive->storage_radius_tiles,
+            .enabled = hive->enabled ? 1u : 0u,
+        };
+        ok = snapshot_write(writer, "hive.meta", &hive_meta, sizeof(hive_meta), 1);
+        ok = ok && snapshot_write(writer,
+                                  "hive.storage_tiles",
+                                  hive->storage_tiles,
+                                  sizeof(HiveStorageTilePayload),
+                                  hive->storage_tile_count);
+        ok = ok && snapshot_write(writer,
+                                  "hive.entrance_tiles",
+                                  hive->entrance_tile_indices,
+                                  sizeof(size_t),
+                                  hive->entrance_tile_count);
+    }
+    return ok;
+}
+
+static bool hex_world_snapshot_read_hive(HexWorld *world, const SnapshotReader *reader) {
+    HiveSnapshotMeta meta;
+    size_t storage_count = 0;
+    size_t entrance_count = 0;
+    snapshot_column(reader, "hive.storage_tiles", sizeof(HiveStorageTilePayload), &storage_count);
+    snapshot_column(reader, "hive.entrance_tiles", sizeof(size_t), &entrance_count);
+    HiveSystem *hive = (HiveSystem *)calloc(1, sizeof(HiveSystem));
+    if (!hive) {
+        LOG_ERROR("hex: failed to allocate hive system");
+        return false;
+    }
+    world->hive_system = hive;
+    hive->storage_tiles = (HiveStorageTilePayload *)calloc(storage_count > 0 ? storage_count : 1u,
+                                                           sizeof(HiveStorageTilePayload));
+    hive->entrance_tile_indices = (size_t *)calloc(entrance_count > 0 ? entrance_count : 1u, sizeof(size_t));
+    if (!hive->storage_tiles || !hive->entrance_tile_indices ||
+        !snapshot_read(reader, "hive.meta", &meta, sizeof(meta), 1) ||
+        !snapshot_read(reader, "hive.storage_tiles", hive->storage_tiles, sizeof(HiveStorageTilePayload), storage_count) ||
+        !snapshot_read(reader, "hive.entrance_tiles", hive->entrance_tile_indices, sizeof(size_t), entrance_count)) {
+        return false;
+    }
+    hive->storage_tile_count = storage_count;
+    hive->entrance_tile_count = entrance_count;
+    for (size_t i = 0; i < storage_count; ++i) {
+        if (hive->storage_tiles[i].tile_index >= world->tile_count) {
+            return false;
+        }
+    }
+    for (size_t i = 0; i < entrance_count; ++i) {
+        if (hive->entrance_tile_indices[i] >= world->tile_count) {
+            return false;
+        }
+    }
+    hive->enabled = meta.enabled != 0;
+    hive->center_x = meta.center_x;
+    hive->center_y = meta.center_y;
+    hive->center_q = meta.center_q;
+    hive->center_r = meta.center_r;
+    hive->radius_tiles = meta.radius_tiles;
+    hive->storage_radius_tiles = meta.storage_radius_tiles;
+    hive->honey_total_uL = meta.honey_total_uL;
+    hive->pollen_total_uL = meta.pollen_total_uL;
+    return true;
+}
+
+bool hex_world_snapshot_read(HexWorld *world, const SnapshotReader *reader) {
+    if (!world || !reader) {
+        return false;
+    }
+    HexSnapshotMeta meta;
+    if (!snapshot_read(reader, "hex.meta", &meta, sizeof(meta), 1)) {
+        return false;
+    }
+    size_t n = (size_t)meta.tile_count;
+    if (n == 0 || meta.width <= 0 || meta.height <= 0 || (uint64_t)meta.width * (uint64_t)meta.height != meta.tile_count) {
+        LOG_ERROR("hex: checkpoint has an invalid grid");
+        return false;
+    }
+
+    HexWorld temp;
+    memset(&temp, 0, sizeof(temp));
+    temp.origin_x = meta.origin_x;
+    temp.origin_y = meta.origin_y;
+    temp.cell_radius = meta.cell_radius;
+    temp.sqrt3 = meta.sqrt3;
+    temp.inv_cell_radius = meta.inv_cell_radius;
+    temp.q_min = meta.q_min;
+    temp.q_max = meta.q_max;
+    temp.r_min = meta.r_min;
+    temp.r_max = meta.r_max;
+    temp.width = meta.width;
+    temp.height = meta.height;
+    temp.tile_count = n;
+    temp.floral_available_count = (size_t)meta.floral_available_count;
+    temp.tiles = (HexTile *)calloc(n, sizeof(HexTile));
+    temp.centers_world_xy = (float *)malloc(n * 2u * sizeof(float));
+    temp.fill_rgba = (uint32_t *)malloc(n * sizeof(uint32_t));
+    temp.tile_flags = (uint8_t *)malloc(n * sizeof(uint8_t));
+    temp.flower_system = (FlowerSystem *)malloc(sizeof(FlowerSystem));
+    if (temp.flower_system) {
+        tile_flower_system_init(temp.flower_system);
+    }
+    bool ok = temp.tiles && temp.centers_world_xy && temp.fill_rgba && temp.tile_flags && temp.flower_system;
+    if (!ok) {
+        LOG_ERROR("hex: allocation failed for %zu tiles", n);
+    }
+    ok = ok && snapshot_read(reader, "hex.tiles", temp.tiles, sizeof(HexTile), n) &&
+         snapshot_read(reader, "hex.centers_world_xy", temp.centers_world_xy, sizeof(float), 2u * n) &&
+         snapshot_read(reader, "hex.fill_rgba", temp.fill_rgba, sizeof(uint32_t), n) &&
+         snapshot_read(reader, "hex.tile_flags", temp.tile_flags, sizeof(uint8_t), n) &&
+         snapshot_read(reader, "hex.palette", temp.palette, sizeof(uint32_t), HEX_TERRAIN_COUNT) &&
+         snapshot_read(reader,
+                       "hex.floral_by_archetype",
+                       temp.floral_available_by_archetype,
+                       sizeof(size_t),
+                       TILE_FLOWER_ARCHETYPE_COUNT) &&
+         tile_flower_snapshot_read(temp.flower_system, reader);
+    if (ok && temp.flower_system->tile_capacity < n) {
+        LOG_ERROR("hex: checkpoint flower system has no nectar columns for %zu tiles", n);
+        ok = false;
+    }
+    if (ok && meta.has_hive) {
+        ok = hex_world_snapshot_read_hive(&temp, reader);
+    }
+    if (!ok) {
+        hex_world_shutdown(&temp);
+        return false;
+    }
+
+    tile_registry_init(&temp.tile_registry);
+    tile_flower_register(&temp.tile_registry, temp.flower_system);
+    FlowerSystem *flowers = temp.flower_system;
+    temp.nectar_stock = flowers->stock;
+    temp.nectar_capacity = flowers->capacity;
+    temp.nectar_recharge_rate = flowers->recharge_rate;
+    temp.nectar_recharge_multiplier = flowers->recharge_multiplier;
+    temp.flower_quality = flowers->quality;
+    temp.flower_viscosity = flowers->viscosity;
+    *world = temp;
+    LOG_INFO("hex: restored grid %d x %d (%zu tiles) from checkpoint", temp.width, temp.height, n);
+    return true;
+}
+
 float hex_world_cell_radius(const HexWorld *world) {
     return world ? world->cell_radius : 0.0f;
 }
@@ -675,12 +917,14 @@ bool hex_world_tile_debug_info(const HexWorld *world, size_t index, HexTileDebug
     out_info->center_y = world->centers_world_xy[2 * index + 1];
     const HexTile *tile = &world->tiles[index];
     out_info->terrain = tile->terrain;
-    out_info->nectar_stock = tile->nectar_stock;
-    out_info->nectar_capacity = tile->nectar_capacity;
-    out_info->nectar_recharge_rate = tile->nectar_recharge_rate;
-    out_info->nectar_recharge_multiplier = tile->nectar_recharge_multiplier;
-    out_info->flower_quality = tile->flower_quality;
-    out_info->flower_viscosity = tile->flower_viscosity;
+    out_info->nectar_stock = hex_world_tile_nectar_stock(world, index);
+    out_info->nectar_capacity = world->nectar_capacity[index];
+    out_info->nectar_recharge_rate = world->nectar_recharge_rate[index];
+    out_info->nectar_recharge_multiplier = world->flower_system
+                                               ? tile_flower_recharge_multiplier(world->flower_system, index)
+                                               : world->nectar_recharge_multiplier[index];
+    out_info->flower_quality = world->flower_quality[index];
+    out_info->flower_viscosity = world->flower_viscosity[index];
     out_info->flow_capacity = tile->flow_capacity;
     out_info->flower_archetype_id = tile->flower_archetype_id;
     out_info->flower_archetype_name = NULL;
@@ -822,9 +1066,126 @@ bool hex_world_tile_is_floral(const HexWorld *world, size_t index) {
     if (entry && entry->vtable && entry->vtable->is_floral) {
         return entry->vtable->is_floral(entry->user_data, index);
     }
-    return tile->terrain == HEX_TERRAIN_FLOWERS && tile->nectar_capacity > 0.0f;
+    return tile->terrain == HEX_TERRAIN_FLOWERS && world->nectar_capacity[index] > 0.0f;
+}
+
+bool hex_world_tile_floral_available(const HexWorld *world, size_t index) {
+    if (!world || index >= world->tile_count) {
+        return false;
+    }
+    return (world->tile_flags[index] & HEX_TILE_FLAG_FLORAL) &&
+           hex_world_tile_nectar_stock(world, index) > HEX_FLORAL_AVAILABLE_UL;
+}
+
+float hex_world_tile_nectar_stock(const HexWorld *world, size_t index) {
+    if (!world || index >= world->tile_count) {
+        return 0.0f;
+    }
+    if (world->flower_system && world->flower_system->lazy) {
+        return tile_flower_stock(world->flower_system, index);
+    }
+    return world->nectar_stock[index];
+}
+
+bool hex_world_nectar_lazy(const HexWorld *world) {
+    return world && world->flower_system && world->flower_system->lazy;
+}
+
+void hex_world_tile_refresh_flags(HexWorld *world, size_t index) {
+    if (!world || !world->tile_flags || index >= world->tile_count) {
+        return;
+    }
+    const HexTile *tile = &world->tiles[index];
+    uint8_t flags = 0;
+    if (tile->passable) {
+        flags |= HEX_TILE_FLAG_PASSABLE;
+    }
+    if (tile->terrain == HEX_TERRAIN_HIVE_INTERIOR || tile->terrain == HEX_TERRAIN_HIVE_STORAGE ||
+        tile->terrain == HEX_TERRAIN_HIVE_ENTRANCE) {
+        flags |= HEX_TILE_FLAG_HIVE;
+    }
+    if (tile->terrain == HEX_TERRAIN_FLOWERS && world->nectar_capacity[index] > 0.0f) {
+        flags |= HEX_TILE_FLAG_FLORAL;
+    }
+    if (tile->hive_deposit_enabled) {
+        flags |= HEX_TILE_FLAG_DEPOSIT;
+    }
+    world->tile_flags[index] = flags;
+}
+
+uint8_t hex_world_tile_flags(const HexWorld *world, size_t index) {
+    if (!world || !world->tile_flags || index >= world->tile_count) {
+        return 0;
+    }
+    return world->tile_flags[index];
+}
+
+bool hex_world_tile_in_hive(const HexWorld *world, size_t index) {
+    return (hex_world_tile_flags(world, index) & HEX_TILE_FLAG_HIVE) != 0;
+}
+
+static void hex_world_floral_count_add(HexWorld *world, size_t index, int delta) {
+    world->floral_available_count = (size_t)((ptrdiff_t)world->floral_available_count + delta);
+    uint16_t archetype_id = world->tiles[index].flower_archetype_id;
+    if (archetype_id < TILE_FLOWER_ARCHETYPE_COUNT) {
+        size_t *slot = &world->floral_available_by_archetype[archetype_id];
+        *slot = (size_t)((ptrdiff_t)*slot + delta);
+    }
+}
+
+static void hex_world_floral_recount(HexWorld *world) {
+    world->floral_available_count = 0;
+    memset(world->floral_available_by_archetype, 0, sizeof(world->floral_available_by_archetype));
+    for (size_t i = 0; i < world->tile_count; ++i) {
+        if (hex_world_tile_floral_available(world, i)) {
+            hex_world_floral_count_add(world, i, 1);
+        }
+    }
+}
+
+void hex_world_floral_note_update(HexWorld *world, size_t index, bool was_available) {
+    if (!world || index >= world->tile_count) {
+        return;
+    }
+    bool available = hex_world_tile_floral_available(world, index);
+    if (available != was_available) {
+        hex_world_floral_count_add(world, index, available ? 1 : -1);
+    }
+}
+
+size_t hex_world_floral_available_count(const HexWorld *world) {
+    return world ? world->floral_available_count : 0;
+}
+
+size_t hex_world_floral_available_count_archetype(const HexWorld *world, uint16_t archetype_id) {
+    if (!world || archetype_id >= TILE_FLOWER_ARCHETYPE_COUNT) {
+        return 0;
+    }
+    return world->floral_available_by_archetype[archetype_id];
+}
+
+static float hex_world_viscosity_scale(const HexWorld *world, size_t index) {
+    float viscosity = world->flower_viscosity[index];
+    if (viscosity <= 0.0f) {
+        viscosity = 1.0f;
+    }
+    float viscosity_scale = 1.0f / sqrtf(viscosity);
+    if (viscosity_scale < 0.05f) {
+        viscosity_scale = 0.05f;
+    }
+    return viscosity_scale;
+}
+
+// Length of the run of requests sharing requests[0].tile_index.
+static size_t hex_world_request_run(const HexTileRequest *requests, size_t remaining) {
+    size_t run = 1;
+    while (run < remaining && requests[run].tile_index == requests[0].tile_index) {
+        ++run;
+    }
+    return run;
 }
 
+
 float hex_world_tile_harvest(HexWorld *world, size_t index, float request_uL, float *quality_out) {
     if (!world || index >= world->tile_count || request_uL <= 0.0f) {
         if (quality_out) {
@@ -840,59 +1201,107 @@ float hex_world_tile_harvest(HexWorld *world, size_t index, float request_uL, fl
         return 0.0f;
     }
 
-    float viscosity = tile->flower_viscosity;
-    if (viscosity <= 0.0f) {
-        viscosity = 1.0f;
-    }
-    float viscosity_scale = 1.0f / sqrtf(viscosity);
-    if (viscosity_scale < 0.05f) {
-        viscosity_scale = 0.05f;
-    }
-
-    float effective_request = request_uL * viscosity_scale;
+    float effective_request = request_uL * hex_world_viscosity_scale(world, index);
+    tile_flower_settle(world->flower_system, world, index);
+    bool was_available = hex_world_tile_floral_available(world, index);
 
     const TileTypeRegistration *entry = tile_registry_get(&world->tile_registry, tile->terrain);
     if (entry && entry->vtable && entry->vtable->harvest) {
         float harvested = entry->vtable->harvest(entry->user_data, world, index, effective_request, quality_out);
-        tile = &world->tiles[index];
+        hex_world_floral_note_update(world, index, was_available);
         if (quality_out && *quality_out <= 0.0f) {
-            *quality_out = tile->flower_quality;
+            *quality_out = world->flower_quality[index];
         }
         return harvested;
     }
 
     float harvest = effective_request;
-    if (harvest > tile->nectar_stock) {
-        harvest = tile->nectar_stock;
+    if (harvest > world->nectar_stock[index]) {
+        harvest = world->nectar_stock[index];
     }
     if (harvest <= 0.0f) {
         if (quality_out) {
-            *quality_out = tile->flower_quality;
+            *quality_out = world->flower_quality[index];
         }
         return 0.0f;
     }
 
-    tile->nectar_stock -= harvest;
-    if (tile->nectar_stock < 0.0f) {
-        tile->nectar_stock = 0.0f;
-    }
-    if (world->flower_system) {
-        tile_flower_override_payload(world->flower_system,
-                                     world,
-                                     index,
-                                     tile->nectar_capacity,
-                                     tile->nectar_stock,
-                                     tile->nectar_recharge_rate,
-                                     tile->nectar_recharge_multiplier,
-                                     tile->flower_quality,
-                                     tile->flower_viscosity);
+    world->nectar_stock[index] -= harvest;
+    if (world->nectar_stock[index] < 0.0f) {
+        world->nectar_stock[index] = 0.0f;
     }
+    tile_flower_touch(world->flower_system, index);
+    hex_world_floral_note_update(world, index, was_available);
     if (quality_out) {
-        *quality_out = tile->flower_quality;
+        *quality_out = world->flower_quality[index];
     }
     return harvest;
 }
 
+void hex_world_tile_harvest_resolve(HexWorld *world,
+                                    const HexTileRequest *requests,
+                                    size_t request_count,
+                                    float *out_granted_uL) {
+    if (!requests || !out_granted_uL) {
+        return;
+    }
+    size_t k = 0;
+    while (k < request_count) {
+        size_t run = hex_world_request_run(&requests[k], request_count - k);
+        size_t index = requests[k].tile_index;
+        for (size_t j = 0; j < run; ++j) {
+            out_granted_uL[k + j] = 0.0f;
+        }
+        if (!world || index >= world->tile_count || !hex_world_tile_is_floral(world, index)) {
+            k += run;
+            continue;
+        }
+
+        HexTile *tile = &world->tiles[index];
+        float viscosity_scale = hex_world_viscosity_scale(world, index);
+        float total_request = 0.0f;
+        for (size_t j = 0; j < run; ++j) {
+            if (requests[k + j].amount_uL > 0.0f) {
+                total_request += requests[k + j].amount_uL * viscosity_scale;
+            }
+        }
+        if (total_request <= 0.0f) {
+            k += run;
+            continue;
+        }
+
+        float taken = 0.0f;
+        tile_flower_settle(world->flower_system, world, index);
+        bool was_available = hex_world_tile_floral_available(world, index);
+        const TileTypeRegistration *entry = tile_registry_get(&world->tile_registry, tile->terrain);
+        if (entry && entry->vtable && entry->vtable->harvest) {
+            taken = entry->vtable->harvest(entry->user_data, world, index, total_request, NULL);
+        } else {
+            taken = total_request < world->nectar_stock[index] ? total_request : world->nectar_stock[index];
+            if (taken < 0.0f) {
+                taken = 0.0f;
+            }
+            world->nectar_stock[index] -= taken;
+            if (world->nectar_stock[index] < 0.0f) {
+                world->nectar_stock[index] = 0.0f;
+            }
+            tile_flower_touch(world->flower_system, index);
+        }
+        hex_world_floral_note_update(world, index, was_available);
+
+        if (taken > 0.0f) {
+            float share = taken >= total_request ? 1.0f : taken / total_request;
+            for (size_t j = 0; j < run; ++j) {
+                float amount = requests[k + j].amount_uL;
+                if (amount > 0.0f) {
+                    out_granted_uL[k + j] = amount * viscosity_scale * share;
+                }
+            }
+        }
+        k += run;
+    }
+}
+
 void hex_world_tile_set_floral(HexWorld *world,
                                size_t index,
                                float capacity,
@@ -903,37 +1312,31 @@ void hex_world_tile_set_floral(HexWorld *world,
     if (!world || index >= world->tile_count) {
         return;
     }
+    tile_flower_settle(world->flower_system, world, index);
+    bool was_available = hex_world_tile_floral_available(world, index);
     HexTile *tile = &world->tiles[index];
     tile->terrain = HEX_TERRAIN_FLOWERS;
-    tile->nectar_capacity = capacity >= 0.0f ? capacity : 0.0f;
+    world->nectar_capacity[index] = capacity >= 0.0f ? capacity : 0.0f;
     if (stock < 0.0f) {
         stock = 0.0f;
     }
-    if (stock > tile->nectar_capacity && tile->nectar_capacity > 0.0f) {
-        stock = tile->nectar_capacity;
+    if (stock > world->nectar_capacity[index] && world->nectar_capacity[index] > 0.0f) {
+        stock = world->nectar_capacity[index];
     }
-    tile->nectar_stock = stock;
-    tile->nectar_recharge_rate = recharge_rate >= 0.0f ? recharge_rate : 0.0f;
+    world->nectar_stock[index] = stock;
+    world->nectar_recharge_rate[index] = recharge_rate >= 0.0f ? recharge_rate : 0.0f;
     if (quality < 0.0f) quality = 0.0f;
     if (quality > 1.0f) quality = 1.0f;
-    tile->flower_quality = quality;
+    world->flower_quality[index] = quality;
     if (viscosity <= 0.0f) {
         viscosity = 1.0f;
     }
-    tile->flower_viscosity = viscosity;
-    tile->nectar_recharge_multiplier = 1.0f;
+    world->flower_viscosity[index] = viscosity;
+    world->nectar_recharge_multiplier[index] = 1.0f;
     tile->patch_id = -1;
-    if (world->flower_system) {
-        tile_flower_override_payload(world->flower_system,
-                                     world,
-                                     index,
-                                     tile->nectar_capacity,
-                                     tile->nectar_stock,
-                                     tile->nectar_recharge_rate,
-                                     tile->nectar_recharge_multiplier,
-                                     tile->flower_quality,
-                                     tile->flower_viscosity);
-    }
+    hex_world_tile_refresh_flags(world, index);
+    tile_flower_touch(world->flower_system, index);
+    hex_world_floral_note_update(world, index, was_available);
 }
 
 void hex_world_apply_palette(HexWorld *world, bool nectar_heatmap_enabled) {
@@ -953,17 +1356,14 @@ void hex_world_apply_palette(HexWorld *world, bool nectar_heatmap_enabled) {
 }
 
 bool hex_world_tile_passable(const HexWorld *world, size_t index) {
-    if (!world || index >= world->tile_count || !world->tiles) {
+    if (!world || index >= world->tile_count || !world->tile_flags) {
         return true;
     }
-    return world->tiles[index].passable;
+    return (world->tile_flags[index] & HEX_TILE_FLAG_PASSABLE) != 0;
 }
 
 bool hex_world_tile_allows_deposit(const HexWorld *world, size_t index) {
-    if (!world || index >= world->tile_count || !world->tiles) {
-        return false;
-    }
-    return world->tiles[index].hive_deposit_enabled;
+    return (hex_world_tile_flags(world, index) & HEX_TILE_FLAG_DEPOSIT) != 0;
 }
 
 static HiveStorageTilePayload *hive_lookup_storage(HexWorld *world, int16_t slot) {
@@ -1022,6 +1422,64 @@ float hex_world_hive_deposit_world(HexWorld *world, float world_x, float world_y
     return hex_world_hive_deposit_at_tile(world, primary_index, request_uL);
 }
 
+float hex_world_hive_deposit_resolve(HexWorld *world,
+                                     const HexTileRequest *requests,
+                                     size_t request_count,
+                                     float *out_accepted_uL) {
+    if (!requests || !out_accepted_uL) {
+        return 0.0f;
+    }
+    for (size_t k = 0; k < request_count; ++k) {
+        out_accepted_uL[k] = 0.0f;
+    }
+    if (!world || !world->hive_system || !world->hive_system->enabled || !world->tiles) {
+        return 0.0f;
+    }
+
+    float accepted_total = 0.0f;
+    size_t k = 0;
+    while (k < request_count) {
+        size_t run = hex_world_request_run(&requests[k], request_count - k);
+        size_t index = requests[k].tile_index;
+        HexTile *tile = index < world->tile_count ? &world->tiles[index] : NULL;
+        HiveStorageTilePayload *payload =
+            (tile && tile->hive_deposit_enabled) ? hive_lookup_storage(world, tile->hive_storage_slot) : NULL;
+        if (!payload) {
+            k += run;
+            continue;
+        }
+
+        float total_request = 0.0f;
+        for (size_t j = 0; j < run; ++j) {
+            if (requests[k + j].amount_uL > 0.0f) {
+                total_request += requests[k + j].amount_uL;
+            }
+        }
+        float capacity = payload->capacity_uL > 0.0f ? payload->capacity_uL : tile->hive_honey_capacity;
+        float space = capacity - payload->stock_uL;
+        if (total_request <= 0.0f || space <= 1e-6f) {
+            k += run;
+            continue;
+        }
+
+        float accepted = total_request < space ? total_request : space;
+        float share = accepted >= total_request ? 1.0f : accepted / total_request;
+        for (size_t j = 0; j < run; ++j) {
+            float amount = requests[k + j].amount_uL;
+            if (amount > 0.0f) {
+                out_accepted_uL[k + j] = amount * share;
+            }
+        }
+        payload->stock_uL += accepted;
+        tile->hive_honey_stock = payload->stock_uL;
+        accepted_total += accepted;
+        k += run;
+    }
+
+    world->hive_system->honey_total_uL += accepted_total;
+    return accepted_total;
+}
+
 float hex_world_hive_total_honey(const HexWorld *world) {
     if (!world || !world->hive_system || !world->hive_system->enabled) {
         return 0.0f;
@@ -1057,6 +1515,28 @@ bool hex_world_hive_center(const HexWorld *world, float *out_x, float *out_y) {
     return true;
 }
 
+bool hex_world_hive_bounds(const HexWorld *world, float *out_x, float *out_y, float *out_radius) {
+    if (!world || !world->hive_system || !world->hive_system->enabled) {
+        return false;
+    }
+    // Tiles sit around the center tile; a ring-k tile center is at most
+    // k * sqrt(3) cell radii away and its corners one cell radius further.
+    const HiveSystem *hive = world->hive_system;
+    float center_x = 0.0f;
+    float center_y = 0.0f;
+    hex_world_axial_to_world(world, hive->center_q, hive->center_r, &center_x, &center_y);
+    if (out_x) {
+        *out_x = center_x;
+    }
+    if (out_y) {
+        *out_y = center_y;
+    }
+    if (out_radius) {
+        *out_radius = ((float)hive->radius_tiles * world->sqrt3 + 1.0f) * world->cell_radius;
+    }
+    return true;
+}
+
 bool hex_world_hive_preferred_unload(const HexWorld *world, float *out_x, float *out_y) {
     if (!world || !world->hive_system || !world->hive_system->enabled) {
         return false;
@@ -6,8 +6,15 @@
 
 #include "hex.h"
 #include "util/log.h"
+#include "util/snapshot.h"
+#include "util/timer_wheel.h"
 
-#define INVALID_PAYLOAD_INDEX 0xFFFFFFFFu
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FLOWER_RECHARGE_SSE2 1
+#include <emmintrin.h>
+#endif
+
+#define FLOWER_FLOAT_COLUMN_COUNT 6u
 
 typedef enum FlowerArchetypeId {
     FLOWER_ARCHETYPE_CLOVER = 0,
@@ -17,6 +24,8 @@ typedef enum FlowerArchetypeId {
     FLOWER_ARCHETYPE_COUNT
 } FlowerArchetypeId;
 
+_Static_assert(FLOWER_ARCHETYPE_COUNT == TILE_FLOWER_ARCHETYPE_COUNT, "archetype table and public count disagree");
+
 static uint32_t pack_rgba(float r, float g, float b, float a) {
     uint32_t ri = (uint32_t)(fminf(fmaxf(r, 0.0f), 1.0f) * 255.0f + 0.5f);
     uint32_t gi = (uint32_t)(fminf(fmaxf(g, 0.0f), 1.0f) * 255.0f + 0.5f);
@@ -117,33 +126,34 @@ static bool ensure_capacity_generic(void **buffer, size_t element_size, size_t *
     return true;
 }
 
-static void flower_bind_payload(FlowerSystem *system, size_t tile_index, uint32_t payload_index) {
-    if (!system || tile_index >= system->tile_to_payload_capacity) {
-        return;
-    }
-    system->tile_to_payload[tile_index] = payload_index;
+static bool flower_tile_is_flower(const FlowerSystem *system, size_t tile_index) {
+    return system && system->is_flower && tile_index < system->tile_capacity && system->is_flower[tile_index];
 }
 
-static FlowerPayload *flower_payload_for_tile(FlowerSystem *system, size_t tile_index) {
-    if (!system || tile_index >= system->tile_to_payload_capacity) {
-        return NULL;
-    }
-    uint32_t payload_index = system->tile_to_payload[tile_index];
-    if (payload_index == INVALID_PAYLOAD_INDEX || payload_index >= system->payload_count) {
-        return NULL;
-    }
-    return &system->payloads[payload_index];
+static void flower_lazy_free(FlowerSystem *system) {
+    free(system->stock_time);
+    timer_wheel_destroy(system->crossings);
+    system->stock_time = NULL;
+    system->crossings = NULL;
+    system->lazy = false;
 }
 
-static const FlowerPayload *flower_payload_for_tile_const(const FlowerSystem *system, size_t tile_index) {
-    if (!system || tile_index >= system->tile_to_payload_capacity) {
-        return NULL;
-    }
-    uint32_t payload_index = system->tile_to_payload[tile_index];
-    if (payload_index == INVALID_PAYLOAD_INDEX || payload_index >= system->payload_count) {
-        return NULL;
-    }
-    return &system->payloads[payload_index];
+static void flower_free_columns(FlowerSystem *system) {
+    flower_lazy_free(system);
+    free(system->stock);  // owns every float column
+    free(system->archetype_id);
+    free(system->is_flower);
+    free(system->stock_changed);
+    system->stock = NULL;
+    system->capacity = NULL;
+    system->recharge_rate = NULL;
+    system->recharge_multiplier = NULL;
+    system->quality = NULL;
+    system->viscosity = NULL;
+    system->archetype_id = NULL;
+    system->is_flower = NULL;
+    system->stock_changed = NULL;
+    system->tile_capacity = 0;
 }
 
 void tile_flower_system_init(FlowerSystem *system) {
@@ -157,31 +167,53 @@ void tile_flower_system_shutdown(FlowerSystem *system) {
     if (!system) {
         return;
     }
-    free(system->payloads);
+    flower_free_columns(system);
     free(system->tile_indices);
-    free(system->tile_to_payload);
     memset(system, 0, sizeof(*system));
 }
 
-void tile_flower_system_reset(FlowerSystem *system, size_t tile_capacity) {
+bool tile_flower_system_reset(FlowerSystem *system, size_t tile_capacity) {
     if (!system) {
-        return;
+        return false;
     }
-    system->payload_count = 0;
+    flower_free_columns(system);
     system->tile_index_count = 0;
-    if (!ensure_capacity_generic((void **)&system->payloads, sizeof(FlowerPayload), &system->payload_capacity, tile_capacity)) {
-        LOG_ERROR("flower: failed to reserve %zu payload slots", tile_capacity);
-    }
-    if (!ensure_capacity_generic((void **)&system->tile_indices, sizeof(size_t), &system->tile_index_capacity, tile_capacity)) {
-        LOG_ERROR("flower: failed to reserve %zu tile indices", tile_capacity);
+    if (tile_capacity == 0) {
+        return true;
     }
-    if (!ensure_capacity_generic((void **)&system->tile_to_payload, sizeof(uint32_t), &system->tile_to_payload_capacity,
+    float *columns = (float *)malloc(tile_capacity * FLOWER_FLOAT_COLUMN_COUNT * sizeof(float));
+    uint16_t *archetypes = (uint16_t *)calloc(tile_capacity, sizeof(uint16_t));
+    uint8_t *is_flower = (uint8_t *)calloc(tile_capacity, sizeof(uint8_t));
+    uint64_t *changed = (uint64_t *)calloc((tile_capacity + 63u) / 64u, sizeof(uint64_t));
+    if (!columns || !archetypes || !is_flower || !changed ||
+        !ensure_capacity_generic((void **)&system->tile_indices, sizeof(size_t), &system->tile_index_capacity,
                                  tile_capacity)) {
-        LOG_ERROR("flower: failed to reserve %zu tile map entries", tile_capacity);
+        free(columns);
+        free(archetypes);
+        free(is_flower);
+        free(changed);
+        LOG_ERROR("flower: failed to allocate nectar columns for %zu tiles", tile_capacity);
+        return false;
     }
-    if (system->tile_to_payload) {
-        memset(system->tile_to_payload, 0xFF, system->tile_to_payload_capacity * sizeof(uint32_t));
+    system->stock = columns;
+    system->capacity = columns + tile_capacity;
+    system->recharge_rate = columns + 2u * tile_capacity;
+    system->recharge_multiplier = columns + 3u * tile_capacity;
+    system->quality = columns + 4u * tile_capacity;
+    system->viscosity = columns + 5u * tile_capacity;
+    system->archetype_id = archetypes;
+    system->is_flower = is_flower;
+    system->stock_changed = changed;
+    system->tile_capacity = tile_capacity;
+    for (size_t i = 0; i < tile_capacity; ++i) {
+        system->stock[i] = 0.0f;
+        system->capacity[i] = 0.0f;
+        system->recharge_rate[i] = 0.0f;
+        system->recharge_multiplier[i] = 1.0f;
+        system->quality[i] = 0.0f;
+        system->viscosity[i] = 1.0f;
     }
+    return true;
 }
 
 static void flower_on_world_reset(void *user_data, HexWorld *world, size_t tile_capacity) {
@@ -192,119 +224,78 @@ static void flower_on_world_reset(void *user_data, HexWorld *world, size_t tile_
 
 static void flower_generate_tile(void *user_data, HexWorld *world, TileId id, int q, int r, uint64_t rng_seed) {
     FlowerSystem *system = (FlowerSystem *)user_data;
-    if (!system || !world || id >= world->tile_count) {
+    if (!system || !world || id >= world->tile_count || id >= system->tile_capacity) {
         return;
     }
     FlowerArchetypeId archetype_id = pick_archetype(&rng_seed, q, r);
     const FlowerArchetype *archetype = &k_archetypes[archetype_id];
 
-    if (!ensure_capacity_generic((void **)&system->payloads, sizeof(FlowerPayload), &system->payload_capacity,
-                                 system->payload_count + 1)) {
-        return;
-    }
-    if (!ensure_capacity_generic((void **)&system->tile_indices, sizeof(size_t), &system->tile_index_capacity,
-                                 system->tile_index_count + 1)) {
-        return;
-    }
-    if (id >= system->tile_to_payload_capacity) {
-        size_t previous = system->tile_to_payload_capacity;
-        if (!ensure_capacity_generic((void **)&system->tile_to_payload, sizeof(uint32_t), &system->tile_to_payload_capacity,
-                                     id + 1)) {
+    if (!system->is_flower[id]) {
+        if (!ensure_capacity_generic((void **)&system->tile_indices, sizeof(size_t), &system->tile_index_capacity,
+                                     system->tile_index_count + 1)) {
             return;
         }
-        if (system->tile_to_payload && system->tile_to_payload_capacity > previous) {
-            memset(system->tile_to_payload + previous, 0xFF,
-                   (system->tile_to_payload_capacity - previous) * sizeof(uint32_t));
-        }
+        system->tile_indices[system->tile_index_count++] = id;
+        system->is_flower[id] = 1u;
     }
-
-    uint32_t payload_index = (uint32_t)system->payload_count;
-    system->payloads[payload_index] = (FlowerPayload){
-        .archetype_id = (uint16_t)archetype_id,
-        .capacity = archetype->capacity,
-        .stock = archetype->capacity * archetype->initial_fill,
-        .recharge_rate = archetype->recharge_rate,
-        .recharge_multiplier = archetype->recharge_multiplier_day,
-        .quality = archetype->quality,
-        .viscosity = archetype->viscosity,
-    };
-    system->payload_count++;
-
-    system->tile_indices[system->tile_index_count++] = id;
-    flower_bind_payload(system, id, payload_index);
+    system->archetype_id[id] = (uint16_t)archetype_id;
+    system->capacity[id] = archetype->capacity;
+    system->stock[id] = archetype->capacity * archetype->initial_fill;
+    system->recharge_rate[id] = archetype->recharge_rate;
+    system->recharge_multiplier[id] = archetype->recharge_multiplier_day;
+    system->quality[id] = archetype->quality;
+    system->viscosity[id] = archetype->viscosity;
 
     HexTile *tile = &world->tiles[id];
     tile->terrain = HEX_TERRAIN_FLOWERS;
-    tile->nectar_capacity = system->payloads[payload_index].capacity;
-    tile->nectar_stock = system->payloads[payload_index].stock;
-    tile->nectar_recharge_rate = system->payloads[payload_index].recharge_rate;
-    tile->nectar_recharge_multiplier = system->payloads[payload_index].recharge_multiplier;
-    tile->flower_quality = system->payloads[payload_index].quality;
-    tile->flower_viscosity = system->payloads[payload_index].viscosity;
     tile->patch_id = -1;
     tile->flow_capacity = 18.0f;
-    tile->flower_archetype_id = system->payloads[payload_index].archetype_id;
+    tile->flower_archetype_id = (uint16_t)archetype_id;
+    hex_world_tile_refresh_flags(world, id);
 }
 
 static bool flower_populate_info(void *user_data, const HexWorld *world, TileId id, TileInfo *out_info) {
     (void)world;
     const FlowerSystem *system = (const FlowerSystem *)user_data;
-    if (!system || !out_info) {
-        return false;
-    }
-    const FlowerPayload *payload = flower_payload_for_tile_const(system, id);
-    if (!payload) {
+    if (!out_info || !flower_tile_is_flower(system, id)) {
         return false;
     }
     out_info->terrain = TILE_TERRAIN_FLOWERS;
-    out_info->nectar_capacity = payload->capacity;
-    out_info->nectar_stock = payload->stock;
-    out_info->nectar_recharge_rate = payload->recharge_rate;
-    out_info->nectar_recharge_multiplier = payload->recharge_multiplier;
-    out_info->flower_quality = payload->quality;
-    out_info->flower_viscosity = payload->viscosity;
+    out_info->nectar_capacity = system->capacity[id];
+    out_info->nectar_stock = tile_flower_stock(system, id);
+    out_info->nectar_recharge_rate = system->recharge_rate[id];
+    out_info->nectar_recharge_multiplier = tile_flower_recharge_multiplier(system, id);
+    out_info->flower_quality = system->quality[id];
+    out_info->flower_viscosity = system->viscosity[id];
     out_info->flow_capacity = 18.0f;
     out_info->patch_id = -1;
-    out_info->archetype_id = payload->archetype_id;
+    out_info->archetype_id = system->archetype_id[id];
     return true;
 }
 
 static float flower_harvest(void *user_data, HexWorld *world, TileId id, float request_uL, float *quality_out) {
     FlowerSystem *system = (FlowerSystem *)user_data;
-    if (!system || !world || id >= world->tile_count) {
+    if (!world || id >= world->tile_count || !flower_tile_is_flower(system, id)) {
         return 0.0f;
     }
-    if (request_uL <= 0.0f) {
-        const FlowerPayload *payload_const = flower_payload_for_tile_const(system, id);
-        if (quality_out && payload_const) {
-            *quality_out = payload_const->quality;
-        }
-        return 0.0f;
+    if (quality_out) {
+        *quality_out = system->quality[id];
     }
-    FlowerPayload *payload = flower_payload_for_tile(system, id);
-    if (!payload) {
+    if (request_uL <= 0.0f) {
         return 0.0f;
     }
+    tile_flower_settle(system, world, id);
     float harvest = request_uL;
-    if (harvest > payload->stock) {
-        harvest = payload->stock;
-    }
-    payload->stock -= harvest;
-    HexTile *tile = &world->tiles[id];
-    tile->nectar_stock = payload->stock;
-    if (quality_out) {
-        *quality_out = payload->quality;
+    if (harvest > system->stock[id]) {
+        harvest = system->stock[id];
     }
+    system->stock[id] -= harvest;
+    tile_flower_touch(system, id);
     return harvest;
 }
 
 static bool flower_is_floral(void *user_data, TileId id) {
-    const FlowerSystem *system = (const FlowerSystem *)user_data;
-    if (!system || id >= system->tile_to_payload_capacity) {
-        return false;
-    }
-    uint32_t payload_index = system->tile_to_payload[id];
-    return payload_index != INVALID_PAYLOAD_INDEX && payload_index < system->payload_count;
+    return flower_tile_is_flower((const FlowerSystem *)user_data, id);
 }
 
 static void flower_apply_palette(void *user_data, HexWorld *world, bool nectar_heatmap_enabled) {
@@ -317,16 +308,13 @@ static void flower_apply_palette(void *user_data, HexWorld *world, bool nectar_h
         if (tile_index >= world->tile_count) {
             continue;
         }
-        const FlowerPayload *payload = flower_payload_for_tile_const(system, tile_index);
-        if (!payload) {
-            continue;
-        }
-        uint16_t archetype_id = payload->archetype_id;
+        uint16_t archetype_id = system->archetype_id[tile_index];
         if (archetype_id < FLOWER_ARCHETYPE_COUNT) {
             world->fill_rgba[tile_index] = k_archetypes[archetype_id].color_rgba;
         }
-        if (nectar_heatmap_enabled && payload->capacity > 0.0f) {
-            float ratio = payload->stock / payload->capacity;
+        float capacity = system->capacity[tile_index];
+        if (nectar_heatmap_enabled && capacity > 0.0f) {
+            float ratio = tile_flower_stock(system, tile_index) / capacity;
             if (ratio < 0.0f) ratio = 0.0f;
             if (ratio > 1.0f) ratio = 1.0f;
             float brightness = 0.25f + 0.75f * ratio;
@@ -374,7 +362,7 @@ float tile_flower_harvest(FlowerSystem *system,
 }
 
 void tile_flower_tick(FlowerSystem *system, HexWorld *world, float dt_sec) {
-    if (!system || !world || dt_sec <= 0.0f) {
+    if (!system || !world || system->lazy || dt_sec <= 0.0f) {
         return;
     }
     for (size_t i = 0; i < system->tile_index_count; ++i) {
@@ -382,33 +370,116 @@ void tile_flower_tick(FlowerSystem *system, HexWorld *world, float dt_sec) {
         if (tile_index >= world->tile_count) {
             continue;
         }
-        FlowerPayload *payload = flower_payload_for_tile(system, tile_index);
-        if (!payload) {
+        bool was_available = hex_world_tile_floral_available(world, tile_index);
+        float stock = system->stock[tile_index];
+        stock += system->recharge_rate[tile_index] * system->recharge_multiplier[tile_index] * dt_sec;
+        if (stock > system->capacity[tile_index]) {
+            stock = system->capacity[tile_index];
+        }
+        if (stock < 0.0f) {
+            stock = 0.0f;
+        }
+        system->stock[tile_index] = stock;
+        hex_world_floral_note_update(world, tile_index, was_available);
+    }
+}
+
+// Recharges tiles [begin, end), which lie inside one 64-tile bitset word, and
+// returns the changed bits relative to begin. Bits of tiles whose stock rose
+// through the availability threshold go to *crossed. The SIMD and scalar
+// paths apply the same operations in the same order, so results do not depend
+// on where a block starts.
+static uint64_t flower_recharge_block(FlowerSystem *system,
+                                      size_t begin,
+                                      size_t end,
+                                      float multiplier,
+                                      float dt_sec,
+                                      uint64_t *crossed) {
+    float *stock = system->stock;
+    const float *capacity = system->capacity;
+    const float *rate = system->recharge_rate;
+    float *rate_multiplier = system->recharge_multiplier;
+    uint64_t changed = 0;
+    uint64_t rose = 0;
+    size_t i = begin;
+#if defined(FLOWER_RECHARGE_SSE2)
+    const __m128 v_multiplier = _mm_set1_ps(multiplier);
+    const __m128 v_dt = _mm_set1_ps(dt_sec);
+    const __m128 v_zero = _mm_setzero_ps();
+    const __m128 v_threshold = _mm_set1_ps(HEX_FLORAL_AVAILABLE_UL);
+    for (; i + 4u <= end; i += 4u) {
+        __m128 cap = _mm_loadu_ps(capacity + i);
+        __m128 r = _mm_loadu_ps(rate + i);
+        __m128 s = _mm_loadu_ps(stock + i);
+        __m128 has_capacity = _mm_cmpgt_ps(cap, v_zero);
+        __m128 active = _mm_and_ps(has_capacity, _mm_cmpgt_ps(r, v_zero));
+        __m128 m = _mm_loadu_ps(rate_multiplier + i);
+        _mm_storeu_ps(rate_multiplier + i,
+                      _mm_or_ps(_mm_and_ps(has_capacity, v_multiplier), _mm_andnot_ps(has_capacity, m)));
+        __m128 next = _mm_add_ps(s, _mm_mul_ps(_mm_mul_ps(r, v_multiplier), v_dt));
+        next = _mm_min_ps(cap, next);    // next > cap ? cap : next
+        next = _mm_max_ps(v_zero, next); // next < 0 ? 0 : next
+        next = _mm_or_ps(_mm_and_ps(active, next), _mm_andnot_ps(active, s));
+        _mm_storeu_ps(stock + i, next);
+        unsigned moved = (unsigned)_mm_movemask_ps(_mm_cmpneq_ps(next, s));
+        unsigned up = (unsigned)_mm_movemask_ps(
+            _mm_and_ps(_mm_cmple_ps(s, v_threshold), _mm_cmpgt_ps(next, v_threshold)));
+        changed |= (uint64_t)moved << (i - begin);
+        rose |= (uint64_t)up << (i - begin);
+    }
+#endif
+    for (; i < end; ++i) {
+        if (!(capacity[i] > 0.0f)) {
             continue;
         }
-        float recharge = payload->recharge_rate * payload->recharge_multiplier * dt_sec;
-        payload->stock += recharge;
-        if (payload->stock > payload->capacity) {
-            payload->stock = payload->capacity;
+        rate_multiplier[i] = multiplier;
+        if (!(rate[i] > 0.0f)) {
+            continue;
+        }
+        float previous = stock[i];
+        float next = previous + rate[i] * multiplier * dt_sec;
+        if (next > capacity[i]) {
+            next = capacity[i];
         }
-        if (payload->stock < 0.0f) {
-            payload->stock = 0.0f;
+        if (next < 0.0f) {
+            next = 0.0f;
+        }
+        stock[i] = next;
+        if (next != previous) {
+            changed |= UINT64_C(1) << (i - begin);
+            if (previous <= HEX_FLORAL_AVAILABLE_UL && next > HEX_FLORAL_AVAILABLE_UL) {
+                rose |= UINT64_C(1) << (i - begin);
+            }
+        }
+    }
+    *crossed = rose;
+    return changed;
+}
+
+void tile_flower_recharge(FlowerSystem *system, HexWorld *world, float multiplier, float dt_sec) {
+    if (!system || !world || !system->stock || system->lazy || dt_sec <= 0.0f) {
+        return;
+    }
+    size_t tile_count = system->tile_capacity < world->tile_count ? system->tile_capacity : world->tile_count;
+    for (size_t begin = 0; begin < tile_count; begin += 64u) {
+        size_t end = begin + 64u < tile_count ? begin + 64u : tile_count;
+        uint64_t crossed = 0;
+        system->stock_changed[begin / 64u] = flower_recharge_block(system, begin, end, multiplier, dt_sec, &crossed);
+        // Recharge only adds nectar, so the sole availability transition is
+        // upward; it is rare enough to settle tile by tile.
+        for (size_t bit = 0; crossed != 0; ++bit, crossed >>= 1) {
+            if (crossed & 1u) {
+                hex_world_floral_note_update(world, begin + bit, false);
+            }
         }
-        HexTile *tile = &world->tiles[tile_index];
-        tile->nectar_stock = payload->stock;
-        tile->nectar_recharge_rate = payload->recharge_rate;
-        tile->nectar_recharge_multiplier = payload->recharge_multiplier;
-        tile->flower_quality = payload->quality;
-        tile->flower_viscosity = payload->viscosity;
     }
 }
 
 uint32_t tile_flower_color(const FlowerSystem *system, size_t tile_index, uint32_t fallback_rgba) {
-    const FlowerPayload *payload = flower_payload_for_tile_const(system, tile_index);
-    if (!payload) {
+    if (!flower_tile_is_flower(system, tile_index)) {
         return fallback_rgba;
     }
-    uint16_t archetype_id = payload->archetype_id;
+    uint16_t archetype_id = system->archetype_id[tile_index];
     if (archetype_id < FLOWER_ARCHETYPE_COUNT) {
         return k_archetypes[archetype_id].color_rgba;
     }
@@ -416,11 +487,10 @@ uint32_t tile_flower_color(const FlowerSystem *system, size_t tile_index, uint32
 }
 
 const char *tile_flower_archetype_name(const FlowerSystem *system, size_t tile_index) {
-    const FlowerPayload *payload = flower_payload_for_tile_const(system, tile_index);
-    if (!payload) {
+    if (!flower_tile_is_flower(system, tile_index)) {
         return NULL;
     }
-    uint16_t archetype_id = payload->archetype_id;
+    uint16_t archetype_id = system->archetype_id[tile_index];
     if (archetype_id < FLOWER_ARCHETYPE_COUNT) {
         return k_archetypes[archetype_id].name;
     }
@@ -436,11 +506,7 @@ bool tile_flower_override_payload(FlowerSystem *system,
                                   float recharge_multiplier,
                                   float quality,
                                   float viscosity) {
-    if (!system || !world || tile_index >= world->tile_count) {
-        return false;
-    }
-    FlowerPayload *payload = flower_payload_for_tile(system, tile_index);
-    if (!payload) {
+    if (!world || tile_index >= world->tile_count || !flower_tile_is_flower(system, tile_index)) {
         return false;
     }
     if (capacity < 0.0f) capacity = 0.0f;
@@ -452,20 +518,290 @@ bool tile_flower_override_payload(FlowerSystem *system,
     if (quality > 1.0f) quality = 1.0f;
     if (viscosity <= 0.0f) viscosity = 1.0f;
 
-    payload->capacity = capacity;
-    payload->stock = stock;
-    payload->recharge_rate = recharge_rate >= 0.0f ? recharge_rate : 0.0f;
-    payload->recharge_multiplier = recharge_multiplier;
-    payload->quality = quality;
-    payload->viscosity = viscosity;
+    tile_flower_settle(system, world, tile_index);
+    bool was_available = hex_world_tile_floral_available(world, tile_index);
+    system->capacity[tile_index] = capacity;
+    system->stock[tile_index] = stock;
+    system->recharge_rate[tile_index] = recharge_rate >= 0.0f ? recharge_rate : 0.0f;
+    system->recharge_multiplier[tile_index] = recharge_multiplier;
+    system->quality[tile_index] = quality;
+    system->viscosity[tile_index] = viscosity;
+
+    world->tiles[tile_index].terrain = HEX_TERRAIN_FLOWERS;
+    hex_world_tile_refresh_flags(world, tile_index);
+    tile_flower_touch(system, tile_index);
+    hex_world_floral_note_update(world, tile_index, was_available);
+    return true;
+}
+
+// Integral of the step diurnal multiplier over [0, t]: 1 for the first half
+// of each period (phase <= half, as in the sim's per-tick multiplier) and
+// night_scale for the rest.
+static double flower_diurnal_integral(const FlowerSystem *system, double t) {
+    double period = system->day_period_sec;
+    double day = period * 0.5;
+    double night = system->night_scale;
+    double cycles = floor(t / period);
+    double phase = t - cycles * period;
+    double partial = phase <= day ? phase : day + night * (phase - day);
+    return cycles * (day + night * (period - day)) + partial;
+}
 
-    HexTile *tile = &world->tiles[tile_index];
-    tile->terrain = HEX_TERRAIN_FLOWERS;
-    tile->nectar_capacity = payload->capacity;
-    tile->nectar_stock = payload->stock;
-    tile->nectar_recharge_rate = payload->recharge_rate;
-    tile->nectar_recharge_multiplier = recharge_multiplier;
-    tile->flower_quality = payload->quality;
-    tile->flower_viscosity = payload->viscosity;
+// Earliest time at which the integral reaches the given value.
+static double flower_diurnal_inverse(const FlowerSystem *system, double integral) {
+    double period = system->day_period_sec;
+    double day = period * 0.5;
+    double night = system->night_scale;
+    double per_cycle = day + night * (period - day);
+    double cycles = floor(integral / per_cycle);
+    double rest = integral - cycles * per_cycle;
+    double phase = rest <= day ? rest : day + (rest - day) / night;
+    return cycles * period + phase;
+}
+
+static bool flower_recharges(const FlowerSystem *system, size_t tile_index) {
+    return system->capacity[tile_index] > 0.0f && system->recharge_rate[tile_index] > 0.0f;
+}
+
+static float flower_lazy_stock(const FlowerSystem *system, size_t tile_index) {
+    float stock = system->stock[tile_index];
+    if (!flower_recharges(system, tile_index)) {
+        return stock;
+    }
+    double since = system->clock_integral - flower_diurnal_integral(system, system->stock_time[tile_index]);
+    double value = (double)stock + (double)system->recharge_rate[tile_index] * since;
+    if (value > (double)system->capacity[tile_index]) {
+        value = system->capacity[tile_index];
+    }
+    if (value < 0.0) {
+        value = 0.0;
+    }
+    return (float)value;
+}
+
+// Arms the crossing timer of a tile whose stock (as of stock_time) is at or
+// below the availability threshold but will recharge past it.
+static void flower_lazy_schedule(FlowerSystem *system, size_t tile_index) {
+    float stock = system->stock[tile_index];
+    if (!flower_recharges(system, tile_index) || stock > HEX_FLORAL_AVAILABLE_UL ||
+        system->capacity[tile_index] <= HEX_FLORAL_AVAILABLE_UL) {
+        timer_wheel_cancel(system->crossings, (uint32_t)tile_index);
+        return;
+    }
+    double needed = (double)(HEX_FLORAL_AVAILABLE_UL - stock) / (double)system->recharge_rate[tile_index];
+    double start = flower_diurnal_integral(system, system->stock_time[tile_index]);
+    double due_sec = flower_diurnal_inverse(system, start + needed);
+    uint64_t due = system->step + 1u;
+    if (system->step_sec > 0.0f && due_sec > system->clock_sec) {
+        double steps = ceil((due_sec - system->clock_sec) / (double)system->step_sec);
+        due = steps < (double)TIMER_WHEEL_SPAN ? system->step + (uint64_t)steps : system->step + TIMER_WHEEL_SPAN;
+    }
+    timer_wheel_schedule(system->crossings, (uint32_t)tile_index, due);
+}
+
+typedef struct FlowerCrossingContext {
+    FlowerSystem *system;
+    HexWorld *world;
+} FlowerCrossingContext;
+
+static void flower_crossing_fired(void *user_data, uint32_t id) {
+    FlowerCrossingContext *ctx = (FlowerCrossingContext *)user_data;
+    FlowerSystem *system = ctx->system;
+    if (flower_lazy_stock(system, id) > HEX_FLORAL_AVAILABLE_UL) {
+        hex_world_floral_note_update(ctx->world, id, false);
+    } else {
+        flower_lazy_schedule(system, id);  // rounding or a shorter step; re-check later
+    }
+}
+
+bool tile_flower_set_lazy(FlowerSystem *system,
+                          HexWorld *world,
+                          bool enabled,
+                          float day_period_sec,
+                          float night_scale,
+                          double clock_sec) {
+    if (!system || !world || !system->stock) {
+        return false;
+    }
+    size_t tile_count = system->tile_capacity < world->tile_count ? system->tile_capacity : world->tile_count;
+    if (!enabled) {
+        if (system->lazy) {
+            for (size_t i = 0; i < tile_count; ++i) {
+                tile_flower_settle(system, world, i);
+            }
+            flower_lazy_free(system);
+        }
+        return true;
+    }
+    if (system->lazy) {
+        tile_flower_set_lazy(system, world, false, 0.0f, 0.0f, 0.0);
+    }
+    if (tile_count >= UINT32_MAX) {
+        return false;
+    }
+    system->stock_time = (double *)malloc((tile_count > 0 ? tile_count : 1u) * sizeof(double));
+    if (!system->stock_time || !timer_wheel_create(&system->crossings, tile_count, 0)) {
+        LOG_ERROR("flower: failed to allocate lazy recharge state for %zu tiles", tile_count);
+        flower_lazy_free(system);
+        return false;
+    }
+    system->day_period_sec = day_period_sec > 0.0f ? day_period_sec : 120.0f;
+    system->night_scale = night_scale > 0.0f ? night_scale : 0.25f;
+    system->clock_sec = clock_sec;
+    system->clock_integral = flower_diurnal_integral(system, clock_sec);
+    system->step = 0;
+    system->step_sec = 0.0f;
+    system->lazy = true;
+    for (size_t i = 0; i < tile_count; ++i) {
+        system->stock_time[i] = clock_sec;
+        flower_lazy_schedule(system, i);
+    }
     return true;
 }
+
+void tile_flower_advance(FlowerSystem *system, HexWorld *world, float dt_sec) {
+    if (!system || !world || !system->lazy || dt_sec <= 0.0f) {
+        return;
+    }
+    system->clock_sec += dt_sec;
+    system->clock_integral = flower_diurnal_integral(system, system->clock_sec);
+    system->step_sec = dt_sec;
+    FlowerCrossingContext ctx = {.system = system, .world = world};
+    timer_wheel_advance(system->crossings, ++system->step, flower_crossing_fired, &ctx);
+}
+
+float tile_flower_stock(const FlowerSystem *system, size_t tile_index) {
+    if (!system || !system->stock || tile_index >= system->tile_capacity) {
+        return 0.0f;
+    }
+    return system->lazy ? flower_lazy_stock(system, tile_index) : system->stock[tile_index];
+}
+
+float tile_flower_recharge_multiplier(const FlowerSystem *system, size_t tile_index) {
+    if (!system || !system->stock || tile_index >= system->tile_capacity) {
+        return 1.0f;
+    }
+    if (!system->lazy || system->capacity[tile_index] <= 0.0f) {
+        return system->recharge_multiplier[tile_index];
+    }
+    double period = system->day_period_sec;
+    double phase = system->clock_sec - floor(system->clock_sec / period) * period;
+    return phase <= period * 0.5 ? 1.0f : system->night_scale;
+}
+
+void tile_flower_settle(FlowerSystem *system, HexWorld *world, size_t tile_index) {
+    if (!system || !system->lazy || tile_index >= system->tile_capacity) {
+        return;
+    }
+    system->stock[tile_index] = flower_lazy_stock(system, tile_index);
+    system->stock_time[tile_index] = system->clock_sec;
+    if (timer_wheel_scheduled(system->crossings, (uint32_t)tile_index) &&
+        system->stock[tile_index] > HEX_FLORAL_AVAILABLE_UL) {
+        // Crossed since the last write but the timer has not fired yet.
+        timer_wheel_cancel(system->crossings, (uint32_t)tile_index);
+        if (world) {
+            hex_world_floral_note_update(world, tile_index, false);
+        }
+    }
+}
+
+void tile_flower_touch(FlowerSystem *system, size_t tile_index) {
+    if (!system || !system->lazy || tile_index >= system->tile_capacity) {
+        return;
+    }
+    system->stock_time[tile_index] = system->clock_sec;
+    flower_lazy_schedule(system, tile_index);
+}
+
+typedef struct FlowerSnapshotMeta {
+    double clock_sec;
+    double clock_integral;
+    uint64_t step;
+    float day_period_sec;
+    float night_scale;
+    float step_sec;
+    uint32_t lazy;
+} FlowerSnapshotMeta;
+
+bool tile_flower_snapshot_write(const FlowerSystem *system, SnapshotWriter *writer) {
+    if (!system || !writer) {
+        return false;
+    }
+    size_t tiles = system->stock ? system->tile_capacity : 0u;
+    FlowerSnapshotMeta meta = {
+        .clock_sec = system->clock_sec,
+        .clock_integral = system->clock_integral,
+        .step = system->step,
+        .day_period_sec = system->day_period_sec,
+        .night_scale = system->night_scale,
+        .step_sec = system->step_sec,
+        .lazy = system->lazy ? 1u : 0u,
+    };
+    bool ok = snapshot_write(writer, "flower.meta", &meta, sizeof(meta), 1);
+    ok = ok && snapshot_write(writer, "flower.float_columns", system->stock, sizeof(float), tiles * FLOWER_FLOAT_COLUMN_COUNT);
+    ok = ok && snapshot_write(writer, "flower.archetype_id", system->archetype_id, sizeof(uint16_t), tiles);
+    ok = ok && snapshot_write(writer, "flower.is_flower", system->is_flower, sizeof(uint8_t), tiles);
+    ok = ok && snapshot_write(writer, "flower.stock_changed", system->stock_changed, sizeof(uint64_t), (tiles + 63u) / 64u);
+    ok = ok && snapshot_write(writer, "flower.tile_indices", system->tile_indices, sizeof(size_t), system->tile_index_count);
+    if (ok && system->lazy) {
+        size_t lazy_tiles = timer_wheel_capacity(system->crossings);
+        uint64_t *due = (uint64_t *)malloc((lazy_tiles > 0 ? lazy_tiles : 1u) * sizeof(uint64_t));
+        if (!due) {
+            LOG_ERROR("flower: failed to allocate checkpoint buffer for %zu tiles", lazy_tiles);
+            return false;
+        }
+        for (size_t i = 0; i < lazy_tiles; ++i) {
+            due[i] = timer_wheel_due(system->crossings, (uint32_t)i);
+        }
+        ok = snapshot_write(writer, "flower.stock_time", system->stock_time, sizeof(double), lazy_tiles);
+        ok = ok && snapshot_write(writer, "flower.crossing_due", due, sizeof(uint64_t), lazy_tiles);
+        free(due);
+    }
+    return ok;
+}
+
+bool tile_flower_snapshot_read(FlowerSystem *system, const SnapshotReader *reader) {
+    if (!system || !reader) {
+        return false;
+    }
+    FlowerSnapshotMeta meta;
+    size_t float_count = 0;
+    size_t index_count = 0;
+    snapshot_column(reader, "flower.float_columns", sizeof(float), &float_count);
+    snapshot_column(reader, "flower.tile_indices", sizeof(size_t), &index_count);
+    size_t tiles = float_count / FLOWER_FLOAT_COLUMN_COUNT;
+    if (!snapshot_read(reader, "flower.meta", &meta, sizeof(meta), 1) || float_count % FLOWER_FLOAT_COLUMN_COUNT != 0 ||
+        index_count > tiles || !tile_flower_system_reset(system, tiles)) {
+        return false;
+    }
+    bool ok = snapshot_read(reader, "flower.float_columns", system->stock, sizeof(float), float_count) &&
+              snapshot_read(reader, "flower.archetype_id", system->archetype_id, sizeof(uint16_t), tiles) &&
+              snapshot_read(reader, "flower.is_flower", system->is_flower, sizeof(uint8_t), tiles) &&
+              snapshot_read(reader, "flower.stock_changed", system->stock_changed, sizeof(uint64_t), (tiles + 63u) / 64u) &&
+              snapshot_read(reader, "flower.tile_indices", system->tile_indices, sizeof(size_t), index_count);
+    system->tile_index_count = index_count;
+    system->clock_sec = meta.clock_sec;
+    system->clock_integral = meta.clock_integral;
+    system->step = meta.step;
+    system->day_period_sec = meta.day_period_sec;
+    system->night_scale = meta.night_scale;
+    system->step_sec = meta.step_sec;
+    if (ok && meta.lazy) {
+        size_t lazy_tiles = 0;
+        const uint64_t *due = (const uint64_t *)snapshot_column(reader, "flower.crossing_due", sizeof(uint64_t), &lazy_tiles);
+        system->stock_time = (double *)malloc((lazy_tiles > 0 ? lazy_tiles : 1u) * sizeof(double));
+        ok = lazy_tiles <= tiles && system->stock_time && timer_wheel_create(&system->crossings, lazy_tiles, meta.step) &&
+             snapshot_read(reader, "flower.stock_time", system->stock_time, sizeof(double), lazy_tiles);
+        for (size_t i = 0; ok && i < lazy_tiles; ++i) {
+            if (due[i] != UINT64_MAX) {
+                timer_wheel_schedule(system->crossings, (uint32_t)i, due[i]);
+            }
+        }
+        system->lazy = ok;
+    }
+    if (!ok) {
+        LOG_ERROR("flower: checkpoint has malformed nectar columns");
+        tile_flower_system_shutdown(system);
+    }
+    return ok;
+}